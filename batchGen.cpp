@@ -0,0 +1,171 @@
+#include "batchGen.h"
+#include "simulation.h"
+#include "worldFile.h"
+#include "threadPool.h"
+#include "hexGrid.h"
+#include "logger.h"
+
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+
+batchGen::batchGen(const imageProps& props, uint64_t timeStep, uint64_t maxTime, const std::string& prefix, uint32_t cntThreads) :
+  m_props(props), m_timeStep(timeStep), m_maxTime(maxTime), m_prefix(prefix), m_cntThreads(cntThreads), m_cntDone(0), m_cntFailed(0)
+{
+
+}
+
+
+batchGen::~batchGen()
+{
+
+}
+
+
+/**********************************************************************************************************************
+ * Function: run
+ *
+ * Abstract: Generates the worlds of the seeds firstSeed to firstSeed + cntSeeds - 1, and returns once they are all
+ *           done.  A seed whose world fails is logged and counted, the others carry on.  Each thread takes the next
+ *           seed when its world is done, so the memory used does not grow with the number of seeds.
+ *
+ * Input   : firstSeed -- [in] first seed of the range
+ *           cntSeeds  -- [in] number of seeds
+ *
+ * Returns : true if the summary could be created, false otherwise (no world is generated then)
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+bool batchGen::run(uint32_t firstSeed, uint32_t cntSeeds)
+{
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  std::string path = m_prefix + "summary.csv";
+
+  m_summary.open(path, std::ios::trunc);
+  if (!m_summary.is_open())
+  {
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::ERR, "batch: cannot create %s", path.c_str());
+    return false;
+  }
+  m_summary << "seed,cells,plates,years,runtime_ms,boundary,plate_areas,plate_boundaries\n";
+  m_summary.flush();
+
+  m_cntDone = 0;
+  m_cntFailed = 0;
+
+  uint32_t cntThreads = (m_cntThreads > 0) ? m_cntThreads : std::max(1u, std::thread::hardware_concurrency());
+
+  CLogger::getInstance()->outMsg(cmdLine, CLogger::level::INFO, "batch: %u seeds from %u, %u at a time", cntSeeds, firstSeed, cntThreads);
+
+  {
+    threadPool pool(cntThreads + 1);                           // this thread only waits, it does not take tasks
+
+    std::atomic<uint64_t> next(0);                             // index of the next seed to generate
+
+    for (uint32_t ndx = 0; ndx < std::min(cntThreads, cntSeeds); ndx++)
+      pool.submit([this, &next, firstSeed, cntSeeds]()
+        {
+          for (uint64_t seed = next++; seed < cntSeeds; seed = next++)
+            generate(firstSeed + (uint32_t)seed);
+        });
+    pool.wait();
+  }
+
+  m_summary.close();
+
+  long long elapsed = (long long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+  CLogger::getInstance()->outMsg(cmdLine, CLogger::level::INFO, "batch: %u worlds written, %u failed, %lld ms, summary in %s", (uint32_t)m_cntDone,
+                                 (uint32_t)m_cntFailed, elapsed, path.c_str());
+  return true;
+}
+
+
+/**********************************************************************************************************************
+ * Function: generate
+ *
+ * Abstract: Generates the world of one seed, on a thread of the pool, writes it and adds its row to the summary.  The
+ *           areas and boundaries are measured on the file just written, which is still in the page cache.
+ *
+ * Input   : seed -- [in] seed of the world
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void batchGen::generate(uint32_t seed)
+{
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  std::string        path = m_prefix + std::to_string(seed) + ".ter";
+  worldState         state;
+  hexGrid            grid;
+  bool               bRet;
+
+  CLogger* pLogger = CLogger::newThreadInstance();             // the simulation below logs here too
+  pLogger->regOutDevice(cmdLine, cmdColorOut);
+  pLogger->setLevel(CLogger::level::WARNING);
+
+  {
+    simulation sim(1, seed);
+
+    sim.newMap(m_props);
+    sim.run(m_props.cntPlates, m_timeStep, m_maxTime);
+    bRet = sim.save(path);                                     // queued behind the run, so waits for it
+  }
+
+  long long elapsed = (long long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+  if (bRet) bRet = worldFile::read(path, &state, &grid);
+  if (!bRet)
+  {
+    pLogger->outMsg(cmdLine, CLogger::level::ERR, "batch: seed %u failed", seed);
+    CLogger::delThreadInstance();
+    m_cntFailed++;
+    return;
+  }
+
+  uint32_t              cntCells = grid.getCount();
+  uint32_t              cntPlates = (uint32_t)state.plates.size();
+  std::vector<uint64_t> area(cntPlates + 1, 0);                 // indexed by plate, 0 = no plate
+  std::vector<uint64_t> boundary(cntPlates + 1, 0);
+  uint64_t              edges = 0;
+
+  grid.buildNeighbors();
+  for (uint32_t id = 0; id < cntCells; id++)
+  {
+    uint16_t plate = grid.getPlate(id);
+
+    if (plate > cntPlates) plate = 0;
+
+    area[plate]++;
+    for (uint8_t dir = 0; dir < cntNeighbors; dir++)
+    {
+      uint32_t nbr = grid.neighbor(id, dir);
+
+      if ((nbr != noNeighbor) && (grid.getPlate(nbr) != grid.getPlate(id)))
+      {
+        boundary[plate]++;
+        edges++;
+      }
+    }
+  }
+
+  std::ostringstream row;
+
+  row << seed << ',' << cntCells << ',' << cntPlates << ',' << state.curTime << ',' << elapsed << ',' << edges / 2 << ',';
+  for (uint32_t ndx = 1; ndx <= cntPlates; ndx++) row << (ndx > 1 ? ";" : "") << area[ndx];
+  row << ',';
+  for (uint32_t ndx = 1; ndx <= cntPlates; ndx++) row << (ndx > 1 ? ";" : "") << boundary[ndx];
+  row << '\n';
+
+  {
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_summary << row.str();
+    m_summary.flush();                                          // a batch cut short keeps the rows of the worlds done
+  }
+
+  CLogger::delThreadInstance();
+  m_cntDone++;
+}
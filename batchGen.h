@@ -0,0 +1,58 @@
+/**********************************************************************************************************************
+ * Class    : batchGen
+ *
+ * Abstract : Generates a world for each seed of a range, with the same image properties and run length, to pick the
+ *            good ones from.  The generations are independent, each has its own simulation (and with it its own grid,
+ *            plates and generator), and they run side by side on a threadPool, one per core.  A simulation of a batch
+ *            runs single threaded, the batch keeps the cores busy instead.
+ *            Each world is written to <prefix><seed>.ter as soon as it is done, and gets a row in <prefix>summary.csv:
+ *               seed, cells, plates, years, runtime in ms, boundary (edges between cells of different plates), then
+ *               per plate, separated by ';', the area (cells) and the boundary length (edges to other plates)
+ *            Rows are written in the order the worlds are done, not in the order of the seeds.
+ *            Each generation logs to a logger of its own thread (see CLogger::newThreadInstance), which only shows
+ *            warnings and errors, so the runs share no logger state and the console is not flooded.
+ *
+ * History  : created Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+
+#ifndef _batchGen_h_
+#define _batchGen_h_
+
+#include <cstdint>
+#include <string>
+#include <fstream>
+#include <mutex>
+#include <atomic>
+
+#include "constants.h"
+
+class batchGen
+{
+public:
+  batchGen(const imageProps& props, uint64_t timeStep, uint64_t maxTime, const std::string& prefix, uint32_t cntThreads = 0);
+  ~batchGen();
+
+  bool     run(uint32_t firstSeed, uint32_t cntSeeds);
+
+  uint32_t getDone() const { return m_cntDone; }
+  uint32_t getFailed() const { return m_cntFailed; }
+
+private:
+  imageProps              m_props;
+  uint64_t                m_timeStep;
+  uint64_t                m_maxTime;
+  std::string             m_prefix;             // of the files written
+  uint32_t                m_cntThreads;         // generations run at the same time, 0 => one per core
+
+  std::ofstream           m_summary;
+  std::mutex              m_lock;               // guards m_summary
+  std::atomic<uint32_t>   m_cntDone;
+  std::atomic<uint32_t>   m_cntFailed;
+
+  void     generate(uint32_t seed);
+
+  batchGen(const batchGen&) = delete;
+  batchGen& operator=(const batchGen&) = delete;
+};
+
+#endif
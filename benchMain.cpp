@@ -0,0 +1,128 @@
+#include "constants.h"
+#include "benchmark.h"
+#include "scaleSweep.h"
+#include "logger.h"
+
+#ifdef __WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include "XGetopt.h"
+#else
+#include <unistd.h>
+#endif
+
+#include <iostream>
+#include <string>
+#include <cstdlib>
+
+void showHelp(const char*);
+
+
+/*
+ * terrainBench -- times the hot paths of the core (see benchmark.h), prints a table and, with -o, writes the results as
+ *                 JSON to compare with the results of another commit.
+ *                 With -s it sweeps the size of the map and the number of plates instead (see scaleSweep.h), prints a
+ *                 table and writes the results as CSV.
+ */
+int main(int argc, char** argv)
+{
+	int         choice = -1;
+	int         ret = 0;
+	uint32_t    runs = 5;
+	double      minSeconds = 0.2;
+	uint32_t    cntThreads = 0;
+	bool        bQuick = false;
+	uint64_t    maxCells = 10000000;                        // sweep, see scaleSweep
+	uint32_t    maxPlates = 256;
+	std::string outFile;
+	std::string sweepFile;
+
+	while (-1 != (choice = getopt(argc, argv, "hqo:r:m:j:s:c:n:")))
+	{
+		switch (choice)
+		{
+		case 'o':
+			outFile = optarg;
+			break;
+
+		case 'r':
+			runs = (uint32_t)strtoul(optarg, nullptr, 10);
+			break;
+
+		case 'm':
+			minSeconds = atof(optarg) / 1000.0;
+			break;
+
+		case 'j':
+			cntThreads = (uint32_t)strtoul(optarg, nullptr, 10);
+			break;
+
+		case 'q':
+			bQuick = true;
+			break;
+
+		case 's':
+			sweepFile = optarg;
+			break;
+
+		case 'c':
+			maxCells = strtoull(optarg, nullptr, 10);
+			break;
+
+		case 'n':
+			maxPlates = (uint32_t)strtoul(optarg, nullptr, 10);
+			break;
+
+		case '?':                                            // getopt has named the option already, optarg is not set
+			showHelp(argv[0]);
+			return (1);
+
+		case 'h':
+			showHelp(argv[0]);
+			return (0);
+		}
+	}
+
+	CLogger* pLogger = CLogger::getInstance();
+	pLogger->regOutDevice(cmdLine, cmdColorOut);
+	pLogger->setLevel(CLogger::level::WARNING);                 // the kernels log each stage, that is not what is timed
+
+	if (!sweepFile.empty())
+	{
+		scaleSweep sweep(maxCells, maxPlates, cntThreads);
+
+		sweep.run();
+		sweep.print();
+
+		ret = sweep.writeCsv(sweepFile) ? 0 : 1;
+
+		pLogger->delInstance();
+		return ret;
+	}
+
+	benchmark bench(runs, minSeconds, cntThreads);
+
+	bench.runAll(bQuick);
+	bench.print();
+
+	if (!outFile.empty() && !bench.writeJson(outFile)) ret = 1;
+
+	pLogger->delInstance();
+	return ret;
+}
+
+
+void showHelp(const char* name)
+{
+	std::cout << name << " times the hot paths of the terrain generator." << std::endl;
+	std::cout << "Usage: " << name << " [options]  \nThe options are:" << std::endl;
+	std::cout << "h             displays a short usage screen (this screen) and then exits" << std::endl;
+	std::cout << "o <file>      writes the results as JSON to <file>" << std::endl;
+	std::cout << "q             quick, leaves out the largest map" << std::endl;
+	std::cout << "r <runs>      timed runs of each case, the median is reported (5)" << std::endl;
+	std::cout << "m <ms>        minimum time of a run (200)" << std::endl;
+	std::cout << "j <threads>   threads of the plate kernels, 0 or 1 for none (0)" << std::endl;
+	std::cout << "s <file>      sweeps 1K to 10M cells and 4 to 256 plates instead, writes the results as CSV to <file>" << std::endl;
+	std::cout << "c <cells>     with s, the largest number of cells (10000000)" << std::endl;
+	std::cout << "n <plates>    with s, the largest number of plates (256)" << std::endl;
+}
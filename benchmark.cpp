@@ -0,0 +1,634 @@
+#include "benchmark.h"
+#include "hexGrid.h"
+#include "plateGrowth.h"
+#include "plateMotion.h"
+#include "threadPool.h"
+#include "evDist.h"
+#include "utility.h"
+#include "logger.h"
+
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <thread>
+#include <ctime>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+static const uint32_t cntPoints = 4096;                        // points the geometry cases cycle through
+static const uint64_t cntGeomOps = 65536;                      // operations per call of a geometry case
+static const uint64_t motionYears = 10000000;                  // long enough for every plate to move a cell or more
+static const double_t mapSpan = 4.0075E9;                      // cm, as in simulation.cpp
+
+static volatile uint64_t s_sink = 0;                           // results land here so the compiler keeps the work
+
+
+static void nullOut(int, char* msg)
+{
+  s_sink = s_sink + (uint8_t)msg[0];
+}
+
+
+static const char* orientName(uint8_t orient)
+{
+  return (orient == hexGrid::orien::HORIZONTAL) ? "horizontal" : "vertical";
+}
+
+
+benchmark::benchmark(uint32_t runs, double minSeconds, uint32_t cntThreads) : m_runs(std::max(1u, runs)), m_minSeconds(minSeconds), m_pool(nullptr)
+{
+  if (cntThreads > 1) m_pool = new threadPool(cntThreads);
+}
+
+
+benchmark::~benchmark()
+{
+  delete m_pool;
+}
+
+
+/**********************************************************************************************************************
+ * Function: runAll
+ *
+ * Abstract: Runs every case.  The quick set leaves out the largest map, for a check that takes seconds rather than
+ *           minutes; its results are a subset of the full set, under the same names and parameters.
+ *
+ * Input   : bQuick -- [in] run the quick set
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void benchmark::runAll(bool bQuick)
+{
+  static const double sizes[3][3] = { { 1024, 768, 18 }, { 4096, 3072, 9 }, { 8192, 8192, 4 } };   // ~1K, ~60K, ~1.6M cells
+  static const uint8_t orients[2] = { hexGrid::orien::VERTICAL, hexGrid::orien::HORIZONTAL };
+
+  for (uint8_t orient : orients)
+  {
+    for (int ndx = 0; ndx < (bQuick ? 2 : 3); ndx++)
+      benchGrid(orient, sizes[ndx][0], sizes[ndx][1], sizes[ndx][2]);
+    benchGeometry(orient);
+  }
+
+  benchPlates(hexGrid::orien::VERTICAL, sizes[1][0], sizes[1][1], sizes[1][2], 16);
+  if (!bQuick) benchPlates(hexGrid::orien::VERTICAL, sizes[2][0], sizes[2][1], sizes[2][2], 64);
+
+  benchGev();
+  benchLogger();
+}
+
+
+/**********************************************************************************************************************
+ * Function: benchGrid
+ *
+ * Abstract: Times building a grid for a map (genGrid), and building its neighbor table, which the grid leaves until
+ *           the plates need it.  Building includes allocating the cell arrays (the grid frees them first), so on large
+ *           maps the time depends on the allocator as well, e.g. on whether it maps fresh pages.
+ *
+ * Input   : orient -- [in] orientation of the hexagons
+ *           width  -- [in] size of the map
+ *           height
+ *           size   -- [in] size of a hexagon
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void benchmark::benchGrid(uint8_t orient, double width, double height, double size)
+{
+  uint32_t rows;
+  uint32_t cols;
+  hexGrid  grid;
+
+  if (!hexGrid::dimensions(orient, size, width, height, &rows, &cols)) return;
+
+  std::ostringstream params;
+  params << "\"orient\": \"" << orientName(orient) << "\", \"width\": " << width << ", \"height\": " << height << ", \"size\": " << size
+         << ", \"cells\": " << (uint64_t)rows * cols;
+
+  measure("genGrid", params.str(), (double)rows * cols, nullptr, [&]()
+    {
+      grid.build(orient, size, rows, cols);
+      s_sink = s_sink + grid.getCount();
+      return 1;
+    });
+
+  measure("neighbors", params.str(), (double)rows * cols, [&]() { grid.build(orient, size, rows, cols); }, [&grid]()
+    {
+      grid.buildNeighbors();
+      s_sink = s_sink + grid.neighbor(0, 0);
+      return 1;
+    });
+}
+
+
+/**********************************************************************************************************************
+ * Function: benchGeometry
+ *
+ * Abstract: Times the point tests: hexGrid::contains for points scattered over the bounding square of a hexagon (so
+ *           every branch of the test is taken), hexGrid::cellAt for points scattered over the map, and orient.
+ *
+ * Input   : orient -- [in] orientation of the hexagons
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void benchmark::benchGeometry(uint8_t orient)
+{
+  const double                     size = 18;
+  uint32_t                         rows;
+  uint32_t                         cols;
+  double                           width;
+  double                           height;
+  hexGrid                          grid;
+  std::mt19937                     gen(1);
+  std::uniform_real_distribution<> dist(-1.0, 1.0);
+  std::vector<pointF>              near(cntPoints);
+  std::vector<pointF>              anywhere(cntPoints);
+
+  hexGrid::dimensions(orient, size, 1024, 768, &rows, &cols);
+  grid.build(orient, size, rows, cols);
+  grid.extent(&width, &height);
+
+  uint32_t id = (rows / 2) * cols + cols / 2;
+  pointF   center = grid.getCenter(id);
+
+  for (uint32_t ndx = 0; ndx < cntPoints; ndx++)
+  {
+    near[ndx] = pointF(center.x() + size * dist(gen), center.y() + size * dist(gen));
+    anywhere[ndx] = pointF(width * (0.5 + 0.5 * dist(gen)), height * (0.5 + 0.5 * dist(gen)));
+  }
+
+  std::string params = std::string("\"orient\": \"") + orientName(orient) + "\"";
+
+  measure("contains", params, 0, nullptr, [&]()
+    {
+      uint64_t cnt = 0;
+      for (uint64_t ndx = 0; ndx < cntGeomOps; ndx++)
+        cnt += grid.contains(id, near[ndx % cntPoints]) ? 1 : 0;
+      s_sink = s_sink + cnt;
+      return cntGeomOps;
+    });
+
+  measure("cellAt", params, 0, nullptr, [&]()
+    {
+      uint64_t cnt = 0;
+      for (uint64_t ndx = 0; ndx < cntGeomOps; ndx++)
+        cnt += grid.cellAt(anywhere[ndx % cntPoints]);
+      s_sink = s_sink + cnt;
+      return cntGeomOps;
+    });
+
+  if (orient != hexGrid::orien::VERTICAL) return;            // orient does not depend on the grid, time it once
+
+  measure("orient", "", 0, nullptr, [&]()
+    {
+      uint64_t cnt = 0;
+      for (uint64_t ndx = 0; ndx < cntGeomOps; ndx++)
+        cnt += ::orient(near[ndx % cntPoints], near[(ndx + 1) % cntPoints], anywhere[ndx % cntPoints]);
+      s_sink = s_sink + cnt;
+      return cntGeomOps;
+    });
+}
+
+
+/**********************************************************************************************************************
+ * Function: benchPlates
+ *
+ * Abstract: Times the plate kernels on a map: one growth step taken when half the map is claimed (the step is taken
+ *           from a copy of the half grown map each time), the whole growth from the centers, and one time step of
+ *           the plate motion of the covered map (taken from a copy of the covered map each time).
+ *
+ * Input   : orient    -- [in] orientation of the hexagons
+ *           width     -- [in] size of the map
+ *           height
+ *           size      -- [in] size of a hexagon
+ *           cntPlates -- [in] number of plates
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void benchmark::benchPlates(uint8_t orient, double width, double height, double size, uint32_t cntPlates)
+{
+  uint32_t               rows;
+  uint32_t               cols;
+  hexGrid                grid;
+  std::vector<platesT>   plates;
+  std::vector<platesT>   savedPlates;
+  std::vector<uint16_t>  savedPlate;
+  std::vector<uint8_t>   savedStyle;
+  std::vector<float>     savedElevation;
+
+  if (!hexGrid::dimensions(orient, size, width, height, &rows, &cols)) return;
+  grid.build(orient, size, rows, cols);
+  grid.buildNeighbors();
+
+  uint32_t cntCells = grid.getCount();
+
+  std::ostringstream params;
+  params << "\"orient\": \"" << orientName(orient) << "\", \"cells\": " << cntCells << ", \"plates\": " << cntPlates << ", \"threads\": "
+         << (m_pool ? m_pool->getCount() : 1);
+
+  auto save = [&]()
+  {
+    savedPlates = plates;
+    savedPlate.assign(grid.plates(), grid.plates() + cntCells);
+    savedStyle.assign(grid.styles(), grid.styles() + cntCells);
+    savedElevation.assign(grid.elevations(), grid.elevations() + cntCells);
+  };
+  auto restore = [&]()
+  {
+    plates = savedPlates;
+    std::copy(savedPlate.begin(), savedPlate.end(), grid.plates());
+    std::copy(savedStyle.begin(), savedStyle.end(), grid.styles());
+    std::copy(savedElevation.begin(), savedElevation.end(), grid.elevations());
+  };
+
+  // the map half grown, for the growth step
+  placeCenters(&grid, &plates, cntPlates, 1);
+  {
+    plateGrowth growth(&grid, plates.data(), cntPlates, m_pool);
+    while ((growth.getClaimed() < cntCells / 2) && growth.step())
+      ;
+  }
+  save();
+
+  std::unique_ptr<plateGrowth> growth;
+  uint64_t                     claimed = 0;
+
+  measure("growthStep", params.str(), 0, [&]()
+    {
+      restore();
+      growth.reset(new plateGrowth(&grid, plates.data(), cntPlates, m_pool));
+    }, [&]()
+    {
+      growth->step();
+      claimed = growth->getChanged().size();
+      return 1;
+    });
+  if (!m_results.empty()) m_results.back().cellsPerOp = (double)claimed;
+
+  // the whole growth, from the centers
+  grid.resetCells();
+  plates.clear();
+  placeCenters(&grid, &plates, cntPlates, 1);
+  save();
+
+  measure("growth", params.str(), (double)cntCells, [&]()
+    {
+      restore();
+      growth.reset(new plateGrowth(&grid, plates.data(), cntPlates, m_pool));
+    }, [&]()
+    {
+      growth->run();
+      s_sink = s_sink + growth->getStep();
+      return 1;
+    });
+  growth.reset();
+  save();                                                      // the map as the growth left it
+
+  // a time step of the covered map
+  std::vector<double_t>        speed;
+  std::vector<double_t>        direction;
+  std::unique_ptr<plateMotion> motion;
+
+  genMotion(cntPlates, 1, &speed, &direction);
+
+  measure("motionStep", params.str() + ", \"years\": " + std::to_string(motionYears), (double)cntCells, [&]()
+    {
+      restore();
+      motion.reset(new plateMotion(&grid, plates.data(), cntPlates, speed.data(), direction.data(), mapSpan / width, m_pool));
+    }, [&]()
+    {
+      motion->step(motionYears);
+      s_sink = s_sink + motion->getMoved();
+      return 1;
+    });
+}
+
+
+/**********************************************************************************************************************
+ * Function: benchGev
+ *
+ * Abstract: Times drawing from the extreme value distribution, with the parameters of evDist.h.  getNumber logs each
+ *           number at DEBUG, so this is timed with a logger of the thread that drops DEBUG, as a run at the default
+ *           threshold would.
+ *
+ * Input   : void
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void benchmark::benchGev()
+{
+  CGEVDist dist(12.9183f, 2.37793f, -1.0f);
+  CLogger* pLogger = CLogger::newThreadInstance();
+
+  pLogger->regOutDevice(cmdLine, nullOut);
+  pLogger->setLevel(CLogger::level::WARNING);
+
+  measure("gevNumber", "", 0, nullptr, [&dist]()
+    {
+      double sum = 0;
+      for (uint64_t ndx = 0; ndx < cntGeomOps; ndx++)
+        sum += dist.getNumber();
+      s_sink = s_sink + (uint64_t)sum;
+      return cntGeomOps;
+    });
+
+  CLogger::delThreadInstance();
+}
+
+
+/**********************************************************************************************************************
+ * Function: benchLogger
+ *
+ * Abstract: Times CLogger::outMsg, for a message that is formatted and handed to an output function (which drops it,
+ *           so the console is not timed), and for a message below the threshold.
+ *
+ * Input   : void
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void benchmark::benchLogger()
+{
+  CLogger* pLogger = CLogger::newThreadInstance();
+
+  pLogger->regOutDevice(cmdLine, nullOut);
+
+  auto body = [pLogger]()
+  {
+    for (uint64_t ndx = 0; ndx < cntGeomOps; ndx++)
+      pLogger->outMsg(cmdLine, CLogger::level::INFO, "plate %d: center is at (%.4f, %.4f)", (int)ndx, 0.25 * ndx, 0.5 * ndx);
+    return cntGeomOps;
+  };
+
+  pLogger->setLevel(CLogger::level::INFO);
+  measure("logMsg", "", 0, nullptr, body);
+
+  pLogger->setLevel(CLogger::level::WARNING);
+  measure("logFiltered", "", 0, nullptr, body);
+
+  CLogger::delThreadInstance();
+}
+
+
+/**********************************************************************************************************************
+ * Function: measure
+ *
+ * Abstract: Times a case.  A run calls 'setup' (untimed) and 'body' (timed) in turn until the body has taken
+ *           m_minSeconds, or the run has taken ten times as long (for cases whose setup is far slower than the body).
+ *           The first run only warms up.
+ *
+ * Input   : name       -- [in] name of the case
+ *           params     -- [in] parameters of the case, as JSON members
+ *           cellsPerOp -- [in] cells an operation works on, 0 if none
+ *           setup      -- [in] prepares a call of body, may be empty
+ *           body       -- [in] the work timed, returns the number of operations it did
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void benchmark::measure(const std::string& name, const std::string& params, double cellsPerOp, const std::function<void()>& setup,
+                        const std::function<uint64_t()>& body)
+{
+  typedef std::chrono::steady_clock clock;
+
+  std::vector<double> nsPerOp;
+  uint64_t            ops = 0;
+
+  for (uint32_t run = 0; run <= m_runs; run++)
+  {
+    double          timed = 0;
+    uint64_t        runOps = 0;
+    clock::time_point start = clock::now();
+
+    do
+    {
+      if (setup) setup();
+
+      clock::time_point t0 = clock::now();
+      runOps += body();
+      timed += std::chrono::duration<double>(clock::now() - t0).count();
+    } while ((timed < m_minSeconds) && (std::chrono::duration<double>(clock::now() - start).count() < 10 * m_minSeconds));
+
+    if (run == 0) continue;                                    // warm up
+
+    nsPerOp.push_back(1E9 * timed / runOps);
+    ops += runOps;
+  }
+
+  std::sort(nsPerOp.begin(), nsPerOp.end());
+
+  resultT result;
+  result.name = name;
+  result.params = params;
+  result.runs = m_runs;
+  result.ops = ops;
+  result.nsPerOp = nsPerOp[nsPerOp.size() / 2];
+  result.nsPerOpMin = nsPerOp[0];
+  result.cellsPerOp = cellsPerOp;
+  m_results.push_back(result);
+
+  CLogger::getInstance()->outMsg(cmdLine, CLogger::level::INFO, "bench: %-12s %s: %.1f ns/op", name.c_str(), params.c_str(), result.nsPerOp);
+}
+
+
+/**********************************************************************************************************************
+ * Function: print
+ *
+ * Abstract: Prints the results as a table on the console.
+ *
+ * Input   : void
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void benchmark::print() const
+{
+  printf("%-12s %14s %14s %14s  %s\n", "case", "ns/op", "ops/s", "cells/s", "parameters");
+  for (const resultT& result : m_results)
+  {
+    char cells[32] = "-";
+
+    if (result.cellsPerOp > 0) snprintf(cells, sizeof(cells), "%.4g", 1E9 * result.cellsPerOp / result.nsPerOp);
+    printf("%-12s %14.1f %14.4g %14s  %s\n", result.name.c_str(), result.nsPerOp, 1E9 / result.nsPerOp, cells, result.params.c_str());
+  }
+}
+
+
+/**********************************************************************************************************************
+ * Function: writeJson
+ *
+ * Abstract: Writes the results as a JSON document:
+ *              { "version": ..., "compiler": ..., "build": ..., "threads": ..., "date": ...,
+ *                "results": [ { "name": ..., "params": { ... }, "runs": ..., "ops": ..., "ns_per_op": ...,
+ *                               "ns_per_op_min": ..., "ops_per_s": ..., "cells_per_s": ... }, ... ] }
+ *           'cells_per_s' is null for the cases that do not work on cells.  A case is identified by its name and
+ *           params, which do not change between commits.
+ *
+ * Input   : path -- [in] name of the file
+ *
+ * Returns : true if the file was written, false otherwise
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+bool benchmark::writeJson(const std::string& path) const
+{
+  std::ofstream out(path, std::ios::trunc);
+
+  if (!out.is_open())
+  {
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::ERR, "bench: cannot create %s", path.c_str());
+    return false;
+  }
+
+  char       date[32];
+  std::time_t now = std::time(nullptr);
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+#if defined(_MSC_VER)
+  std::string compiler = "msvc " + std::to_string(_MSC_FULL_VER);
+#elif defined(__clang__)
+  std::string compiler = std::string("clang ") + __clang_version__;
+#elif defined(__GNUC__)
+  std::string compiler = std::string("gcc ") + __VERSION__;
+#else
+  std::string compiler = "unknown";
+#endif
+
+#ifdef NDEBUG
+  const char* build = "release";
+#else
+  const char* build = "debug";
+#endif
+
+  char num[64];
+  auto fmt = [&num](double value) { snprintf(num, sizeof(num), "%.6g", value); return std::string(num); };
+
+  out << "{\n";
+  out << "  \"version\": \"" << (int)MAJOR << "." << (int)MINOR << "." << (int)PATCH << "\",\n";
+  out << "  \"compiler\": \"" << compiler << "\",\n";
+  out << "  \"build\": \"" << build << "\",\n";
+  out << "  \"threads\": " << std::thread::hardware_concurrency() << ",\n";
+  out << "  \"date\": \"" << date << "\",\n";
+  out << "  \"results\": [\n";
+
+  for (size_t ndx = 0; ndx < m_results.size(); ndx++)
+  {
+    const resultT& result = m_results[ndx];
+
+    out << "    { \"name\": \"" << result.name << "\", \"params\": { " << result.params << " }, \"runs\": " << result.runs << ", \"ops\": "
+        << result.ops << ", \"ns_per_op\": " << fmt(result.nsPerOp) << ", \"ns_per_op_min\": " << fmt(result.nsPerOpMin)
+        << ", \"ops_per_s\": " << fmt(1E9 / result.nsPerOp) << ", \"cells_per_s\": "
+        << ((result.cellsPerOp > 0) ? fmt(1E9 * result.cellsPerOp / result.nsPerOp) : std::string("null")) << " }"
+        << ((ndx + 1 < m_results.size()) ? "," : "") << "\n";
+  }
+
+  out << "  ]\n}\n";
+  out.close();
+
+  if (out.fail())
+  {
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::ERR, "bench: failed writing %s", path.c_str());
+    return false;
+  }
+  return true;
+}
+
+
+/**********************************************************************************************************************
+ * Function: placeCenters
+ *
+ * Abstract: Places the plate centers as simulation::doPlaceCenters does, at least a cell from the edge of the map, and
+ *           claims the cell of each center for its plate.  The grid must be new.
+ *
+ * Input   : grid      -- [in/out] the grid
+ *           plates    -- [out] the plates
+ *           cntPlates -- [in] number of plates
+ *           seed      -- [in] seed of the generator
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void benchmark::placeCenters(hexGrid* grid, std::vector<platesT>* plates, uint32_t cntPlates, uint32_t seed)
+{
+  std::mt19937                     gen(seed);
+  std::uniform_real_distribution<> dist(0.0, 1.0);
+  double                           width;
+  double                           height;
+  double_t                         margin = (grid->getOrient() == hexGrid::orien::HORIZONTAL) ? grid->getSize() * (1 + 2 * sin30)
+                                                                                                : 2 * grid->getSize() * cos30;
+
+  grid->extent(&width, &height);
+  plates->assign(cntPlates, platesT());
+
+  for (uint32_t ndx = 0; ndx < cntPlates; ndx++)
+  {
+    double_t x;
+    double_t y;
+
+    do
+    {
+      x = width * dist(gen);
+      y = height * dist(gen);
+    } while ((x < margin) || ((width - x) < margin) || (y < margin) || ((height - y) < margin));
+
+    (*plates)[ndx].ndx = ndx + 1;
+    (*plates)[ndx].center_x = x;
+    (*plates)[ndx].center_y = y;
+    (*plates)[ndx].color = plateColor(ndx);
+
+    uint32_t cellID = grid->cellAt(pointF(x, y));
+    if ((cellID != noCell) && (grid->getPlate(cellID) == 0))   // two centers in one cell, the second plate stays empty
+    {
+      grid->setPlate(cellID, (uint16_t)(ndx + 1));
+      grid->setStyle(cellID, bFilled | bColor | bDispCenter);
+      (*plates)[ndx].vec.push_back(cellID);
+    }
+  }
+}
+
+
+/**********************************************************************************************************************
+ * Function: genMotion
+ *
+ * Abstract: Draws the speed and direction of each plate as simulation::doGenMotion does.
+ *
+ * Input   : cntPlates -- [in] number of plates
+ *           seed      -- [in] seed of the generator
+ *           speed     -- [out] speed of each plate, cm a year
+ *           direction -- [out] direction of each plate, degrees
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void benchmark::genMotion(uint32_t cntPlates, uint32_t seed, std::vector<double_t>* speed, std::vector<double_t>* direction)
+{
+  std::mt19937                             gen(seed);
+  std::normal_distribution<double_t>       norDist(4.5, 2.0);
+  std::uniform_real_distribution<double_t> dirDist(0.0, 360.0);
+
+  speed->resize(cntPlates);
+  direction->resize(cntPlates);
+
+  for (uint32_t ndx = 0; ndx < cntPlates; ndx++)
+  {
+    double_t plateSpeed = norDist(gen);
+    if (plateSpeed < 0) plateSpeed = 2.0;
+
+    (*speed)[ndx] = plateSpeed;
+    (*direction)[ndx] = dirDist(gen);
+  }
+}
@@ -0,0 +1,86 @@
+/**********************************************************************************************************************
+ * Class    : benchmark
+ *
+ * Abstract : Times the hot paths of the core, so that the effect of a change on them can be measured:
+ *               genGrid     -- hexGrid::build (the lattice and the cell arrays) for several map sizes, both orientations
+ *               neighbors   -- hexGrid::buildNeighbors
+ *               contains    -- hexGrid::contains, for points in and around a hexagon
+ *               cellAt      -- hexGrid::cellAt, for points all over the map
+ *               orient      -- orient (utility.h)
+ *               growthStep  -- one plateGrowth::step, taken when half the map is claimed
+ *               growth      -- plateGrowth::run, from the centers until the map is covered
+ *               motionStep  -- one plateMotion::step of the covered map
+ *               gevNumber   -- CGEVDist::getNumber
+ *               logMsg      -- CLogger::outMsg of a formatted message, to an output function that drops it
+ *               logFiltered -- CLogger::outMsg of a message below the threshold
+ *            Everything random is drawn from generators with fixed seeds, so every run times the same work.  A case is
+ *            run 'runs' times (once more first, untimed, to warm the caches), each run repeating the operation until
+ *            it has taken a minimum time; the median of the runs is reported, with the fastest run.  Work that only
+ *            prepares an operation (e.g. growing the plates a step is taken from) is not timed.
+ *            Each result gives the time per operation in ns and the operations per second, and for the cases that
+ *            work on whole maps the cells per second.  'writeJson' writes them, with the compiler and the machine,
+ *            as a JSON document that can be compared with the one of another commit.
+ *            The cases run on the calling thread; the plate kernels get a threadPool only if asked for.
+ *
+ * History  : created Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+
+#ifndef _benchmark_h_
+#define _benchmark_h_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <functional>
+
+#include "constants.h"
+
+class hexGrid;
+class threadPool;
+
+class benchmark
+{
+public:
+  typedef struct result
+  {
+    std::string  name;
+    std::string  params;                   // JSON members describing the case, e.g. "\"cells\": 1000"
+    uint32_t     runs;
+    uint64_t     ops;                      // operations per run
+    double       nsPerOp;                  // median of the runs
+    double       nsPerOpMin;               // fastest run
+    double       cellsPerOp;               // cells an operation works on, 0 if it does not work on cells
+  } resultT;
+
+  benchmark(uint32_t runs = 5, double minSeconds = 0.2, uint32_t cntThreads = 0);
+  ~benchmark();
+
+  void     runAll(bool bQuick = false);
+
+  void     benchGrid(uint8_t orient, double width, double height, double size);
+  void     benchGeometry(uint8_t orient);
+  void     benchPlates(uint8_t orient, double width, double height, double size, uint32_t cntPlates);
+  void     benchGev();
+  void     benchLogger();
+
+  const std::vector<resultT>& getResults() const { return m_results; }
+  void     print() const;
+  bool     writeJson(const std::string& path) const;
+
+  static void     placeCenters(hexGrid* grid, std::vector<platesT>* plates, uint32_t cntPlates, uint32_t seed);
+  static void     genMotion(uint32_t cntPlates, uint32_t seed, std::vector<double_t>* speed, std::vector<double_t>* direction);
+
+private:
+  uint32_t              m_runs;
+  double                m_minSeconds;          // a run repeats the operation for at least this long
+  threadPool*           m_pool;                // for the plate kernels, nullptr => serial
+  std::vector<resultT>  m_results;
+
+  void     measure(const std::string& name, const std::string& params, double cellsPerOp, const std::function<void()>& setup,
+                   const std::function<uint64_t()>& body);
+
+  benchmark(const benchmark&) = delete;
+  benchmark& operator=(const benchmark&) = delete;
+};
+
+#endif
@@ -2,7 +2,8 @@
 #define _constants_h_
 
 #include <cstdint>
-#include <QColor>
+#include <cmath>
+#include <vector>
 
 static const uint8_t MAJOR = 1;
 static const uint8_t MINOR = 0;
@@ -25,6 +26,12 @@ static const uint8_t mapLayers = 6;
 
 static char* layerName[mapLayers] = {(char*)"grid        ", (char*)"plates      ", (char*)"rivers/lakes", (char*)"coasts      ", (char*)"map border  ",
                                      (char*)"labels      "};
+static const uint8_t layerGrid = 0;      // index of each layer in layerName
+static const uint8_t layerPlates = 1;
+static const uint8_t layerRivers = 2;
+static const uint8_t layerCoasts = 3;
+static const uint8_t layerBorder = 4;
+static const uint8_t layerLabels = 5;
 
 
 
@@ -49,17 +56,37 @@ struct imageProps
 	float          frequency[nbrHarmonics];
 };
 
-//                                     brass,              brown,            burnt sienna,     camel,                chocolate,         dark brown, 
-static const QColor plateColors[12] = { QColor(225,193,110),QColor(165,42,42),QColor(233,116,81),QColor(193,154,107), QColor(123, 63,0), QColor(92,64,51),
-//                                     fawn,               khaki,              maroon,         nude,                olive green,      Tuscan Red
-																		    QColor(229,170,112),QColor(240,230,140),QColor(128,0,0),QColor(242,210,189), QColor(128,128,0),QColor(124,48,48) };
+// colors are 0xAARRGGBB, the layout of a QRgb, so the GUI turns them into a QColor with QColor::fromRgba
+//                                      brass,      brown,      burnt sienna, camel,      chocolate,  dark brown,
+static const uint32_t plateColors[12] = { 0xFFE1C16E, 0xFFA52A2A, 0xFFE97451,   0xFFC19A6B, 0xFF7B3F00, 0xFF5C4033,
+//                                      fawn,       khaki,      maroon,       nude,       olive green, Tuscan Red
+                                          0xFFE5AA70, 0xFFF0E68C, 0xFF800000,   0xFFF2D2BD, 0xFF808000,  0xFF7C3030 };
+static const uint32_t cntPlateColors = sizeof(plateColors) / sizeof(plateColors[0]);
+
+// default color of the plate at index ndx (platesT::ndx - 1), the colors repeat after the last one
+inline uint32_t plateColor(uint32_t ndx) { return plateColors[ndx % cntPlateColors]; }
+
+// a point in scene coordinates, with the accessors of a QPointF, so the core does not depend on Qt
+class pointF
+{
+public:
+	pointF() : m_x(0), m_y(0) {}
+	pointF(double_t x, double_t y) : m_x(x), m_y(y) {}
+
+	double_t x() const { return m_x; }
+	double_t y() const { return m_y; }
+
+private:
+	double_t m_x;
+	double_t m_y;
+};
 
 typedef struct plates
 {
 	uint32_t ndx;
 	double_t center_x;
 	double_t center_y;
-	QColor   color;
+	uint32_t color;                        // 0xAARRGGBB
 
 	std::vector<uint32_t> vec;             // index of hexagons on boundary
 } platesT, * pPlatesT;
@@ -1,6 +1,6 @@
 #include "evDist.h"
 
-#include "qDebug"
+#include "logger.h"
 
 CGEVDist::CGEVDist() { }
 
@@ -24,7 +24,7 @@ float CGEVDist::getNumber()
   std::uniform_real_distribution<double> distribution(0,1);
   double number = distribution(m_generator);
   
-  qDebug() << "seed number is: " << number;
+  CLogger::getInstance()->outMsg(cmdLine, CLogger::level::DEBUG, "seed number is: %f", number);
 
   return  invCDF(number);
 
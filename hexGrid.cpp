@@ -0,0 +1,786 @@
+
+#include "hexGrid.h"
+#include "constants.h"
+#include "logger.h"
+#include "utility.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+
+/*********************************************************************************************************************
+ * Neighbor offsets.  For each orientation, and each of the six directions, we store the change in row, and the change
+ * in column for a cell on an even row and for a cell on an odd row (odd rows are shifted right by half a cell in both
+ * layouts that genGrid builds).
+ *
+ *            vertical (pointy), rows spaced 0.75*h           horizontal (flat), rows spaced 0.5*h
+ *            dir 0 : E   (  0 deg)                           dir 0 : SE  ( 30 deg)
+ *            dir 1 : SE  ( 60 deg)                           dir 1 : S   ( 90 deg)
+ *            dir 2 : SW  (120 deg)                           dir 2 : SW  (150 deg)
+ *            dir 3 : W   (180 deg)                           dir 3 : NW  (210 deg)
+ *            dir 4 : NW  (240 deg)                           dir 4 : N   (270 deg)
+ *            dir 5 : NE  (300 deg)                           dir 5 : NE  (330 deg)
+ *
+ * Angles are measured in scene coordinates (y grows downwards), so the directions are visited in clockwise order
+ * starting at the same angle the old geometric search in onSimPlatesImpl started at.
+ ********************************************************************************************************************/
+static const int32_t offsets[2][cntNeighbors][3] =
+{ //    dRow, dCol(even), dCol(odd)
+  { {  0,  1,  1 }, {  1,  0,  1 }, {  1, -1,  0 }, {  0, -1, -1 }, { -1, -1,  0 }, { -1,  0,  1 } },   // VERTICAL
+  { {  1,  0,  1 }, {  2,  0,  0 }, {  1, -1,  0 }, { -1, -1,  0 }, { -2,  0,  0 }, { -1,  0,  1 } }    // HORIZONTAL
+};
+
+
+hexGrid::hexGrid() : m_orient(hexGrid::orien::UNKNOWN), m_size(0), m_rows(0), m_cols(0), m_originX(0), m_originY(0), m_colStep(0), m_rowStep(0),
+                     m_oddShift(0), m_pPlate(nullptr), m_pStyle(nullptr), m_pElevation(nullptr)
+{
+
+}
+
+
+hexGrid::~hexGrid()
+{
+
+}
+
+
+/**********************************************************************************************************************
+ * Function: dimensions
+ *
+ * Abstract: Calculates the number of rows and columns of hexagons needed to tile an image of the given size.  Vertical
+ *           rows are 0.75*h apart and columns w apart; horizontal rows are packed 0.5*h apart and columns 1.5*w apart.
+ *
+ * Input   : orient -- [in] orientation of the hexagons
+ *           size   -- [in] radius of the circumscribed circle of a hexagon
+ *           width  -- [in] width of the image
+ *           height -- [in] height of the image
+ *           rows   -- [out] number of rows in the grid
+ *           cols   -- [out] number of columns in the grid
+ *
+ * Returns : true if the orientation is known, false otherwise
+ *
+ * Written : Oct 2026 (gkhuber) -- moved here from terrainGen::genGrid
+ *********************************************************************************************************************/
+bool hexGrid::dimensions(uint8_t orient, double size, double width, double height, uint32_t* rows, uint32_t* cols)
+{
+  if (orient == hexGrid::orien::VERTICAL)
+  {
+    *rows = (uint32_t)ceil(height / (0.75 * 2 * size));
+    *cols = (uint32_t)ceil(width / (size * sqrt3));
+    return true;
+  }
+  else if (orient == hexGrid::orien::HORIZONTAL)
+  {
+    *rows = (uint32_t)(height / (0.5 * size * sqrt(3)));
+    *cols = (uint32_t)ceil(width / (1.5 * 2 * size));
+    return true;
+  }
+
+  *rows = 0;
+  *cols = 0;
+  return false;
+}
+
+
+/**********************************************************************************************************************
+ * Function: build
+ *
+ * Abstract: This function sets the dimensions of the grid and resets the state of every cell.  The neighbor table is
+ *           not built, see 'buildNeighbors'.
+ *
+ * Input   : orient -- [in] orientation of the hexagons, either hexGrid::orien::VERTICAL or hexGrid::orien::HORIZONTAL
+ *           size   -- [in] radius of the circumscribed circle of a hexagon (imageProps::hexagonSize)
+ *           rows   -- [in] number of rows in the grid
+ *           cols   -- [in] number of columns in the grid
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void hexGrid::build(uint8_t orient, double size, uint32_t rows, uint32_t cols)
+{
+  setLayout(orient, size, rows, cols);
+  resetCells();
+}
+
+
+/**********************************************************************************************************************
+ * Function: setLayout
+ *
+ * Abstract: Sets the dimensions of the grid without giving it any cell arrays, for a caller that attaches its own (see
+ *           attachCells).  The cells must not be touched until then.
+ *
+ * Input   : orient -- [in] orientation of the hexagons
+ *           size   -- [in] radius of the circumscribed circle of a hexagon
+ *           rows   -- [in] number of rows in the grid
+ *           cols   -- [in] number of columns in the grid
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void hexGrid::setLayout(uint8_t orient, double size, uint32_t rows, uint32_t cols)
+{
+  clear();
+
+  m_orient = orient;
+  m_size = size;
+  m_rows = rows;
+  m_cols = cols;
+
+  buildLattice();
+}
+
+
+void hexGrid::clear()
+{
+  m_orient = hexGrid::orien::UNKNOWN;
+  m_size = 0;
+  m_rows = 0;
+  m_cols = 0;
+  m_originX = 0;
+  m_originY = 0;
+  m_colStep = 0;
+  m_rowStep = 0;
+  m_oddShift = 0;
+  m_neighbors.clear();
+  m_neighbors.shrink_to_fit();
+  m_plate.clear();
+  m_plate.shrink_to_fit();
+  m_style.clear();
+  m_style.shrink_to_fit();
+  m_elevation.clear();
+  m_elevation.shrink_to_fit();
+  m_cellOwner.reset();
+  bindCells();
+}
+
+
+void hexGrid::swap(hexGrid& other)
+{
+  std::swap(m_orient, other.m_orient);
+  std::swap(m_size, other.m_size);
+  std::swap(m_rows, other.m_rows);
+  std::swap(m_cols, other.m_cols);
+  std::swap(m_originX, other.m_originX);
+  std::swap(m_originY, other.m_originY);
+  std::swap(m_colStep, other.m_colStep);
+  std::swap(m_rowStep, other.m_rowStep);
+  std::swap(m_oddShift, other.m_oddShift);
+  m_neighbors.swap(other.m_neighbors);
+  m_plate.swap(other.m_plate);                             // swapping vectors keeps their buffers, so the pointers
+  m_style.swap(other.m_style);                             // stay valid
+  m_elevation.swap(other.m_elevation);
+  std::swap(m_pPlate, other.m_pPlate);
+  std::swap(m_pStyle, other.m_pStyle);
+  std::swap(m_pElevation, other.m_pElevation);
+  m_cellOwner.swap(other.m_cellOwner);
+}
+
+
+/**********************************************************************************************************************
+ * Function: resetCells
+ *
+ * Abstract: Returns every cell to its initial state: not part of any plate, drawn hollow and at zero elevation.
+ *
+ * Input   : void
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void hexGrid::resetCells()
+{
+  m_plate.assign(getCount(), 0);
+  m_style.assign(getCount(), bHollow);
+  m_elevation.assign(getCount(), 0.0f);
+  m_cellOwner.reset();
+  bindCells();
+}
+
+
+/**********************************************************************************************************************
+ * Function: swapCells
+ *
+ * Abstract: Exchanges the plate, style and elevation arrays of the grid with the given arrays.  This lets a kernel
+ *           compute the next state of the cells into its own arrays and then install it without copying.  The arrays
+ *           must hold one entry per cell.  If the cell arrays are attached they are given up, and the given arrays
+ *           get back arrays of the right size whose content is undefined.
+ *
+ * Input   : plate     -- [in/out] plate of each cell
+ *           style     -- [in/out] style of each cell
+ *           elevation -- [in/out] elevation of each cell
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void hexGrid::swapCells(std::vector<uint16_t>& plate, std::vector<uint8_t>& style, std::vector<float>& elevation)
+{
+  if ((plate.size() != getCount()) || (style.size() != getCount()) || (elevation.size() != getCount()))
+  {
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::ERR, "hexGrid::swapCells -- arrays do not match the size of the grid");
+    return;
+  }
+
+  if (isAttached())
+  {
+    m_plate.resize(getCount());
+    m_style.resize(getCount());
+    m_elevation.resize(getCount());
+    m_cellOwner.reset();
+  }
+
+  m_plate.swap(plate);
+  m_style.swap(style);
+  m_elevation.swap(elevation);
+  bindCells();
+}
+
+
+/**********************************************************************************************************************
+ * Function: attachCells
+ *
+ * Abstract: Makes the grid use cell arrays it does not own, without copying them.  The grid keeps a reference to the
+ *           owner of the arrays until it gets its own arrays back.  Writes to the cells go to the attached arrays.
+ *
+ * Input   : plate     -- [in] plate of each cell, one entry per cell
+ *           style     -- [in] style of each cell
+ *           elevation -- [in] elevation of each cell
+ *           owner     -- [in] owner of the memory holding the arrays
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void hexGrid::attachCells(uint16_t* plate, uint8_t* style, float* elevation, std::shared_ptr<void> owner)
+{
+  m_plate.clear();
+  m_plate.shrink_to_fit();
+  m_style.clear();
+  m_style.shrink_to_fit();
+  m_elevation.clear();
+  m_elevation.shrink_to_fit();
+
+  m_pPlate = plate;
+  m_pStyle = style;
+  m_pElevation = elevation;
+  m_cellOwner = std::move(owner);
+}
+
+
+/**********************************************************************************************************************
+ * Function: detachCells
+ *
+ * Abstract: Copies attached cell arrays into arrays owned by the grid, and lets go of their owner.  Does nothing if the
+ *           grid already owns its arrays.
+ *
+ * Input   : void
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void hexGrid::detachCells()
+{
+  if (!isAttached()) return;
+
+  m_plate.assign(m_pPlate, m_pPlate + getCount());
+  m_style.assign(m_pStyle, m_pStyle + getCount());
+  m_elevation.assign(m_pElevation, m_pElevation + getCount());
+  m_cellOwner.reset();
+  bindCells();
+}
+
+
+void hexGrid::bindCells()
+{
+  m_pPlate = m_plate.data();
+  m_pStyle = m_style.data();
+  m_pElevation = m_elevation.data();
+}
+
+
+/**********************************************************************************************************************
+ * Function: buildLattice
+ *
+ * Abstract: Calculates the spacing of the cell centers.  The first cell is centered at (0.5*w, 0.5*h) and odd rows are
+ *           shifted right, the spacing between centers depends on the orientation (see terrainGen::genGrid)
+ *                              vertical (pointy)                   horizontal (flat)
+ *           width, w,              s\sqrt(3)                             2*s
+ *           height, h,             2*s                                   s\sqrt(3)
+ *           column spacing         1.0*w                                 1.5*w
+ *           row spacing            0.75*h                                0.5*h
+ *           odd row offset         0.5*w                                 0.75*w
+ *
+ * Input   : void
+ *
+ * Returns : void.  modifies m_originX, m_originY, m_colStep, m_rowStep and m_oddShift
+ *
+ * Written : Oct 2026 (gkhuber) -- was buildCenters, which stored the center of every cell
+ *********************************************************************************************************************/
+void hexGrid::buildLattice()
+{
+  double width;
+  double height;
+
+  cellSize(&width, &height);
+
+  m_originX = 0.5 * width;
+  m_originY = 0.5 * height;
+
+  if (m_orient == hexGrid::orien::VERTICAL)
+  {
+    m_colStep = width;
+    m_rowStep = 0.75 * height;
+    m_oddShift = 0.5 * width;
+  }
+  else
+  {
+    m_colStep = 1.5 * width;
+    m_rowStep = 0.5 * height;
+    m_oddShift = 0.75 * width;
+  }
+}
+
+
+/**********************************************************************************************************************
+ * Function: buildNeighbors
+ *
+ * Abstract: Fills in the neighbor table using the offsets above.  Any neighbor that would fall outside of the grid is
+ *           set to 'noNeighbor'.  The table is built once per grid, later calls return at once.  It is not safe to
+ *           call while other threads read the grid.
+ *
+ * Input   : void
+ *
+ * Returns : void.  modifies m_neighbors
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void hexGrid::buildNeighbors()
+{
+  if (hasNeighbors()) return;
+
+  m_neighbors.assign((size_t)cntNeighbors * getCount(), noNeighbor);
+
+  if ((m_orient != hexGrid::orien::VERTICAL) && (m_orient != hexGrid::orien::HORIZONTAL))
+  {
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::ERR, "hexGrid::buildNeighbors -- unknown orientation %d", (int)m_orient);
+    return;
+  }
+
+  const int32_t (*table)[3] = offsets[m_orient - 1];
+
+  for (int64_t row = 0; row < m_rows; row++)
+  {
+    uint32_t parity = (row % 2) + 1;                                       // column in table to use for this row
+
+    for (int64_t col = 0; col < m_cols; col++)
+    {
+      uint32_t* pNbrs = &m_neighbors[cntNeighbors * (row * m_cols + col)];
+
+      for (uint8_t dir = 0; dir < cntNeighbors; dir++)
+      {
+        int64_t nRow = row + table[dir][0];
+        int64_t nCol = col + table[dir][parity];
+
+        if ((nRow >= 0) && (nRow < m_rows) && (nCol >= 0) && (nCol < m_cols))
+          pNbrs[dir] = (uint32_t)(nRow * m_cols + nCol);
+      }
+    }
+  }
+}
+
+
+/**********************************************************************************************************************
+ * Function: cellAt
+ *
+ * Abstract: This function returns the id of the cell containing the point pt.  Rather than testing each hexagon, the
+ *           point is converted into fractional axial coordinates (q, r) of the hexagonal lattice, rounded to the
+ *           nearest hexagon in cube coordinates, and then converted into the (row, col) layout used by genGrid (see
+ *           https://www.redblobgames.com/grids/hexagons/ ).  Coordinates are measured from the center of cell 0,
+ *           which is at (0.5*w, 0.5*h).
+ *
+ *                              vertical (pointy)                   horizontal (flat)
+ *           q                  (sqrt(3)/3 * x - y/3) / s           (2/3 * x) / s
+ *           r                  (2/3 * y) / s                       (-x/3 + sqrt(3)/3 * y) / s
+ *           row                r                                   2*r + q     (rows are half a hexagon apart)
+ *           col                q + (r - (r&1))/2                   (q - (q&1))/2
+ *
+ * Input   : pt -- [in] point, in scene coordinates, to locate
+ *
+ * Returns : id of the cell holding the point, or noCell if the point does not fall on the grid
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+uint32_t hexGrid::cellAt(pointF pt) const
+{
+  double   fq;                                                            // fractional axial coordinates
+  double   fr;
+  int64_t  row;
+  int64_t  col;
+
+  if (m_orient == hexGrid::orien::VERTICAL)
+  {
+    double x = pt.x() - 0.5 * sqrt3 * m_size;
+    double y = pt.y() - m_size;
+
+    fq = (sqrt3 / 3.0 * x - y / 3.0) / m_size;
+    fr = (2.0 / 3.0 * y) / m_size;
+  }
+  else if (m_orient == hexGrid::orien::HORIZONTAL)
+  {
+    double x = pt.x() - m_size;
+    double y = pt.y() - 0.5 * sqrt3 * m_size;
+
+    fq = (2.0 / 3.0 * x) / m_size;
+    fr = (-x / 3.0 + sqrt3 / 3.0 * y) / m_size;
+  }
+  else
+  {
+    return noCell;
+  }
+
+  // round to the nearest hexagon, the cube coordinate with the largest rounding error is recomputed from the others
+  double   fs = -fq - fr;
+  double   rq = std::round(fq);
+  double   rr = std::round(fr);
+  double   rs = std::round(fs);
+  double   dq = std::fabs(rq - fq);
+  double   dr = std::fabs(rr - fr);
+  double   ds = std::fabs(rs - fs);
+
+  if ((dq > dr) && (dq > ds))
+    rq = -rr - rs;
+  else if (dr > ds)
+    rr = -rq - rs;
+
+  int64_t q = (int64_t)rq;
+  int64_t r = (int64_t)rr;
+
+  if (m_orient == hexGrid::orien::VERTICAL)
+  {
+    row = r;
+    col = q + (r - (r & 1)) / 2;
+  }
+  else
+  {
+    row = 2 * r + q;
+    col = (q - (q & 1)) / 2;
+  }
+
+  if ((row < 0) || (row >= m_rows) || (col < 0) || (col >= m_cols))
+    return noCell;
+
+  return (uint32_t)(row * m_cols + col);
+}
+
+
+/*********************************************************************************************************************
+ * Function: vertices
+ *
+ * Abstract: Calculates the six vertices of a cell.  In a regular hexagon, the six internal angles are each 120
+ *            degrees.  Knowing just the side length, s, we can calculate some additional properties.  Consider the
+ *            following diagram (in poor ascii art):
+ *
+ *                                    a = 2*r                            a = s + 2r
+ *                              __   |--------|                        |---------------|
+ *                              |       /\
+ *                              |      /0 \                     _          0_ _ _ _ 1
+ *                              |     /    \                    |          /       \
+ *                              |    /      \                   |         /         \
+ *                              |    |5     1|                  |        /           \
+ *                  s + 2*h = b |    |   *   |                  |       <5     *     2>|
+ *                              |    |4     2|                  |        \           / |
+ *                              |    \      /|                  |         \         /  | h = s * cos(30)
+ *                              |	    \    / |  h = s*sin(30)   |          \_ _ _ _/___|
+ *                              |	     \3 /  |                  -          4      3  r = s * sin(30)
+ *                              __	  	\/___|
+ *                                        r = s*cos(30)
+ *
+ *            So, if we have the center of a hexagon (represented by the asterics) at {x,y} we can calculate
+ *            the location of the six verticies thusly.  Vertex[0] is the top vertex and they are numberd
+ *            going clockwise.  Both forms have clockwise winding
+ *
+ *                            upright
+ *            vertex[0] = {x    , y - ((s/2) + h)}                   {x - (s/2)     , y - h}
+ *            vertex[1] = {x + r, y - (s/2)      }                   {x + (s/2)     , y - h}
+ *            vertex[2] = {x + r, y + (s/2)      }                   {x + ((s/2) + r, y    }
+ *            vertex[3] = {x    , y + ((s/2) + h)}                   {x + (s/2)     , y + h}
+ *            vertex[4] = {x - r, y - (s/2)      }                   {x - (s/2)     , y + h}
+ *            vertex[5] = {x - r, y - ((s/2) + h)}                   {x - ((s/2) + r, y    }
+ *
+ *            We need some useful constants (to cut down on the math overhead
+ *
+ *            pi      = 3.14159265
+ *            sin(30) = 0.5
+ *            cos(30) = 0.86602540
+ *
+ * Input   : id  -- [in] id of the cell
+ *           pts -- [out] array of six points to hold the vertices
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber) -- moved here from the hexagon constructor
+ ********************************************************************************************************************/
+void hexGrid::vertices(uint32_t id, pointF* pts) const
+{
+  pointF  center = getCenter(id);
+  double  x = center.x();
+  double  y = center.y();
+
+  if (m_orient == hexGrid::orien::VERTICAL)
+  {
+    double  height = m_size * sin30;
+    double  radius = m_size * cos30;
+
+    pts[0] = pointF(x, y - ((m_size / 2) + height));
+    pts[1] = pointF(x + radius, y - (m_size / 2));
+    pts[2] = pointF(x + radius, y + (m_size / 2));
+    pts[3] = pointF(x, y + ((m_size / 2) + height));
+    pts[4] = pointF(x - radius, y + (m_size / 2));
+    pts[5] = pointF(x - radius, y - (m_size / 2));
+  }
+  else
+  {
+    double height = m_size * cos30;
+    double radius = m_size * sin30;
+
+    pts[0] = pointF(x - (m_size / 2), y - height);
+    pts[1] = pointF(x + (m_size / 2), y - height);
+    pts[2] = pointF(x + (m_size / 2) + radius, y);
+    pts[3] = pointF(x + (m_size / 2), y + height);
+    pts[4] = pointF(x - (m_size / 2), y + height);
+    pts[5] = pointF(x - (m_size / 2) - radius, y);
+  }
+}
+
+
+/**********************************************************************************************************************
+ * Function: contains
+ *
+ * Abstract: this function determines if the hexagon contains the given point,  this test is performed in three steps,
+ *           (1) first is the point located in or on the inner square - if so return true
+ *           (2) second, is the point contained in the outer bounding box - if not return false
+ *           (3) third, determine orientation to four diagonal edges - if all are left return true.
+ *           These tests are different based on the orientation, see below
+ *                
+ *                    /\                                
+ *                   /0 \                                   0_ _ _ _ 1
+ *                  /    \                                  /       \
+ *                 /      \                                /         \
+ *                 |5     1|                              /           \
+ *                 |   *   |                             <5     *     2>
+ *                 |4     2|                              \           / 
+ *                 \      /|                               \         /  
+ *                  \    / |                                \_ _ _ _/
+ *                   \3 /  |                                4      3 
+ *                  	\/___|                            
+ *                                                      
+ *          inner rectangle: v5 -> v2                       v0 -> v3
+ *          bounding box     (v5_x, v0_y) -> (v1_x, v3_y)   (v5_x, v0_y) -> (v2_x, v3_y)
+ *          edges to check   e(v0, v5), e(v4, v3)           e(v0, v5), e(v5, v4)
+ *                           e(v3, v2), e(v1, v0)           e(v3, v2), e(v2, v1)
+ * 
+ * Input   : id -- [in] id of the cell to test
+ *           pt -- [in] pointF object to check membership in internal and border points.
+ *
+ * Returns : boolean, true if point belongs to the hexagon false otherwise
+ *
+ * Written : Mar 2026 (gkhuber)
+ *           Oct 2026 (gkhuber) -- moved here from the hexagon class, vertices are calculated from the cell center
+ *********************************************************************************************************************/
+bool hexGrid::contains(uint32_t id, pointF pt) const
+{
+  bool                   inHex = false;
+  std::array<pointF, 6>  verts;
+
+  vertices(id, verts.data());
+
+  if (m_orient == hexGrid::orien::VERTICAL)
+  {
+    if((verts.at(5).x() <= pt.x()) && (pt.x() < verts.at(2).x()) &&   // check membership in inner rectangle
+      (verts.at(5).y() < pt.y()) && (pt.y() < verts.at(2).y()))
+    {
+      inHex = true;
+    }
+    else
+    {
+      if (!((verts.at(5).x() <= pt.x()) && (pt.x() < verts.at(1).x()) &&  // check memberhip in bounding box
+        (verts.at(0).y() <= pt.y()) && (pt.y() < verts.at(3).y())))
+      {
+        inHex = false;
+      }
+      else
+      {
+        int8_t o1 = orient(verts.at(0), verts.at(5), pt);
+        int8_t o2 = orient(verts.at(4), verts.at(3), pt);
+        int8_t o3 = orient(verts.at(3), verts.at(2), pt);
+        int8_t o4 = orient(verts.at(1), verts.at(0), pt);
+
+        if ((o1 == dir::LEFT) && (o2 == dir::LEFT) && (o3 == dir::LEFT) && (o4 == dir::LEFT))
+        {
+          inHex = true;
+        }
+      }
+    }
+  }  // end hexagon::orien::VERTICAL checks
+  else if (m_orient == hexGrid::orien::HORIZONTAL)
+  {
+    if ((verts.at(0).x() <= pt.x()) && (pt.x() < verts.at(3).x()) &&   // check membership in inner rectangle
+      (verts.at(0).y() < pt.y()) && (pt.y() < verts.at(3).y()))
+    {
+      inHex = true;
+    }
+    else
+    {
+      if (!((verts.at(5).x() <= pt.x()) && (pt.x() < verts.at(2).x()) &&  // check memberhip in bounding box
+        (verts.at(0).y() <= pt.y()) && (pt.y() < verts.at(3).y())))
+      {
+        inHex = false;
+      }
+      else
+      {
+        int8_t o1 = orient(verts.at(0), verts.at(5), pt);
+        int8_t o2 = orient(verts.at(5), verts.at(4), pt);
+        int8_t o3 = orient(verts.at(3), verts.at(2), pt);
+        int8_t o4 = orient(verts.at(2), verts.at(1), pt);
+
+        if ((o1 == dir::LEFT) && (o2 == dir::LEFT) && (o3 == dir::LEFT) && (o4 == dir::LEFT))
+        {
+          inHex = true;
+        }
+      }
+    }
+  }
+  else
+  {
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::WARNING, "unknown or illegal orientation");
+  }
+
+  return inHex;
+}
+
+
+/**********************************************************************************************************************
+ * Function: cellSize
+ *
+ * Abstract: Returns the width and height of one hexagon, w = s*sqrt(3) and h = 2*s for vertical hexagons, w = 2*s and
+ *           h = s*sqrt(3) for horizontal ones.
+ *
+ * Input   : width  -- [out] width of a hexagon
+ *           height -- [out] height of a hexagon
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void hexGrid::cellSize(double* width, double* height) const
+{
+  if (m_orient == hexGrid::orien::VERTICAL)
+  {
+    *width = m_size * sqrt3;
+    *height = 2 * m_size;
+  }
+  else if (m_orient == hexGrid::orien::HORIZONTAL)
+  {
+    *width = 2 * m_size;
+    *height = m_size * sqrt3;
+  }
+  else
+  {
+    *width = 0;
+    *height = 0;
+  }
+}
+
+
+/**********************************************************************************************************************
+ * Function: extent
+ *
+ * Abstract: Returns the size of the area covered by the cells, measured from the origin.  This is slightly larger than
+ *           the image, the last row and column of hexagons overhang its edges.
+ *
+ * Input   : width  -- [out] right edge of the rightmost cell
+ *           height -- [out] bottom edge of the lowest cell
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void hexGrid::extent(double* width, double* height) const
+{
+  double w, h;
+
+  cellSize(&w, &h);
+  if (getCount() == 0)
+  {
+    *width = 0;
+    *height = 0;
+  }
+  else if (m_orient == hexGrid::orien::VERTICAL)
+  {
+    *width = (m_cols + 0.5) * w;                             // odd rows are shifted half a hexagon right
+    *height = (m_rows - 1) * 0.75 * h + h;
+  }
+  else
+  {
+    *width = (m_cols - 1) * 1.5 * w + 1.75 * w;              // odd rows are shifted three quarters of a hexagon right
+    *height = (m_rows - 1) * 0.5 * h + h;
+  }
+}
+
+
+/**********************************************************************************************************************
+ * Function: cellRange
+ *
+ * Abstract: Calculates the rows and columns of the cells that may overlap a rectangle, so that drawing code only has to
+ *           visit those.  Rows are 0.75*h apart (vertical) or 0.5*h apart (horizontal), and columns are w or 1.5*w
+ *           apart; a cell reaches half a width and half a height from its center, and odd rows are shifted right.  The
+ *           range is widened by one row and one column on each side so that no partially covered cell is missed.  The
+ *           range is empty (first > last) if the rectangle misses the grid.
+ *
+ * Input   : x0, y0   -- [in] top left corner of the rectangle
+ *           x1, y1   -- [in] bottom right corner of the rectangle
+ *           rowFirst -- [out] first and last row, and first and last column, all inclusive
+ *           rowLast
+ *           colFirst
+ *           colLast
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void hexGrid::cellRange(double x0, double y0, double x1, double y1, uint32_t* rowFirst, uint32_t* rowLast, uint32_t* colFirst,
+                        uint32_t* colLast) const
+{
+  double w, h;
+
+  cellSize(&w, &h);
+
+  double  rowStep = (m_orient == hexGrid::orien::VERTICAL) ? 0.75 * h : 0.5 * h;
+  double  colStep = (m_orient == hexGrid::orien::VERTICAL) ? w : 1.5 * w;
+
+  if ((getCount() == 0) || (rowStep <= 0) || (x1 < 0) || (y1 < 0))
+  {
+    *rowFirst = *colFirst = 1;
+    *rowLast = *colLast = 0;
+    return;
+  }
+
+  int64_t r0 = std::max<int64_t>(0, (int64_t)floor((y0 - h) / rowStep) - 1);
+  int64_t r1 = std::min<int64_t>((int64_t)m_rows - 1, (int64_t)ceil(y1 / rowStep) + 1);
+  int64_t c0 = std::max<int64_t>(0, (int64_t)floor((x0 - 2 * w) / colStep) - 1);
+  int64_t c1 = std::min<int64_t>((int64_t)m_cols - 1, (int64_t)ceil(x1 / colStep) + 1);
+
+  *rowFirst = (uint32_t)std::min<int64_t>(r0, m_rows);
+  *rowLast = (uint32_t)r1;
+  *colFirst = (uint32_t)std::min<int64_t>(c0, m_cols);
+  *colLast = (uint32_t)c1;
+  if ((r0 > r1) || (c0 > c1))
+  {
+    *rowFirst = *colFirst = 1;
+    *rowLast = *colLast = 0;
+  }
+}
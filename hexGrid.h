@@ -0,0 +1,131 @@
+/**********************************************************************************************************************
+ * Class    : hexGrid
+ *
+ * Abstract : This class is the data model of the hexagonal grid that tiles the map.  Cells are numbered in row-major
+ *            order (id = row * cols + col).  The state of the cells is kept as a structure of arrays, each array is
+ *            contiguous and indexed by the cell id:
+ *               (1) the plate the cell belongs to (0 if the cell has not been claimed by a plate)
+ *               (2) the style flags of the cell (bHollow, bFilled, bColor, bDispCenter, ...)
+ *               (3) the elevation of the cell
+ *               (4) the ids of the six neighbors of the cell.  Cells on the edge of the map have fewer than six
+ *                   neighbors, the missing ones are marked with the sentinel value 'noNeighbor'.  The table is only
+ *                   needed to grow the plates, so it is built by 'buildNeighbors', not by 'build'.
+ *            That is 7 bytes per cell, plus 24 once the neighbor table is built.  The center of a cell is not stored,
+ *            it follows from the row and column of the cell.  The simulation reads and writes the arrays directly,
+ *            the layers in the scene are only a view of them.
+ *            The plate, style and elevation arrays are normally owned by the grid, but 'attachCells' lets the grid
+ *            use arrays that live somewhere else, e.g. in a terrain file mapped into memory (see worldFile.h), for as
+ *            long as it keeps the owner of that memory.  The grid owns its arrays again after 'detachCells',
+ *            'resetCells' or 'swapCells'.
+ *            The grid also knows the size of its hexagons so that it can map a point in scene coordinates to the cell
+ *            that contains it in constant time (see 'cellAt'), and the range of cells under a rectangle (see
+ *            'cellRange') so that the layers only paint what is in view.
+ *
+ * History  : created Oct 2026 (gkhuber)
+ *            Oct 2026 (gkhuber) moved the cell state (centers, plate, style, elevation) out of the hexagon items
+ *            Oct 2026 (gkhuber) centers are computed instead of stored, the neighbor table is built on demand and the
+ *                               cell arrays can be attached from memory the grid does not own
+ *            Oct 2026 (gkhuber) points are pointF (see constants.h), the grid no longer depends on Qt
+ *********************************************************************************************************************/
+
+#ifndef _hexGrid_h_
+#define _hexGrid_h_
+
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include "constants.h"
+
+static const uint32_t noCell = 0xFFFFFFFF;              // sentinel for a point, or neighbor, that is not on the map
+static const uint32_t noNeighbor = noCell;
+static const uint8_t  cntNeighbors = 6;
+
+class hexGrid
+{
+public:
+  enum orien : std::uint8_t { UNKNOWN = 0, VERTICAL = 1, HORIZONTAL = 2 };
+
+  hexGrid();
+  ~hexGrid();
+
+  static bool dimensions(uint8_t orient, double size, double width, double height, uint32_t* rows, uint32_t* cols);
+
+  void     build(uint8_t orient, double size, uint32_t rows, uint32_t cols);
+  void     setLayout(uint8_t orient, double size, uint32_t rows, uint32_t cols);
+  void     buildNeighbors();
+  void     clear();
+  void     swap(hexGrid& other);
+
+  uint8_t  getOrient() const { return m_orient; }
+  double   getSize() const { return m_size; }
+  uint32_t getRows() const { return m_rows; }
+  uint32_t getCols() const { return m_cols; }
+  uint32_t getCount() const { return m_rows * m_cols; }
+
+  // only valid once 'buildNeighbors' has been called
+  bool     hasNeighbors() const { return !m_neighbors.empty() || (getCount() == 0); }
+  uint32_t neighbor(uint32_t id, uint8_t dir) const { return m_neighbors[cntNeighbors * id + dir]; }
+  const uint32_t* neighbors(uint32_t id) const { return &m_neighbors[cntNeighbors * id]; }
+
+  // per-cell state
+  pointF   getCenter(uint32_t id) const
+  {
+    uint32_t row = id / m_cols;
+    return pointF(m_originX + ((row & 1) ? m_oddShift : 0) + m_colStep * (id % m_cols), m_originY + m_rowStep * row);
+  }
+  uint16_t getPlate(uint32_t id) const { return m_pPlate[id]; }
+  void     setPlate(uint32_t id, uint16_t p) { m_pPlate[id] = p; }
+  uint8_t  getStyle(uint32_t id) const { return m_pStyle[id]; }
+  void     setStyle(uint32_t id, uint8_t s) { m_pStyle[id] = s; }
+  float    getElevation(uint32_t id) const { return m_pElevation[id]; }
+  void     setElevation(uint32_t id, float e) { m_pElevation[id] = e; }
+  void     resetCells();
+  void     swapCells(std::vector<uint16_t>& plate, std::vector<uint8_t>& style, std::vector<float>& elevation);
+  void     attachCells(uint16_t* plate, uint8_t* style, float* elevation, std::shared_ptr<void> owner);
+  void     detachCells();
+  bool     isAttached() const { return (m_cellOwner != nullptr); }
+
+  // raw access to the cell arrays for the simulation loops
+  uint16_t*    plates() { return m_pPlate; }
+  const uint16_t* plates() const { return m_pPlate; }
+  uint8_t*     styles() { return m_pStyle; }
+  const uint8_t* styles() const { return m_pStyle; }
+  float*       elevations() { return m_pElevation; }
+  const float* elevations() const { return m_pElevation; }
+
+  // geometry
+  void     vertices(uint32_t id, pointF* pts) const;
+  bool     contains(uint32_t id, pointF pt) const;
+  uint32_t cellAt(pointF pt) const;
+  void     cellSize(double* width, double* height) const;
+  void     extent(double* width, double* height) const;
+  void     cellRange(double x0, double y0, double x1, double y1, uint32_t* rowFirst, uint32_t* rowLast, uint32_t* colFirst,
+                     uint32_t* colLast) const;
+
+private:
+  uint8_t                 m_orient;
+  double                  m_size;                  // radius of the circumscribed circle of a hexagon
+  uint32_t                m_rows;
+  uint32_t                m_cols;
+  double                  m_originX;               // center of cell 0
+  double                  m_originY;
+  double                  m_colStep;               // distance between the centers of two columns
+  double                  m_rowStep;               // distance between the centers of two rows
+  double                  m_oddShift;              // odd rows are shifted right by this much
+  std::vector<uint32_t>   m_neighbors;             // cntNeighbors entries per cell, indexed by cell id
+  std::vector<uint16_t>   m_plate;                 // plate index (platesT::ndx), 0 if unclaimed
+  std::vector<uint8_t>    m_style;
+  std::vector<float>      m_elevation;
+  uint16_t*               m_pPlate;                // the cell arrays in use, either the vectors above or attached
+  uint8_t*                m_pStyle;
+  float*                  m_pElevation;
+  std::shared_ptr<void>   m_cellOwner;             // keeps attached arrays alive, nullptr when the grid owns them
+
+  void buildLattice();
+  void bindCells();
+
+  hexGrid(const hexGrid&) = delete;
+  hexGrid& operator=(const hexGrid&) = delete;
+};
+
+#endif
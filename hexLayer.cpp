@@ -0,0 +1,357 @@
+
+#include "hexLayer.h"
+#include "constants.h"
+
+#include <QPainter>
+#include <QPen>
+#include <QBrush>
+#include <QStyleOptionGraphicsItem>
+
+#include <algorithm>
+#include <cmath>
+
+
+hexLayer::hexLayer(const hexGrid* grid, const std::vector<uint32_t>* palette, threadPool* pool, QGraphicsItem* p) : graphicsLayer(p), m_grid(grid),
+                   m_palette(palette), m_renderer(grid, palette, pool), m_width(0), m_height(0), m_stepX(0), m_stepY(0), m_bRasterStale(true), m_bLevelsStale(true)
+{
+  setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);         // needed for option->exposedRect
+  gridChanged();
+}
+
+
+/**********************************************************************************************************************
+ * Function: gridChanged
+ *
+ * Abstract: Recalculates the size of a hexagon and the bounding rectangle of the layer from the grid, and drops the
+ *           image pyramid.  Must be called whenever the grid is rebuilt.
+ *
+ * Input   : void
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void hexLayer::gridChanged()
+{
+  double width, height;
+
+  prepareGeometryChange();
+
+  m_grid->cellSize(&m_width, &m_height);
+  m_grid->extent(&width, &height);
+  m_bounds = (m_grid->getCount() == 0) ? QRectF() : QRectF(0, 0, width, height).adjusted(-1, -1, 1, 1);
+
+  // one pixel of level 0 is one unit of the doubled coordinates, a cell covers two of them
+  m_stepX = (m_grid->getOrient() == hexGrid::orien::VERTICAL) ? 0.5 * m_width : 0.75 * m_width;
+  m_stepY = (m_grid->getOrient() == hexGrid::orien::VERTICAL) ? 0.75 * m_height : 0.5 * m_height;
+  m_pyramid.clear();
+
+  refresh();
+}
+
+
+void hexLayer::refresh()
+{
+  m_bRasterStale = true;
+  update();
+}
+
+
+QRectF hexLayer::cellRect(uint32_t id) const
+{
+  pointF center = m_grid->getCenter(id);
+
+  return QRectF(center.x() - 0.5 * m_width, center.y() - 0.5 * m_height, m_width, m_height).adjusted(-1, -1, 1, 1);
+}
+
+
+void hexLayer::updateCell(uint32_t id)
+{
+  QRectF rect = cellRect(id);
+
+  if (!m_bRasterStale && !m_pyramid.empty())
+  {
+    QPoint topLeft((int)std::floor(rect.left() / m_stepX), (int)std::floor(rect.top() / m_stepY));
+    QPoint bottomRight((int)std::ceil(rect.right() / m_stepX), (int)std::ceil(rect.bottom() / m_stepY));
+    rasterize(QRect(topLeft, bottomRight));
+  }
+  update(rect);
+}
+
+
+/**********************************************************************************************************************
+ * Function: detailFor
+ *
+ * Abstract: Picks the level of detail for hexagons of the given size on screen.
+ *
+ * Input   : cellPixels -- [in] width of a hexagon in screen pixels
+ *
+ * Returns : hexLayer::detail to draw with
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+uint8_t hexLayer::detailFor(double cellPixels)
+{
+  if (cellPixels >= outlinePixels) return hexLayer::detail::OUTLINE;
+  if (cellPixels >= rasterPixels) return hexLayer::detail::FILL;
+  return hexLayer::detail::RASTER;
+}
+
+
+/**********************************************************************************************************************
+ * Function: cellColor
+ *
+ * Abstract: The color a cell is drawn in, the plate color if the cell has the bColor flag set (black otherwise).  The
+ *           cell is filled with it if it is solid and not hollow.
+ *
+ * Input   : id    -- [in] id of the cell
+ *           pFill -- [out] true if the cell is filled
+ *
+ * Returns : color of the cell
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+QColor hexLayer::cellColor(uint32_t id, bool* pFill) const
+{
+  uint8_t  style = m_grid->getStyle(id);
+  uint16_t plate = m_grid->getPlate(id);
+
+  *pFill = ((style & bHollow) != bHollow) && ((style & bFilled) == bFilled);
+
+  if (((style & bColor) == bColor) && (plate < m_palette->size()))
+    return QColor::fromRgba(m_palette->at(plate));
+
+  return QColor(Qt::black);
+}
+
+
+/**********************************************************************************************************************
+ * Function: rasterize
+ *
+ * Abstract: Draws level 0 of the pyramid, or part of it, with the renderer.  Level 0 has one pixel per unit of the
+ *           doubled coordinates (see plateMotion), X = 2 * col + (row & 1) and Y = row, so that every cell covers two
+ *           pixels: (X, Y) and (X + 1, Y) if the hexagons are vertical, (X, Y) and (X, Y + 1) if they are horizontal.
+ *
+ * Input   : pixels -- [in] region of level 0 to draw, an empty rectangle to draw the whole image
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void hexLayer::rasterize(const QRect& pixels)
+{
+  int    width = 2 * m_grid->getCols() + 1;
+  int    height = m_grid->getRows() + 1;
+  QRectF scene(0, 0, width * m_stepX, height * m_stepY);
+
+  if (pixels.isEmpty())
+  {
+    m_pyramid.assign(1, QImage(width, height, QImage::Format_ARGB32_Premultiplied));
+    m_renderer.render(rasterOf(&m_pyramid[0]), sceneOf(scene), { 0, 0, width, height });
+    m_bRasterStale = false;
+  }
+  else
+  {
+    m_renderer.render(rasterOf(&m_pyramid[0]), sceneOf(scene), pixelsOf(pixels));
+  }
+
+  m_bLevelsStale = true;
+}
+
+
+/**********************************************************************************************************************
+ * Function: buildLevels
+ *
+ * Abstract: Rebuilds the levels above 0 of the pyramid, each is the level before scaled down by half (see
+ *           mapRenderer::downsample).
+ *
+ * Input   : void
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void hexLayer::buildLevels()
+{
+  m_pyramid.resize(1);
+
+  while ((m_pyramid.back().width() > 1) || (m_pyramid.back().height() > 1))
+  {
+    const QImage& src = m_pyramid.back();
+    QImage        dst((src.width() + 1) / 2, (src.height() + 1) / 2, QImage::Format_ARGB32_Premultiplied);
+
+    mapRenderer::downsample(rasterOf(src), rasterOf(&dst), 0, 0);
+    m_pyramid.push_back(dst);
+  }
+
+  m_bLevelsStale = false;
+}
+
+
+/**********************************************************************************************************************
+ * Function: paint
+ *
+ * Abstract: Draws the cells that overlap the exposed rectangle at the level of detail that suits the zoom of the view
+ *           (see detailFor).
+ *
+ * Input   : painter -- [in] pointer to the painter to draw with
+ *           option  -- [in] style options, holds the exposed rectangle
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber) -- moved here from hexagon::paint
+ *           Oct 2026 (gkhuber) -- level of detail
+ *********************************************************************************************************************/
+void hexLayer::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget*)
+{
+  if (m_bounds.isEmpty()) return;
+
+  QRectF exposed = ((nullptr != option) ? option->exposedRect : m_bounds) & m_bounds;
+  double lod = QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform());
+
+  switch (detailFor(m_width * lod))
+  {
+    case hexLayer::detail::OUTLINE:
+      paintCells(painter, exposed);
+      break;
+    case hexLayer::detail::FILL:
+      paintView(painter, exposed);
+      break;
+    default:
+      paintRaster(painter, exposed, lod);
+      break;
+  }
+}
+
+
+/**********************************************************************************************************************
+ * Function: paintCells
+ *
+ * Abstract: Draws the cells that overlap the exposed rectangle as polygons (see hexGrid::cellRange), every cell
+ *           outlined in its color and filled cells filled with it.  Neighboring cells usually share a plate, so the
+ *           pen and brush are only changed when the color or the fill changes.
+ *
+ * Input   : painter  -- [in] pointer to the painter to draw with
+ *           exposed  -- [in] rectangle to draw
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void hexLayer::paintCells(QPainter* painter, const QRectF& exposed)
+{
+  uint32_t rowFirst, rowLast, colFirst, colLast;
+  QRgb     curColor = 0;
+  int      curFill = -1;                                  // -1 until the first cell sets the pen
+  pointF   corners[6];
+  QPointF  verts[6];
+
+  m_grid->cellRange(exposed.left(), exposed.top(), exposed.right(), exposed.bottom(), &rowFirst, &rowLast, &colFirst, &colLast);
+
+  for (uint32_t row = rowFirst; row <= rowLast; row++)
+  {
+    for (uint32_t col = colFirst; col <= colLast; col++)
+    {
+      uint32_t id = row * m_grid->getCols() + col;
+      bool     bFill;
+      QColor   color = cellColor(id, &bFill);
+      int      fill = bFill ? 1 : 0;
+
+      if ((curFill < 0) || (color.rgba() != curColor))
+      {
+        QPen pen(color);
+        pen.setWidth(1);
+        painter->setPen(pen);
+      }
+      if ((curFill != fill) || (color.rgba() != curColor))
+      {
+        if (fill) painter->setBrush(QBrush(color, Qt::SolidPattern));
+        else painter->setBrush(Qt::NoBrush);
+      }
+      curColor = color.rgba();
+      curFill = fill;
+
+      m_grid->vertices(id, corners);
+      for (int ndx = 0; ndx < 6; ndx++) verts[ndx] = QPointF(corners[ndx].x(), corners[ndx].y());
+      painter->drawPolygon(verts, 6);
+    }
+  }
+}
+
+
+/**********************************************************************************************************************
+ * Function: paintView
+ *
+ * Abstract: Draws the exposed rectangle with the renderer, one pixel of the image per screen pixel.  The rectangle is
+ *           widened to whole screen pixels first, so the image is painted without being scaled.  Cells that are not
+ *           filled stay transparent, as they are not drawn without their outline.  The image is kept for the next
+ *           paint, and only reallocated when it is too small.
+ *
+ * Input   : painter -- [in] pointer to the painter to draw with
+ *           exposed -- [in] rectangle to draw
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void hexLayer::paintView(QPainter* painter, const QRectF& exposed)
+{
+  const QTransform& transform = painter->worldTransform();
+  QRect             device = transform.mapRect(exposed).toAlignedRect();
+  QRectF            scene = transform.inverted().mapRect(QRectF(device));
+
+  if (device.isEmpty()) return;
+
+  if ((m_view.width() < device.width()) || (m_view.height() < device.height()))
+    m_view = QImage(std::max(m_view.width(), device.width()), std::max(m_view.height(), device.height()), QImage::Format_ARGB32_Premultiplied);
+
+  // the renderer maps the whole image to the scene, so hand it a view of the top left corner only
+  mapRenderer::rasterT view = rasterOf(&m_view);
+  view.width = device.width();
+  view.height = device.height();
+
+  m_renderer.render(view, sceneOf(scene), { 0, 0, device.width(), device.height() });
+  painter->drawImage(scene, m_view, QRectF(0, 0, device.width(), device.height()));
+}
+
+
+/**********************************************************************************************************************
+ * Function: paintRaster
+ *
+ * Abstract: Draws the exposed rectangle from the image pyramid.  The level is the smallest one whose pixels are still
+ *           no bigger than a screen pixel, and only the part of it under the exposed rectangle is drawn.
+ *
+ * Input   : painter -- [in] pointer to the painter to draw with
+ *           exposed -- [in] rectangle to draw
+ *           lod     -- [in] screen pixels per scene unit
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void hexLayer::paintRaster(QPainter* painter, const QRectF& exposed, double lod)
+{
+  if (m_bRasterStale || m_pyramid.empty()) rasterize(QRect());
+  if (m_bLevelsStale) buildLevels();
+
+  size_t level = 0;
+  double texel = std::fmax(m_stepX, m_stepY) * lod;      // screen size of a pixel of the level
+
+  while ((level + 1 < m_pyramid.size()) && (2 * texel <= 1.0))
+  {
+    texel *= 2;
+    level++;
+  }
+
+  const QImage& image = m_pyramid[level];
+  double        scaleX = m_stepX * (double)(1ull << level);
+  double        scaleY = m_stepY * (double)(1ull << level);
+  double        x0 = std::fmax(0.0, std::floor(exposed.left() / scaleX));
+  double        y0 = std::fmax(0.0, std::floor(exposed.top() / scaleY));
+  double        x1 = std::fmin((double)image.width(), std::ceil(exposed.right() / scaleX));
+  double        y1 = std::fmin((double)image.height(), std::ceil(exposed.bottom() / scaleY));
+
+  if ((x1 <= x0) || (y1 <= y0)) return;
+
+  painter->drawImage(QRectF(x0 * scaleX, y0 * scaleY, (x1 - x0) * scaleX, (y1 - y0) * scaleY), image, QRectF(x0, y0, x1 - x0, y1 - y0));
+}
@@ -0,0 +1,86 @@
+#ifndef _hexLayer_h_
+#define _hexLayer_h_
+
+#include <QColor>
+#include <QImage>
+#include <QRectF>
+#include <vector>
+
+#include "graphicsLayer.h"
+#include "hexGrid.h"
+#include "mapRenderer.h"
+
+class threadPool;
+
+
+/**********************************************************************************************************************
+ * Class    : hexLayer
+ *
+ * Abstract : The grid layer of the map.  Rather than one item per cell, this single item paints every cell of the
+ *            hexGrid model itself.  Only the cells that fall inside the exposed rectangle are drawn, the rows and
+ *            columns to visit are calculated from the rectangle, so the cost of a repaint depends on the area that
+ *            is repainted and not on the size of the map.  The color of a cell is looked up in a palette indexed by
+ *            plate (entry 0 is the color of cells that do not belong to a plate).
+ *            When the simulation changes a cell, 'updateCell' invalidates just the rectangle of that cell, and
+ *            'refresh' invalidates the whole layer.  After the grid is rebuilt 'gridChanged' must be called so that
+ *            the bounding rectangle is recalculated.
+ *            How much detail is drawn depends on the size of a hexagon on screen, taken from the view transform:
+ *               OUTLINE -- at least outlinePixels wide, every cell is drawn as a polygon with its outline,
+ *               FILL    -- smaller, outlines can no longer be told apart and are dropped.  The exposed rectangle is
+ *                          drawn by a mapRenderer into an image with one pixel per screen pixel, which is painted in
+ *                          one call, so the cost depends on the pixels painted rather than on the cells,
+ *               RASTER  -- under rasterPixels wide, the cells are no longer drawn one by one.  The layer keeps an image
+ *                          with two pixels per cell laid out on the lattice of doubled coordinates (see plateMotion)
+ *                          and a pyramid of images each half the size of the one before; the level whose pixels are
+ *                          about one screen pixel is drawn.  The image is drawn by a mapRenderer, updated cell by
+ *                          cell, and the smaller levels are rebuilt the next time they are drawn.
+ *
+ * History  : created Oct 2026 (gkhuber) replaces the per-cell hexagon items
+ *            Oct 2026 (gkhuber) level of detail depends on the zoom
+ *            Oct 2026 (gkhuber) the pyramid is drawn by mapRenderer
+ *            Oct 2026 (gkhuber) FILL is drawn by mapRenderer too, polygons are only drawn with their outlines
+ *********************************************************************************************************************/
+class hexLayer : public graphicsLayer
+{
+public:
+  enum detail : std::uint8_t { OUTLINE = 0, FILL = 1, RASTER = 2 };
+
+  hexLayer(const hexGrid* grid, const std::vector<uint32_t>* palette, threadPool* pool = nullptr, QGraphicsItem* p = nullptr);
+
+  QRectF boundingRect() const override { return m_bounds; }
+  void   paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget*) override;
+
+  void   gridChanged();
+  void   refresh();
+  void   updateCell(uint32_t id);
+  QRectF cellRect(uint32_t id) const;
+
+  static uint8_t detailFor(double cellPixels);
+
+private:
+  static constexpr double outlinePixels = 6.0;       // smallest hexagon, in screen pixels, drawn with its outline
+  static constexpr double rasterPixels = 2.0;        // hexagons smaller than this are drawn from the image pyramid
+
+  const hexGrid*              m_grid;
+  const std::vector<uint32_t>* m_palette;
+  mapRenderer                 m_renderer;            // draws level 0 of the pyramid and the FILL view
+  QRectF                      m_bounds;              // union of all the cells
+  double                      m_width;               // width and height of one hexagon
+  double                      m_height;
+
+  std::vector<QImage>         m_pyramid;             // level 0 holds two pixels per cell, drawn by m_renderer
+  double                      m_stepX;               // scene size of a pixel of level 0
+  double                      m_stepY;
+  bool                        m_bRasterStale;        // level 0 must be redrawn from the grid
+  bool                        m_bLevelsStale;        // the levels above 0 must be rebuilt
+  QImage                      m_view;                // FILL, the exposed rectangle at screen resolution
+
+  QColor cellColor(uint32_t id, bool* pFill) const;
+  void   rasterize(const QRect& pixels);
+  void   buildLevels();
+  void   paintCells(QPainter* painter, const QRectF& exposed);
+  void   paintView(QPainter* painter, const QRectF& exposed);
+  void   paintRaster(QPainter* painter, const QRectF& exposed, double lod);
+};
+
+#endif
@@ -0,0 +1,648 @@
+#include "history.h"
+#include "hexGrid.h"
+#include "logger.h"
+
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+
+static const char     magic[8] = { 'T', 'E', 'R', 'R', 'H', 'S', 'T', '\x1a' };
+static const uint32_t byteOrder = 0x01020304;
+static const uint32_t headerSize = 64;
+static const uint32_t recordSize = 16;                       // size of a record header, see history.h
+static const uint32_t maxCodes = 65536;                      // elevations in the table of a keyframe and its deltas
+static const uint32_t noFrame = 0xFFFFFFFF;
+static const uint64_t keyBudget = 4;                         // deltas since a keyframe may add up to this many keyframes
+
+static constexpr uint32_t makeTag(char a, char b, char c, char d)
+{
+  return (uint32_t)(uint8_t)a | ((uint32_t)(uint8_t)b << 8) | ((uint32_t)(uint8_t)c << 16) | ((uint32_t)(uint8_t)d << 24);
+}
+
+static const uint32_t tagKeyframe = makeTag('K', 'E', 'Y', 'F');
+static const uint32_t tagDelta = makeTag('D', 'L', 'T', 'A');
+
+
+template <typename T>
+static void put(std::vector<uint8_t>* buf, T value)
+{
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+  buf->insert(buf->end(), bytes, bytes + sizeof(T));
+}
+
+
+static void putVarint(std::vector<uint8_t>* buf, uint64_t value)
+{
+  while (value >= 0x80)
+  {
+    buf->push_back((uint8_t)(value | 0x80));
+    value >>= 7;
+  }
+  buf->push_back((uint8_t)value);
+}
+
+
+/**********************************************************************************************************************
+ * Class    : recordReader
+ *
+ * Abstract : Reads the fields of a record payload in order.  Reading past the end of the payload fails, so a damaged
+ *            record is refused rather than read out of bounds.
+ *********************************************************************************************************************/
+class recordReader
+{
+public:
+  recordReader(const uint8_t* data, uint64_t len) : m_data(data), m_len(len), m_pos(0) {}
+
+  template <typename T>
+  bool get(T* value)
+  {
+    if (m_len - m_pos < sizeof(T)) return false;
+
+    memcpy(value, m_data + m_pos, sizeof(T));
+    m_pos += sizeof(T);
+    return true;
+  }
+
+  bool getVarint(uint64_t* value)
+  {
+    uint64_t result = 0;
+
+    for (uint32_t shift = 0; (m_pos < m_len) && (shift < 64); shift += 7)
+    {
+      uint8_t byte = m_data[m_pos++];
+
+      result |= (uint64_t)(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0)
+      {
+        *value = result;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool skip(uint64_t len)
+  {
+    if (m_len - m_pos < len) return false;
+
+    m_pos += len;
+    return true;
+  }
+
+private:
+  const uint8_t*  m_data;
+  uint64_t        m_len;
+  uint64_t        m_pos;
+};
+
+
+historyWriter::historyWriter() : m_keyInterval(1), m_cntPlates(0), m_cntFrames(0), m_cntKeys(0), m_lastKey(0), m_keyBytes(0), m_deltaBytes(0),
+                                 m_cntBytes(0)
+{
+
+}
+
+
+historyWriter::~historyWriter()
+{
+  close();
+}
+
+
+/**********************************************************************************************************************
+ * Function: open
+ *
+ * Abstract: Creates a history file, replacing the file if it exists, and writes its header.  The first frame appended
+ *           is always a keyframe.
+ *
+ * Input   : path        -- [in] name of the file
+ *           grid        -- [in] the grid whose cells are recorded
+ *           width       -- [in] size of the image
+ *           height      -- [in]
+ *           cntPlates   -- [in] number of plates
+ *           keyInterval -- [in] most frames from one keyframe to the next, 0 is taken as 1
+ *
+ * Returns : true if the file was created
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+bool historyWriter::open(const std::string& path, const hexGrid& grid, double_t width, double_t height, uint32_t cntPlates, uint32_t keyInterval)
+{
+  close();
+
+  m_file.open(path, std::ios::binary | std::ios::trunc);
+  if (!m_file.is_open())
+  {
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::ERR, "history: cannot create %s", path.c_str());
+    return false;
+  }
+
+  m_path = path;
+  m_keyInterval = std::max(keyInterval, 1u);
+  m_cntPlates = cntPlates;
+  m_cntFrames = 0;
+  m_cntKeys = 0;
+
+  m_buf.assign(magic, magic + sizeof(magic));
+  put(&m_buf, version);
+  put(&m_buf, byteOrder);
+  put(&m_buf, headerSize);
+  put(&m_buf, m_keyInterval);
+  put(&m_buf, m_cntPlates);
+  put(&m_buf, grid.getRows());
+  put(&m_buf, grid.getCols());
+  put(&m_buf, grid.getSize());
+  put(&m_buf, grid.getOrient());
+  put(&m_buf, width);
+  put(&m_buf, height);
+  m_buf.resize(headerSize, 0);
+
+  m_file.write(reinterpret_cast<const char*>(m_buf.data()), m_buf.size());
+  m_cntBytes = m_buf.size();
+
+  if (m_file.fail())
+  {
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::ERR, "history: cannot write %s", path.c_str());
+    m_file.close();
+    return false;
+  }
+
+  CLogger::getInstance()->outMsg(cmdLine, CLogger::level::INFO, "history: recording to %s, a keyframe at least every %u frames", path.c_str(), m_keyInterval);
+  return true;
+}
+
+
+/**********************************************************************************************************************
+ * Function: append
+ *
+ * Abstract: Writes the next frame, as a delta from the frame before, or as a keyframe if it is the first frame, if
+ *           keyInterval frames have passed since the last keyframe, or if the deltas since add up to keyBudget times
+ *           the size of the last keyframe (which bounds the work of rebuilding a frame, see historyReader::seek).
+ *           A keyframe is written as a delta from a blank frame (every cell 0), with the table of
+ *           elevations emptied, so it does not depend on any frame before it.  Keyframes are flushed to disk, so the
+ *           file is always usable up to the last keyframe.
+ *
+ * Input   : grid    -- [in] the grid, the same size as when the file was opened
+ *           plates  -- [in] the plates, their centers are recorded
+ *           curTime -- [in] simulated time in years
+ *
+ * Returns : true if the frame was written
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+bool historyWriter::append(const hexGrid& grid, const platesT* plates, uint64_t curTime)
+{
+  uint64_t cntCells = grid.getCount();
+  bool     bKey = (m_cntFrames == 0) || (m_cntFrames - m_lastKey >= m_keyInterval) || (m_deltaBytes >= keyBudget * m_keyBytes);
+
+  if (!m_file.is_open()) return false;
+
+  m_buf.clear();
+  put(&m_buf, curTime);
+  for (uint32_t ndx = 0; ndx < m_cntPlates; ndx++)
+  {
+    put(&m_buf, plates[ndx].center_x);
+    put(&m_buf, plates[ndx].center_y);
+  }
+
+  if (bKey)                                                  // a keyframe is a delta from a blank frame
+  {
+    m_plate.assign(cntCells, 0);
+    m_style.assign(cntCells, 0);
+    m_elevation.assign(cntCells, 0.0f);
+    m_codes.clear();
+  }
+  encodeDelta(grid);
+
+  if (!writeRecord(bKey ? tagKeyframe : tagDelta)) return false;
+
+  if (bKey)
+  {
+    m_file.flush();
+    m_cntKeys++;
+    m_lastKey = m_cntFrames;
+    m_keyBytes = m_buf.size();
+    m_deltaBytes = 0;
+  }
+  else
+  {
+    m_deltaBytes += m_buf.size();
+  }
+  m_cntFrames++;
+  return true;
+}
+
+
+/**********************************************************************************************************************
+ * Function: close
+ *
+ * Abstract: Closes the file, if one is open, and logs how much it holds.
+ *
+ * Input   : void
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void historyWriter::close()
+{
+  if (!m_file.is_open()) return;
+
+  m_file.close();
+  CLogger::getInstance()->outMsg(cmdLine, CLogger::level::INFO, "history: %s holds %u frames (%u keyframes) in %llu bytes", m_path.c_str(), m_cntFrames,
+                                 m_cntKeys, (unsigned long long)m_cntBytes);
+
+  m_plate.clear();
+  m_plate.shrink_to_fit();
+  m_style.clear();
+  m_style.shrink_to_fit();
+  m_elevation.clear();
+  m_elevation.shrink_to_fit();
+}
+
+
+/**********************************************************************************************************************
+ * Function: encodeDelta
+ *
+ * Abstract: Appends the three lists of runs of a delta to the record being built (see history.h), and brings the copy
+ *           of the frame before up to date as it goes.  Each list ends with a run of no cells.  Elevations are compared
+ *           bit for bit, so that replaying the deltas gives back exactly the floats that were recorded.  Plates and
+ *           styles come in long runs of one value, elevations do not (the cells of a plate carry their elevations
+ *           with them), but a map holds few distinct elevations, so each cell of a run is written as a code into a
+ *           table of them (see putElevation).
+ *
+ * Input   : grid -- [in] the grid
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void historyWriter::encodeDelta(const hexGrid& grid)
+{
+  const uint16_t* cellPlate = grid.plates();
+  const uint8_t*  cellStyle = grid.styles();
+  const float*    cellElevation = grid.elevations();
+  uint64_t        cntCells = grid.getCount();
+  uint64_t        last = 0;                                  // one past the end of the run before
+  uint64_t        id = 0;
+
+  while (id < cntCells)                                      // plates, one plate per run
+  {
+    if (cellPlate[id] == m_plate[id]) { id++; continue; }
+
+    uint16_t plate = cellPlate[id];
+    uint64_t begin = id;
+
+    for (; (id < cntCells) && (cellPlate[id] != m_plate[id]) && (cellPlate[id] == plate); id++) m_plate[id] = plate;
+
+    putVarint(&m_buf, begin - last);
+    putVarint(&m_buf, id - begin);
+    putVarint(&m_buf, plate);
+    last = id;
+  }
+  putVarint(&m_buf, 0);
+  putVarint(&m_buf, 0);
+
+  for (last = 0, id = 0; id < cntCells; )                    // styles, one style per run
+  {
+    if (cellStyle[id] == m_style[id]) { id++; continue; }
+
+    uint8_t  style = cellStyle[id];
+    uint64_t begin = id;
+
+    for (; (id < cntCells) && (cellStyle[id] != m_style[id]) && (cellStyle[id] == style); id++) m_style[id] = style;
+
+    putVarint(&m_buf, begin - last);
+    putVarint(&m_buf, id - begin);
+    m_buf.push_back(style);
+    last = id;
+  }
+  putVarint(&m_buf, 0);
+  putVarint(&m_buf, 0);
+
+  for (last = 0, id = 0; id < cntCells; )                    // elevations, the codes of the cells follow the run
+  {
+    if (memcmp(&cellElevation[id], &m_elevation[id], sizeof(float)) == 0) { id++; continue; }
+
+    uint64_t begin = id;
+
+    while ((id < cntCells) && (memcmp(&cellElevation[id], &m_elevation[id], sizeof(float)) != 0)) id++;
+
+    putVarint(&m_buf, begin - last);
+    putVarint(&m_buf, id - begin);
+    for (uint64_t ndx = begin; ndx < id; ndx++)
+    {
+      m_elevation[ndx] = cellElevation[ndx];
+      putElevation(cellElevation[ndx]);
+    }
+    last = id;
+  }
+  putVarint(&m_buf, 0);
+  putVarint(&m_buf, 0);
+}
+
+
+/**********************************************************************************************************************
+ * Function: putElevation
+ *
+ * Abstract: Appends the code of an elevation to the record being built: the number of the elevation in the table of
+ *           the elevations written since the last keyframe, or 0 followed by the elevation itself if it is not in the
+ *           table yet, in which case it is added (until the table is full).
+ *
+ * Input   : elevation -- [in] the elevation of a cell
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void historyWriter::putElevation(float elevation)
+{
+  uint32_t bits;
+
+  memcpy(&bits, &elevation, sizeof(bits));
+
+  std::unordered_map<uint32_t, uint32_t>::const_iterator it = m_codes.find(bits);
+  if (it != m_codes.end())
+  {
+    putVarint(&m_buf, it->second);
+    return;
+  }
+
+  putVarint(&m_buf, 0);
+  put(&m_buf, elevation);
+
+  uint32_t code = (uint32_t)m_codes.size() + 1;
+  if (code <= maxCodes) m_codes.emplace(bits, code);
+}
+
+
+bool historyWriter::writeRecord(uint32_t tag)
+{
+  char     head[recordSize];
+  uint64_t len = m_buf.size();
+
+  memcpy(head, &tag, sizeof(tag));
+  memcpy(head + 4, &m_cntFrames, sizeof(m_cntFrames));
+  memcpy(head + 8, &len, sizeof(len));
+
+  m_file.write(head, recordSize);
+  m_file.write(reinterpret_cast<const char*>(m_buf.data()), len);
+
+  if (m_file.fail())
+  {
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::ERR, "history: cannot write %s, recording stopped", m_path.c_str());
+    close();
+    return false;
+  }
+
+  m_cntBytes += recordSize + len;
+  return true;
+}
+
+
+historyReader::historyReader() : m_cntPlates(0), m_orient(0), m_size(0), m_rows(0), m_cols(0), m_width(0), m_height(0), m_grid(nullptr), m_frame(noFrame)
+{
+
+}
+
+
+historyReader::~historyReader()
+{
+  close();
+}
+
+
+/**********************************************************************************************************************
+ * Function: open
+ *
+ * Abstract: Maps a history file and indexes its records.  Only the record headers and the simulated time of each
+ *           frame are read, the cells are left on disk until a frame is asked for.  Indexing stops at the first record
+ *           that is cut short or out of order, so the frames of a run that was cut short can still be played back.
+ *
+ * Input   : path -- [in] name of the file
+ *
+ * Returns : true if the file holds at least one frame
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+bool historyReader::open(const std::string& path)
+{
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  uint32_t fileVersion = 0;
+  uint32_t fileOrder = 0;
+  uint32_t fileHeader = 0;
+  uint32_t keyInterval = 0;
+
+  auto fail = [this, &path](const char* reason)
+  {
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::ERR, "history: %s %s", path.c_str(), reason);
+    close();
+    return false;
+  };
+
+  close();
+  if (!m_file.open(path)) return fail("cannot be opened");
+
+  const uint8_t* data = m_file.data();
+  uint64_t       size = m_file.size();
+  recordReader   header(data, std::min<uint64_t>(size, headerSize));
+
+  if ((size < headerSize) || (memcmp(data, magic, sizeof(magic)) != 0)) return fail("is not a history file");
+
+  header.skip(sizeof(magic));
+  header.get(&fileVersion);
+  header.get(&fileOrder);
+  header.get(&fileHeader);
+  header.get(&keyInterval);
+  header.get(&m_cntPlates);
+  header.get(&m_rows);
+  header.get(&m_cols);
+  header.get(&m_size);
+  header.get(&m_orient);
+  header.get(&m_width);
+  header.get(&m_height);
+
+  if (fileOrder != byteOrder) return fail("was written on a machine of the other byte order");
+  if (fileVersion > historyWriter::version) return fail("was written by a newer version of terrainGen");
+  if ((fileHeader < headerSize) || (fileHeader > size)) return fail("has a damaged header");
+
+  uint64_t offset = fileHeader;
+
+  while (size - offset >= recordSize)
+  {
+    uint32_t tag;
+    uint32_t frame;
+    uint64_t len;
+    uint64_t curTime;
+
+    memcpy(&tag, data + offset, sizeof(tag));
+    memcpy(&frame, data + offset + 4, sizeof(frame));
+    memcpy(&len, data + offset + 8, sizeof(len));
+
+    if ((frame != m_offsets.size()) || ((tag != tagKeyframe) && (tag != tagDelta))) break;
+    if ((size - offset - recordSize < len) || (len < sizeof(curTime))) break;          // cut short
+    if (m_keys.empty() && (tag != tagKeyframe)) break;
+
+    memcpy(&curTime, data + offset + recordSize, sizeof(curTime));
+    if (tag == tagKeyframe) m_keys.push_back(frame);
+    m_offsets.push_back(offset + recordSize);
+    m_lengths.push_back(len);
+    m_times.push_back(curTime);
+
+    offset += recordSize + len;
+  }
+
+  if (m_offsets.empty()) return fail("holds no frame");
+
+  m_path = path;
+
+  long long elapsed = (long long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+  CLogger::getInstance()->outMsg(cmdLine, CLogger::level::INFO, "history: %s holds %u frames (%u keyframes), indexed in %lld ms", path.c_str(), getFrames(),
+                                 (uint32_t)m_keys.size(), elapsed);
+  return true;
+}
+
+
+void historyReader::close()
+{
+  m_file.close();
+  m_path.clear();
+  m_offsets.clear();
+  m_lengths.clear();
+  m_times.clear();
+  m_keys.clear();
+  m_table.clear();
+  m_grid = nullptr;
+  m_frame = noFrame;
+}
+
+
+/**********************************************************************************************************************
+ * Function: seek
+ *
+ * Abstract: Rebuilds a frame in the cell arrays of a grid.  The frame is rebuilt from the nearest keyframe at or before
+ *           it, unless the grid holds a frame between that keyframe and the one asked for (the grid was passed to the
+ *           call before and not changed since), in which case only the deltas after it are applied.
+ *
+ * Input   : frame -- [in] the frame, 0 to getFrames() - 1
+ *           grid  -- [in/out] a grid of the size recorded in the file
+ *
+ * Returns : true if the frame was rebuilt, if not the cells of the grid must not be used
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+bool historyReader::seek(uint32_t frame, hexGrid* grid)
+{
+  if ((frame >= getFrames()) || (grid->getRows() != m_rows) || (grid->getCols() != m_cols))
+  {
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::ERR, "history: frame %u is not in %s, or the grid is not the one recorded", frame, m_path.c_str());
+    return false;
+  }
+
+  uint32_t key = *(std::upper_bound(m_keys.begin(), m_keys.end(), frame) - 1);
+  uint32_t from = key;
+
+  if ((grid == m_grid) && (m_frame != noFrame) && (m_frame >= key) && (m_frame <= frame))
+    from = m_frame + 1;                                      // carry on from the frame in the grid
+
+  for (uint32_t ndx = from; ndx <= frame; ndx++)
+  {
+    if (!decode(ndx, grid))
+    {
+      CLogger::getInstance()->outMsg(cmdLine, CLogger::level::ERR, "history: frame %u of %s is damaged", ndx, m_path.c_str());
+      m_frame = noFrame;
+      return false;
+    }
+  }
+
+  m_grid = grid;
+  m_frame = frame;
+  return true;
+}
+
+
+/**********************************************************************************************************************
+ * Function: decode
+ *
+ * Abstract: Applies the record of a frame to the cell arrays of a grid (see history.h for the layout).  A keyframe
+ *           blanks the cells and the table of elevations first.
+ *
+ * Input   : frame -- [in] the frame
+ *           grid  -- [in/out] the grid, holding the frame before unless the frame is a keyframe
+ *
+ * Returns : true if the record is sound
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+bool historyReader::decode(uint32_t frame, hexGrid* grid)
+{
+  uint16_t*    cellPlate = grid->plates();
+  uint8_t*     cellStyle = grid->styles();
+  float*       cellElevation = grid->elevations();
+  uint64_t     cntCells = grid->getCount();
+  recordReader record(m_file.data() + m_offsets[frame], m_lengths[frame]);
+  uint64_t     skip;
+  uint64_t     count;
+  uint64_t     id;
+  bool         bDamaged = false;
+
+  if (std::binary_search(m_keys.begin(), m_keys.end(), frame))
+  {
+    std::fill(cellPlate, cellPlate + cntCells, (uint16_t)0);
+    std::fill(cellStyle, cellStyle + cntCells, (uint8_t)0);
+    std::fill(cellElevation, cellElevation + cntCells, 0.0f);
+    m_table.clear();
+  }
+
+  if (!record.skip(sizeof(uint64_t) + m_cntPlates * 2 * sizeof(double_t))) return false;        // time, centers
+
+  auto nextRun = [&]()                                       // false at the end of the list, or if the run is damaged
+  {
+    bDamaged = !record.getVarint(&skip) || !record.getVarint(&count);
+    if (bDamaged || (count == 0)) return false;
+
+    bDamaged = (skip > cntCells - id) || (count > cntCells - id - skip);
+    if (bDamaged) return false;
+
+    id += skip;
+    return true;
+  };
+
+  for (id = 0; nextRun(); id += count)                       // plates
+  {
+    uint64_t plate;
+
+    if (!record.getVarint(&plate)) return false;
+    std::fill(cellPlate + id, cellPlate + id + count, (uint16_t)plate);
+  }
+  if (bDamaged) return false;
+
+  for (id = 0; nextRun(); id += count)                       // styles
+  {
+    uint8_t style;
+
+    if (!record.get(&style)) return false;
+    std::fill(cellStyle + id, cellStyle + id + count, style);
+  }
+  if (bDamaged) return false;
+
+  for (id = 0; nextRun(); id += count)                       // elevations
+  {
+    for (uint64_t ndx = id; ndx < id + count; ndx++)
+    {
+      uint64_t code;
+
+      if (!record.getVarint(&code) || (code > m_table.size())) return false;
+      if (code == 0)
+      {
+        if (!record.get(&cellElevation[ndx])) return false;
+        if (m_table.size() < maxCodes) m_table.push_back(cellElevation[ndx]);
+      }
+      else
+      {
+        cellElevation[ndx] = m_table[code - 1];
+      }
+    }
+  }
+  return !bDamaged;
+}
@@ -0,0 +1,146 @@
+/**********************************************************************************************************************
+ * Class    : historyWriter, historyReader
+ *
+ * Abstract : Records the time steps of the simulation into a history file (*.hst), so that a run can be looked at
+ *            again without running it again.  A full copy of the cells of every step would take tens of GB for a long
+ *            run, but a step only changes the cells along the plates that moved, so most steps are written as the
+ *            difference from the step before (a delta), and only some steps in full (a keyframe), so that a step can
+ *            be rebuilt from the keyframe before it without reading the whole file.  A keyframe is written every
+ *            keyInterval steps, or sooner once the deltas since the last keyframe add up to a few times its size, so
+ *            the cost of rebuilding a step stays about the same as the map gets busier.
+ *            The file is only ever appended to: a 64 byte header, then one record per step.  A run that is cut short
+ *            leaves a file that is good up to its last complete record.
+ *               header -- magic "TERRHST\x1a", format version, byte order mark (0x01020304 as written), header size,
+ *                         key interval, number of plates, then the grid: rows, columns, size and orientation, and the
+ *                         width and height of the image
+ *               record -- a 16 byte record header (tag of four characters, frame number, length of the payload in
+ *                         bytes), then the payload
+ *               DLTA   -- simulated time, the centers of the plates, then the cells that changed since the frame before,
+ *                         in three lists of runs of consecutive changed cells, one list per array.  A run is the number
+ *                         of unchanged cells skipped since the run before and the number of cells in the run, then:
+ *                            plates     -- the plate of the run, runs are of one plate
+ *                            styles     -- the style of the run (a byte), runs are of one style
+ *                            elevations -- the code of each cell of the run: n > 0 is the n-th distinct elevation
+ *                                          written since the keyframe, 0 is followed by a new elevation (a float)
+ *                         Counts, plates and codes are written as varints (7 bits a byte, low bits first), and a list
+ *                         ends with a run of no cells.
+ *               KEYF   -- the same as DLTA, from a blank frame (all cells 0) instead of the frame before
+ *            historyReader plays a history file back.  It maps the file (see mappedFile.h) and indexes the records
+ *            when it opens it, so any frame can be found without reading the ones before it: a frame is rebuilt from
+ *            the nearest keyframe at or before it and the deltas after that keyframe.
+ *            Going forward from the frame rebuilt last only applies the deltas in between.
+ *            Errors are logged and reported by returning false.
+ *
+ * History  : created Oct 2026 (gkhuber)
+ *            Oct 2026 (gkhuber) historyReader, the size of the image is kept in the header
+ *********************************************************************************************************************/
+
+#ifndef _history_h_
+#define _history_h_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <unordered_map>
+
+#include "constants.h"
+#include "mappedFile.h"
+
+class hexGrid;
+
+class historyWriter
+{
+public:
+  static const uint32_t version = 1;
+
+  historyWriter();
+  ~historyWriter();
+
+  bool     open(const std::string& path, const hexGrid& grid, double_t width, double_t height, uint32_t cntPlates, uint32_t keyInterval);
+  bool     append(const hexGrid& grid, const platesT* plates, uint64_t curTime);
+  void     close();
+
+  bool     isOpen() const { return m_file.is_open(); }
+  uint32_t getFrames() const { return m_cntFrames; }
+  uint64_t getBytes() const { return m_cntBytes; }
+
+private:
+  std::ofstream           m_file;
+  std::string             m_path;
+  uint32_t                m_keyInterval;
+  uint32_t                m_cntPlates;
+  uint32_t                m_cntFrames;          // frames written
+  uint32_t                m_cntKeys;            // of which keyframes
+  uint32_t                m_lastKey;            // frame of the last keyframe
+  uint64_t                m_keyBytes;           // size of the last keyframe
+  uint64_t                m_deltaBytes;         // size of the deltas written since
+  uint64_t                m_cntBytes;           // size of the file
+
+  // cells of the frame written last, the deltas are taken against them
+  std::vector<uint16_t>   m_plate;
+  std::vector<uint8_t>    m_style;
+  std::vector<float>      m_elevation;
+
+  std::unordered_map<uint32_t, uint32_t> m_codes;   // bits of an elevation => its code, see putElevation
+
+  std::vector<uint8_t>    m_buf;                // payload of the record being built
+
+  void     encodeDelta(const hexGrid& grid);
+  void     putElevation(float elevation);
+  bool     writeRecord(uint32_t tag);
+
+  historyWriter(const historyWriter&) = delete;
+  historyWriter& operator=(const historyWriter&) = delete;
+};
+
+
+
+class historyReader
+{
+public:
+  historyReader();
+  ~historyReader();
+
+  bool     open(const std::string& path);
+  void     close();
+  bool     seek(uint32_t frame, hexGrid* grid);
+
+  uint32_t getFrames() const { return (uint32_t)m_offsets.size(); }
+  uint64_t getTime(uint32_t frame) const { return m_times[frame]; }
+  uint32_t getPlates() const { return m_cntPlates; }
+  uint8_t  getOrient() const { return m_orient; }
+  double_t getSize() const { return m_size; }
+  uint32_t getRows() const { return m_rows; }
+  uint32_t getCols() const { return m_cols; }
+  double_t getWidth() const { return m_width; }
+  double_t getHeight() const { return m_height; }
+
+private:
+  mappedFile              m_file;
+  std::string             m_path;
+  uint32_t                m_cntPlates;
+  uint8_t                 m_orient;
+  double_t                m_size;
+  uint32_t                m_rows;
+  uint32_t                m_cols;
+  double_t                m_width;
+  double_t                m_height;
+
+  // index, built by 'open'
+  std::vector<uint64_t>   m_offsets;            // per frame, offset of the payload of its record
+  std::vector<uint64_t>   m_lengths;            // per frame, length of the payload
+  std::vector<uint64_t>   m_times;              // per frame, simulated time
+  std::vector<uint32_t>   m_keys;               // the keyframes, in order
+
+  std::vector<float>      m_table;              // elevations written since the keyframe, see historyWriter::putElevation
+  const hexGrid*          m_grid;               // grid the frame was rebuilt in last
+  uint32_t                m_frame;              // and that frame, noFrame if none
+
+  bool     decode(uint32_t frame, hexGrid* grid);
+
+  historyReader(const historyReader&) = delete;
+  historyReader& operator=(const historyReader&) = delete;
+};
+
+#endif
@@ -0,0 +1,519 @@
+
+#include "imageWriter.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <cstring>
+
+
+static const uint32_t adlerMod = 65521;
+static const size_t   flushBytes = 1 << 20;                  // size of an IDAT chunk
+
+// length codes 257 ... 285 of deflate, the smallest length of each and its number of extra bits
+static const uint16_t lengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115,
+                                         131, 163, 195, 227, 258 };
+static const uint8_t  lengthExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+
+
+static uint32_t crc32(const uint8_t* data, size_t len, uint32_t crc = 0)
+{
+  static uint32_t table[256] = { 0 };
+
+  if (table[1] == 0)
+  {
+    for (uint32_t n = 0; n < 256; n++)
+    {
+      uint32_t c = n;
+      for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+      table[n] = c;
+    }
+  }
+
+  crc = ~crc;
+  for (size_t ndx = 0; ndx < len; ndx++) crc = table[(crc ^ data[ndx]) & 0xFF] ^ (crc >> 8);
+  return ~crc;
+}
+
+
+static void putBE32(uint8_t* p, uint32_t v)
+{
+  p[0] = (uint8_t)(v >> 24);
+  p[1] = (uint8_t)(v >> 16);
+  p[2] = (uint8_t)(v >> 8);
+  p[3] = (uint8_t)v;
+}
+
+
+/**********************************************************************************************************************
+ * Function: filterSub
+ *
+ * Abstract: Replaces each byte of an RGB row with its difference from the same channel of the pixel to its left.  This
+ *           is the Sub filter of PNG and the horizontal predictor of TIFF.
+ *
+ * Input   : src -- [in] the row
+ *           dst -- [out] the filtered row, same length
+ *           len -- [in] length of the row in bytes
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+static void filterSub(const uint8_t* src, uint8_t* dst, size_t len)
+{
+  for (size_t ndx = 0; (ndx < 3) && (ndx < len); ndx++) dst[ndx] = src[ndx];
+  for (size_t ndx = 3; ndx < len; ndx++) dst[ndx] = (uint8_t)(src[ndx] - src[ndx - 3]);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// zlibEncoder
+
+/**********************************************************************************************************************
+ * Function: zlibEncoder
+ *
+ * Abstract: Starts a zlib stream: the two byte header (deflate, 32K window, no dictionary) and the header of the one
+ *           and only deflate block, which is marked final and uses the fixed Huffman codes.
+ *
+ * Input   : out -- [in] vector the compressed bytes are appended to
+ *
+ * Returns : none
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+zlibEncoder::zlibEncoder(std::vector<uint8_t>* out) : m_out(out), m_bits(0), m_cntBits(0), m_adlerA(1), m_adlerB(0), m_last(-1)
+{
+  m_out->push_back(0x78);
+  m_out->push_back(0x01);
+  putBits(1, 1);                                             // BFINAL
+  putBits(1, 2);                                             // BTYPE = fixed Huffman
+}
+
+
+/**********************************************************************************************************************
+ * Function: write
+ *
+ * Abstract: Compresses bytes.  A byte equal to the one before it starts a run, and runs of three or more are written
+ *           as a match at distance one; everything else is written as a literal.  Runs may continue across calls.
+ *
+ * Input   : data -- [in] bytes to compress
+ *           len  -- [in] number of bytes
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void zlibEncoder::write(const uint8_t* data, size_t len)
+{
+  size_t ndx = 0;
+
+  adler(data, len);
+
+  while (ndx < len)
+  {
+    if ((m_last >= 0) && (data[ndx] == (uint8_t)m_last))
+    {
+      size_t run = 1;
+      while ((ndx + run < len) && (run < 258) && (data[ndx + run] == (uint8_t)m_last)) run++;
+
+      if (run >= 3)
+      {
+        putRun((uint32_t)run);
+        ndx += run;
+        continue;
+      }
+    }
+
+    putLiteral(data[ndx]);
+    m_last = data[ndx];
+    ndx++;
+  }
+}
+
+
+void zlibEncoder::finish()
+{
+  putCode(0, 7);                                             // end of block, symbol 256
+  if (m_cntBits > 0) putBits(0, 8 - (m_cntBits % 8));        // pad to a byte
+
+  uint8_t trailer[4];
+  putBE32(trailer, (m_adlerB << 16) | m_adlerA);
+  m_out->insert(m_out->end(), trailer, trailer + 4);
+}
+
+
+void zlibEncoder::putBits(uint32_t value, uint32_t cnt)
+{
+  m_bits |= (uint64_t)value << m_cntBits;
+  m_cntBits += cnt;
+
+  while (m_cntBits >= 8)
+  {
+    m_out->push_back((uint8_t)m_bits);
+    m_bits >>= 8;
+    m_cntBits -= 8;
+  }
+}
+
+
+// Huffman codes are stored most significant bit first
+void zlibEncoder::putCode(uint32_t code, uint32_t cnt)
+{
+  uint32_t rev = 0;
+
+  for (uint32_t ndx = 0; ndx < cnt; ndx++) rev |= ((code >> ndx) & 1) << (cnt - 1 - ndx);
+  putBits(rev, cnt);
+}
+
+
+void zlibEncoder::putLiteral(uint32_t sym)
+{
+  if (sym < 144) putCode(0x30 + sym, 8);
+  else putCode(0x190 + (sym - 144), 9);
+}
+
+
+void zlibEncoder::putRun(uint32_t len)
+{
+  uint32_t code = 0;
+
+  while ((code + 1 < 29) && (lengthBase[code + 1] <= len)) code++;
+
+  uint32_t sym = 257 + code;
+  if (sym < 280) putCode(sym - 256, 7);
+  else putCode(0xC0 + (sym - 280), 8);
+
+  putBits(len - lengthBase[code], lengthExtra[code]);
+  putCode(0, 5);                                             // distance code 0, distance one
+}
+
+
+void zlibEncoder::adler(const uint8_t* data, size_t len)
+{
+  while (len > 0)
+  {
+    size_t cnt = std::min<size_t>(len, 5552);               // largest block that cannot overflow 32 bits
+
+    for (size_t ndx = 0; ndx < cnt; ndx++)
+    {
+      m_adlerA += data[ndx];
+      m_adlerB += m_adlerA;
+    }
+    m_adlerA %= adlerMod;
+    m_adlerB %= adlerMod;
+    data += cnt;
+    len -= cnt;
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// imageWriter
+
+/**********************************************************************************************************************
+ * Function: create
+ *
+ * Abstract: Creates the writer for the format given by the extension of a file name.
+ *
+ * Input   : path -- [in] name of the file
+ *
+ * Returns : pointer to a new writer, owned by the caller, or nullptr if the extension is not supported
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+imageWriter* imageWriter::create(const std::string& path)
+{
+  std::string ext = path.substr(path.find_last_of('.') + 1);
+
+  std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+
+  if (ext == "png") return new pngWriter;
+  if ((ext == "tif") || (ext == "tiff")) return new tiffWriter;
+
+  CLogger::getInstance()->outMsg(cmdLine, CLogger::level::ERR, "no image writer for '%s', use .png, .tif or .tiff", path.c_str());
+  return nullptr;
+}
+
+
+bool imageWriter::fail(const char* what)
+{
+  CLogger::getInstance()->outMsg(cmdLine, CLogger::level::ERR, "writing image %s: %s", m_path.c_str(), what);
+  m_bFailed = true;
+  m_file.close();
+  return false;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// pngWriter
+
+pngWriter::pngWriter() : m_encoder(nullptr)
+{
+
+}
+
+
+pngWriter::~pngWriter()
+{
+  delete m_encoder;
+}
+
+
+bool pngWriter::open(const std::string& path, uint32_t width, uint32_t height)
+{
+  static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+  uint8_t              header[13];
+
+  m_path = path;
+  m_width = width;
+  m_height = height;
+  m_row = 0;
+
+  if ((width == 0) || (height == 0) || (width > 0x7FFFFFFF / 3)) return fail("unsupported size");
+
+  m_file.open(path, std::ios::binary | std::ios::trunc);
+  if (!m_file) return fail("cannot create file");
+
+  putBE32(header, width);
+  putBE32(header + 4, height);
+  header[8] = 8;                                             // bits per channel
+  header[9] = 2;                                             // truecolor
+  header[10] = 0;                                            // deflate
+  header[11] = 0;                                            // adaptive filtering
+  header[12] = 0;                                            // not interlaced
+
+  m_file.write((const char*)signature, sizeof(signature));
+  writeChunk("IHDR", header, sizeof(header));
+
+  m_filtered.resize(1 + 3 * (size_t)width);
+  m_compressed.clear();
+  m_encoder = new zlibEncoder(&m_compressed);
+
+  return !m_file ? fail("write failed") : true;
+}
+
+
+/**********************************************************************************************************************
+ * Function: writeRows
+ *
+ * Abstract: Filters and compresses rows.  The compressed stream is written out as an IDAT chunk whenever it reaches
+ *           flushBytes, so the memory held does not depend on the size of the image.
+ *
+ * Input   : rgb     -- [in] the rows, 3 bytes per pixel
+ *           cntRows -- [in] number of rows
+ *
+ * Returns : true on success
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+bool pngWriter::writeRows(const uint8_t* rgb, uint32_t cntRows)
+{
+  if (m_bFailed || (nullptr == m_encoder)) return false;
+  if (m_row + cntRows > m_height) return fail("too many rows");
+
+  size_t stride = 3 * (size_t)m_width;
+
+  for (uint32_t ndx = 0; ndx < cntRows; ndx++)
+  {
+    m_filtered[0] = 1;                                       // filter type Sub
+    filterSub(rgb + ndx * stride, m_filtered.data() + 1, stride);
+    m_encoder->write(m_filtered.data(), m_filtered.size());
+
+    if (m_compressed.size() >= flushBytes)
+    {
+      writeChunk("IDAT", m_compressed.data(), m_compressed.size());
+      m_compressed.clear();
+    }
+  }
+  m_row += cntRows;
+
+  return !m_file ? fail("write failed") : true;
+}
+
+
+bool pngWriter::close()
+{
+  if (m_bFailed || (nullptr == m_encoder)) return false;
+  if (m_row != m_height) return fail("not all rows were written");
+
+  m_encoder->finish();
+  writeChunk("IDAT", m_compressed.data(), m_compressed.size());
+  writeChunk("IEND", nullptr, 0);
+
+  delete m_encoder;
+  m_encoder = nullptr;
+  m_compressed.clear();
+
+  m_file.close();
+  return !m_file ? fail("write failed") : true;
+}
+
+
+void pngWriter::writeChunk(const char* type, const uint8_t* data, size_t len)
+{
+  uint8_t  head[8];
+  uint8_t  tail[4];
+  uint32_t crc = crc32((const uint8_t*)type, 4);
+
+  if (len > 0) crc = crc32(data, len, crc);
+
+  putBE32(head, (uint32_t)len);
+  memcpy(head + 4, type, 4);
+  putBE32(tail, crc);
+
+  m_file.write((const char*)head, 8);
+  if (len > 0) m_file.write((const char*)data, len);
+  m_file.write((const char*)tail, 4);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// tiffWriter
+
+tiffWriter::tiffWriter() : m_encoder(nullptr)
+{
+
+}
+
+
+tiffWriter::~tiffWriter()
+{
+  delete m_encoder;
+}
+
+
+/**********************************************************************************************************************
+ * Function: open
+ *
+ * Abstract: Creates the file and writes the BigTIFF header.  The offset of the directory is not known until every
+ *           strip has been written, it is filled in by 'close'.
+ *
+ * Input   : path   -- [in] name of the file
+ *           width  -- [in] size of the image in pixels
+ *           height -- [in]
+ *
+ * Returns : true on success
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+bool tiffWriter::open(const std::string& path, uint32_t width, uint32_t height)
+{
+  static const uint8_t header[16] = { 'I', 'I', 43, 0, 8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+
+  m_path = path;
+  m_width = width;
+  m_height = height;
+  m_row = 0;
+
+  if ((width == 0) || (height == 0)) return fail("unsupported size");
+
+  m_file.open(path, std::ios::binary | std::ios::trunc);
+  if (!m_file) return fail("cannot create file");
+
+  m_file.write((const char*)header, sizeof(header));
+  m_filtered.resize(3 * (size_t)width);
+  m_offsets.clear();
+  m_sizes.clear();
+
+  return !m_file ? fail("write failed") : true;
+}
+
+
+bool tiffWriter::writeRows(const uint8_t* rgb, uint32_t cntRows)
+{
+  if (m_bFailed || !m_file.is_open()) return false;
+  if (m_row + cntRows > m_height) return fail("too many rows");
+
+  size_t stride = 3 * (size_t)m_width;
+
+  for (uint32_t ndx = 0; ndx < cntRows; ndx++)
+  {
+    if (nullptr == m_encoder)
+    {
+      m_compressed.clear();
+      m_encoder = new zlibEncoder(&m_compressed);
+    }
+
+    filterSub(rgb + ndx * stride, m_filtered.data(), stride);
+    m_encoder->write(m_filtered.data(), stride);
+
+    m_row++;
+    if ((m_row % rowsPerStrip == 0) || (m_row == m_height)) endStrip();
+  }
+
+  return !m_file ? fail("write failed") : true;
+}
+
+
+void tiffWriter::endStrip()
+{
+  m_encoder->finish();
+  delete m_encoder;
+  m_encoder = nullptr;
+
+  m_offsets.push_back((uint64_t)m_file.tellp());
+  m_sizes.push_back(m_compressed.size());
+  m_file.write((const char*)m_compressed.data(), m_compressed.size());
+  m_compressed.clear();
+}
+
+
+/**********************************************************************************************************************
+ * Function: close
+ *
+ * Abstract: Writes the strip tables and the image directory after the last strip, and points the header at the
+ *           directory.
+ *
+ * Input   : void
+ *
+ * Returns : true on success
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+bool tiffWriter::close()
+{
+  enum : uint16_t { SHORT = 3, LONG = 4, LONG8 = 16 };
+  struct entry { uint16_t tag; uint16_t type; uint64_t count; uint64_t value; };
+
+  if (m_bFailed || !m_file.is_open()) return false;
+  if (m_row != m_height) return fail("not all rows were written");
+
+  uint64_t cntStrips = m_offsets.size();
+  uint64_t offsetsAt = (uint64_t)m_file.tellp();
+  m_file.write((const char*)m_offsets.data(), cntStrips * sizeof(uint64_t));       // BigTIFF is little endian, like the hosts we run on
+  uint64_t sizesAt = (uint64_t)m_file.tellp();
+  m_file.write((const char*)m_sizes.data(), cntStrips * sizeof(uint64_t));
+  uint64_t ifdAt = (uint64_t)m_file.tellp();
+
+  const entry entries[] =
+  {
+    { 256, LONG, 1, m_width },                                              // ImageWidth
+    { 257, LONG, 1, m_height },                                             // ImageLength
+    { 258, SHORT, 3, 0x0000000800080008ull },                               // BitsPerSample 8, 8, 8
+    { 259, SHORT, 1, 8 },                                                   // Compression, deflate
+    { 262, SHORT, 1, 2 },                                                   // PhotometricInterpretation, RGB
+    { 273, LONG8, cntStrips, (cntStrips == 1) ? m_offsets[0] : offsetsAt },  // StripOffsets
+    { 277, SHORT, 1, 3 },                                                   // SamplesPerPixel
+    { 278, LONG, 1, rowsPerStrip },                                         // RowsPerStrip
+    { 279, LONG8, cntStrips, (cntStrips == 1) ? m_sizes[0] : sizesAt },     // StripByteCounts
+    { 284, SHORT, 1, 1 },                                                   // PlanarConfiguration, interleaved
+    { 317, SHORT, 1, 2 },                                                   // Predictor, horizontal differencing
+  };
+  uint64_t cntEntries = sizeof(entries) / sizeof(entries[0]);
+  uint64_t next = 0;
+
+  m_file.write((const char*)&cntEntries, 8);
+  for (const entry& e : entries)
+  {
+    m_file.write((const char*)&e.tag, 2);
+    m_file.write((const char*)&e.type, 2);
+    m_file.write((const char*)&e.count, 8);
+    m_file.write((const char*)&e.value, 8);
+  }
+  m_file.write((const char*)&next, 8);
+
+  m_file.seekp(8);
+  m_file.write((const char*)&ifdAt, 8);
+  m_file.close();
+
+  return !m_file ? fail("write failed") : true;
+}
@@ -0,0 +1,115 @@
+/**********************************************************************************************************************
+ * Class    : imageWriter
+ *
+ * Abstract : Writes an RGB image to disk a few rows at a time, so that images far larger than memory can be written:
+ *            only the rows handed to 'writeRows' are ever held.  The rows must be written top to bottom, and exactly
+ *            'height' of them in total before 'close'.  'create' picks the format from the extension of the file:
+ *               .png          -- pngWriter, a single IDAT stream; rows use the Sub filter,
+ *               .tif / .tiff  -- tiffWriter, a BigTIFF (so the file may pass 4GB) in strips of 64 rows, each strip a
+ *                                separate deflate stream with horizontal differencing (predictor 2).
+ *            Both formats are compressed by zlibEncoder, a small deflate encoder that only emits literals and runs of
+ *            a repeated byte with fixed Huffman codes.  That is nowhere near as tight as zlib on photographs, but after
+ *            the Sub filter the flat areas of a map become long runs of zeros, which it packs about a hundred to one.
+ *            Errors are logged and reported by returning false; a writer that failed ignores further calls.
+ *
+ * History  : created Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+
+#ifndef _imageWriter_h_
+#define _imageWriter_h_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <fstream>
+
+
+class zlibEncoder
+{
+public:
+  explicit zlibEncoder(std::vector<uint8_t>* out);
+
+  void write(const uint8_t* data, size_t len);
+  void finish();
+
+private:
+  std::vector<uint8_t>*   m_out;                // compressed bytes are appended here
+  uint64_t                m_bits;               // bits not yet written, least significant first
+  uint32_t                m_cntBits;
+  uint32_t                m_adlerA;
+  uint32_t                m_adlerB;
+  int32_t                 m_last;               // last byte written, -1 at the start of the stream
+
+  void putBits(uint32_t value, uint32_t cnt);
+  void putCode(uint32_t code, uint32_t cnt);
+  void putLiteral(uint32_t sym);
+  void putRun(uint32_t len);
+  void adler(const uint8_t* data, size_t len);
+};
+
+
+class imageWriter
+{
+public:
+  virtual ~imageWriter() {}
+
+  virtual bool open(const std::string& path, uint32_t width, uint32_t height) = 0;
+  virtual bool writeRows(const uint8_t* rgb, uint32_t cntRows) = 0;        // cntRows rows of 3 * width bytes
+  virtual bool close() = 0;
+
+  static imageWriter* create(const std::string& path);
+
+protected:
+  std::ofstream  m_file;
+  std::string    m_path;
+  uint32_t       m_width = 0;
+  uint32_t       m_height = 0;
+  uint32_t       m_row = 0;                     // rows written so far
+  bool           m_bFailed = false;
+
+  bool fail(const char* what);
+};
+
+
+class pngWriter : public imageWriter
+{
+public:
+  pngWriter();
+  ~pngWriter();
+
+  bool open(const std::string& path, uint32_t width, uint32_t height) override;
+  bool writeRows(const uint8_t* rgb, uint32_t cntRows) override;
+  bool close() override;
+
+private:
+  std::vector<uint8_t>  m_compressed;           // deflate output not yet written as an IDAT chunk
+  std::vector<uint8_t>  m_filtered;             // one filtered row
+  zlibEncoder*          m_encoder;
+
+  void writeChunk(const char* type, const uint8_t* data, size_t len);
+};
+
+
+class tiffWriter : public imageWriter
+{
+public:
+  tiffWriter();
+  ~tiffWriter();
+
+  bool open(const std::string& path, uint32_t width, uint32_t height) override;
+  bool writeRows(const uint8_t* rgb, uint32_t cntRows) override;
+  bool close() override;
+
+private:
+  static const uint32_t rowsPerStrip = 64;
+
+  std::vector<uint64_t> m_offsets;              // file offset and size of each strip
+  std::vector<uint64_t> m_sizes;
+  std::vector<uint8_t>  m_compressed;           // the strip being written
+  std::vector<uint8_t>  m_filtered;
+  zlibEncoder*          m_encoder;
+
+  void endStrip();
+};
+
+#endif
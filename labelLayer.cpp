@@ -0,0 +1,101 @@
+
+#include "labelLayer.h"
+
+#include <QPainter>
+#include <QPen>
+#include <QBrush>
+#include <QFontMetricsF>
+#include <QStyleOptionGraphicsItem>
+
+
+/**********************************************************************************************************************
+ * Function: labelLayer
+ *
+ * Abstract: Constructs the label layer and measures a label.  The font metrics are only needed here, paint uses the
+ *           cached size.
+ *
+ * Input   : grid -- [in] pointer to the grid model
+ *           p    -- [in] parent item
+ *
+ * Returns : none
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+labelLayer::labelLayer(const hexGrid* grid, QGraphicsItem* p) : graphicsLayer(p), m_grid(grid), m_width(0), m_height(0)
+{
+  QFontMetricsF fm(m_font);
+
+  m_labelWidth = fm.horizontalAdvance("4444");
+  m_labelHeight = fm.height();
+
+  setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);         // needed for option->exposedRect
+  gridChanged();
+}
+
+
+void labelLayer::gridChanged()
+{
+  double width, height;
+
+  prepareGeometryChange();
+
+  m_grid->cellSize(&m_width, &m_height);
+  m_grid->extent(&width, &height);
+  m_bounds = (m_grid->getCount() == 0) ? QRectF() : QRectF(0, 0, width, height).adjusted(-1, -1, 1, 1);
+
+  update();
+}
+
+
+/**********************************************************************************************************************
+ * Function: paint
+ *
+ * Abstract: Draws the center dots and the labels of the cells that overlap the exposed rectangle.  The zoom level is
+ *           taken from the painter, and decides first whether anything is drawn at all, so that a zoomed out view of
+ *           a large map costs nothing.  A label sits just above the center of its cell.
+ *
+ * Input   : painter -- [in] pointer to the painter to draw with
+ *           option  -- [in] style options, holds the exposed rectangle
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void labelLayer::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget*)
+{
+  if (m_bounds.isEmpty()) return;
+
+  double  lod = QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform());
+  bool    bDots = (m_width * lod >= minDotPixels);
+  bool    bLabels = (m_labelWidth < m_width - 5) && (m_labelHeight * lod >= minLabelPixels);
+
+  if (!bDots && !bLabels) return;
+
+  QRectF   exposed = (nullptr != option) ? option->exposedRect : m_bounds;
+  uint32_t rowFirst, rowLast, colFirst, colLast;
+
+  m_grid->cellRange(exposed.left(), exposed.top(), exposed.right(), exposed.bottom(), &rowFirst, &rowLast, &colFirst, &colLast);
+
+  painter->setPen(QPen(Qt::black));
+  painter->setBrush(QBrush(Qt::black, Qt::SolidPattern));
+  painter->setFont(m_font);
+
+  for (uint32_t row = rowFirst; row <= rowLast; row++)
+  {
+    for (uint32_t col = colFirst; col <= colLast; col++)
+    {
+      uint32_t id = row * m_grid->getCols() + col;
+      pointF   cell = m_grid->getCenter(id);
+      QPointF  center(cell.x(), cell.y());
+
+      if (bDots)
+        painter->drawEllipse(center, dotRadius, dotRadius);
+
+      if (bLabels)
+      {
+        QRectF rect(center.x() - 0.5 * m_labelWidth, center.y() - m_labelHeight - 3, m_labelWidth, m_labelHeight);
+        painter->drawText(rect, Qt::AlignRight | Qt::AlignVCenter, QString::number(id));
+      }
+    }
+  }
+}
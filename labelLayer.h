@@ -0,0 +1,48 @@
+#ifndef _labelLayer_h_
+#define _labelLayer_h_
+
+#include <QFont>
+#include <QRectF>
+
+#include "graphicsLayer.h"
+#include "hexGrid.h"
+
+
+/**********************************************************************************************************************
+ * Class    : labelLayer
+ *
+ * Abstract : The label layer of the map, a dot at the center of each cell and the id of the cell above it.  Nothing is
+ *            created per cell, the layer paints the dots and labels of the cells that overlap the exposed rectangle
+ *            (see hexGrid::cellRange), so the cost of the layer follows the size of the viewport and not the size of
+ *            the map.  Dots and labels are skipped altogether at zoom levels where they could not be read: a label is
+ *            only drawn if it fits inside its hexagon and is at least minLabelPixels tall on screen, and a dot only if
+ *            the hexagon is at least minDotPixels wide on screen.
+ *            The size of a label is measured once, when the layer is created; every label is four digits wide.
+ *
+ * History  : created Oct 2026 (gkhuber) replaces the ellipse and text items created per cell by genGrid
+ *********************************************************************************************************************/
+class labelLayer : public graphicsLayer
+{
+public:
+  labelLayer(const hexGrid* grid, QGraphicsItem* p = nullptr);
+
+  QRectF boundingRect() const override { return m_bounds; }
+  void   paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget*) override;
+
+  void   gridChanged();
+
+private:
+  static constexpr double minLabelPixels = 6.0;    // smallest legible label, in screen pixels
+  static constexpr double minDotPixels = 8.0;      // smallest hexagon, in screen pixels, that gets a center dot
+  static constexpr double dotRadius = 2.0;
+
+  const hexGrid*  m_grid;
+  QRectF          m_bounds;
+  double          m_width;                         // width of one hexagon
+  double          m_height;
+  QFont           m_font;
+  double          m_labelWidth;                    // size of a label, in scene units
+  double          m_labelHeight;
+};
+
+#endif
@@ -6,10 +6,14 @@
 #include <map>
 
 CLogger* CLogger::m_pThis = nullptr;
+thread_local CLogger* CLogger::m_pThread = nullptr;
 
 
 CLogger*  CLogger::getInstance()
 {
+  if (nullptr != m_pThread)
+    return m_pThread;
+
   if (nullptr == m_pThis)
     m_pThis = new CLogger;
 
@@ -24,6 +28,38 @@ void CLogger::delInstance()
 }
 
 
+/**********************************************************************************************************************
+ * Function: newThreadInstance
+ *
+ * Abstract: Gives the calling thread a logger of its own, replacing the one it uses.  The new logger has no output
+ *           functions and the default threshold; it is deleted by delThreadInstance, on the same thread.
+ *
+ * Input   : void
+ *
+ * Returns : the logger of the thread
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+CLogger* CLogger::newThreadInstance()
+{
+  m_pThread = new CLogger;
+  return m_pThread;
+}
+
+
+void CLogger::delThreadInstance()
+{
+  delete m_pThread;
+  m_pThread = nullptr;
+}
+
+
+void CLogger::setThreadInstance(CLogger* logger)
+{
+  m_pThread = logger;
+}
+
+
 void CLogger::regOutDevice(int nWhich, fnct callback)
 {
   std::pair<mapType::iterator, bool>   retPair;
@@ -72,7 +108,7 @@ void CLogger::outMsg(int nWhich, int level, const char* fmt, ...)
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // privae functions
-CLogger::CLogger() 
+CLogger::CLogger() : m_level(CLogger::level::INFO)
 {
 
 }
@@ -87,31 +123,33 @@ CLogger::~CLogger()
 // predefined output functions
 void cmdOut(int level, char* msg)
 {
+  const char* prefix = "";                            // one printf a line, so lines of different threads do not mix
+
   switch (level)
   {
     case CLogger::level::INFO:
-      printf("%s", "[INFO   ]:");
+      prefix = "[INFO   ]:";
       break;
     case CLogger::level::DEBUG:
-      printf("%s", "[DEBUG  ]:");
+      prefix = "[DEBUG  ]:";
       break;
     case CLogger::level::WARNING:
-      printf("%s", "[WARNING]:");
+      prefix = "[WARNING]:";
       break;
     case CLogger::level::ERR:
-      printf("%s", "[ERROR  ]:");
+      prefix = "[ERROR  ]:";
       break;
     case CLogger::level::FATAL:
-      printf("%s", "[FATAL  ]:");
+      prefix = "[FATAL  ]:";
       break;  
     case CLogger::level::NOTICE:
-      printf("%s", "[NOTICE ]:");
+      prefix = "[NOTICE ]:";
       break;
     case CLogger::level::SUCCESS:
-      printf("%s", "[SUCCESS]:");
+      prefix = "[SUCCESS]:";
       break;
   }
-  printf("%s\n", msg);
+  printf("%s%s\n", prefix, msg);
 }
 
 
@@ -133,32 +171,34 @@ void cmdOut(int level, char* msg)
  *********************************************************************************************************************/
 void cmdColorOut(int level, char* msg)
 {
+  const char* prefix = "";                            // one printf a line, so lines of different threads do not mix
+
   switch (level)
   {
   case CLogger::level::INFO:
-    printf("%s", "\033[36m[INFO   ]:");               // print info level in cyan
+    prefix = "\033[36m[INFO   ]:";                     // print info level in cyan
     break;
   case CLogger::level::DEBUG:
-    printf("%s", "[DEBUG  ]:");                       // print debug level in gray
+    prefix = "[DEBUG  ]:";                             // print debug level in gray
     break;
   case CLogger::level::WARNING:
-    printf("%s", "\033[33m[WARNING]:");               // print warning level in yellow
+    prefix = "\033[33m[WARNING]:";                     // print warning level in yellow
     break;
   case CLogger::level::ERR:
-    printf("%s", "\033[31m[ERROR  ]:");               // print error level in red
+    prefix = "\033[31m[ERROR  ]:";                     // print error level in red
     break;
   case CLogger::level::FATAL:
-    printf("%s", "\033[91m[FATAL  ]:");               // print fatal level in strong red
+    prefix = "\033[91m[FATAL  ]:";                     // print fatal level in strong red
     break;
   case CLogger::level::NOTICE:
-    printf("%s", "[NOTICE ]:");
+    prefix = "[NOTICE ]:";
     break;
   case CLogger::level::SUCCESS:
-    printf("%s", "\033[32m[SUCCESS]:");               // print success in green
+    prefix = "\033[32m[SUCCESS]:";                     // print success in green
     break;
   }
 
-  printf("%s\033[0m\n", msg);
+  printf("%s%s\033[0m\n", prefix, msg);
 
 
 
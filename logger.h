@@ -16,6 +16,11 @@
  *               (6) this class is implemented using a singleton pattern -- thus an application has one and only one
  *                   logger.
  *               (7) provides a simple command line output function ('cmdOut') 
+ *               (8) a thread can have a logger of its own ('newThreadInstance'), with its own threshold and output
+ *                   functions, which 'getInstance' returns on that thread instead of the application's logger.  So
+ *                   runs on different threads (see batchGen.h) do not share the state of a logger.  A thread can also
+ *                   use the logger of another thread ('setThreadInstance'), which is how the worker thread of a
+ *                   simulation logs to the logger of the thread that created the simulation.
  * 
  * History  : created May 2019 (gkhuber)
  *            Jun 2023 (gkhuber) added a 'NOTICE' level to the severity enumeration.  The idea is to have a severity 
@@ -29,6 +34,7 @@
  *                               (d) creaated a cmdColoOut output function that prints to the console with the 
  *                               correct prefix and also print the messages in color based on the severity of the 
  *                               message
+ *            Oct 2026 (gkhuber) loggers of a thread, the output functions print a line in one call
  *            
  *********************************************************************************************************************/
 
@@ -60,8 +66,11 @@ public:
 
   void setLevel(int l){m_level = l;}
 
-  static CLogger* getInstance();
+  static CLogger* getInstance();                    // the logger of the calling thread, or the application's
   static void     delInstance();
+  static CLogger* newThreadInstance();
+  static void     delThreadInstance();
+  static void     setThreadInstance(CLogger* logger);   // nullptr => the application's logger
 
 
   void     outMsg(int, int, const char*, ...);
@@ -73,6 +82,7 @@ private:
 
     int             m_level;
     static CLogger* m_pThis;
+    static thread_local CLogger* m_pThread;         // logger of the thread, if it has one
     mapType         m_mapCallbacks;  
 };
 
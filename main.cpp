@@ -1,8 +1,16 @@
 
 #include "constants.h"
+#ifndef TERRAINGEN_HEADLESS
 #include "terrainGen.h"
+#endif
 #include "console.h"
 #include "logger.h"
+#include "simulation.h"
+#include "batchGen.h"
+#include "mapExport.h"
+#include "worldFile.h"
+#include "hexGrid.h"
+#include "threadPool.h"
 
 #ifdef __WIN32
 #define WIN32_LEAN_AND_MEAN
@@ -13,10 +21,22 @@
 #endif
 
 #include <iostream>
+#include <algorithm>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#ifndef TERRAINGEN_HEADLESS
 #include <QApplication>
+#endif
 
 void showVersion(const char*);
 void showHelp(const char*);
+bool checkProps(const imageProps& props);
+int  generate(const imageProps& props, uint32_t seed, uint64_t timeStep, uint64_t maxTime, uint32_t checkpoint, const std::string& inFile,
+              const std::string& outFile);
+int  exportImage(const std::string& worldFile, const std::string& imageFile, uint32_t width);
 
 
 /*
@@ -34,9 +54,34 @@ int main(int argc, char** argv)
 	int choice = -1;
 	int ret = -1;
 
+	// headless generation, see generate
+	imageProps  props = {};
+	uint32_t    seed = std::random_device{}();
+	uint64_t    timeStep = 100000;
+	uint64_t    maxTime = 4500000000;
+	uint32_t    checkpoint = 0;
+	uint32_t    firstSeed = 0;                               // batch, see batchGen
+	uint32_t    cntSeeds = 0;
+	bool        bBatch = false;
+	std::string inFile;
+	std::string outFile;
+	std::string imageFile;                                   // export, see exportImage
+	uint32_t    imageWidth = 0;
+
+	props.imageWidth = 1024;                                 // the defaults of the GUI, see terrainGen::readSettings
+	props.imageHeight = 768;
+	props.hexagonSize = 18;
+	props.hexagonOrient = hexGrid::orien::VERTICAL;
+	props.cntPlates = 8;
+	for (int ndx = 0; ndx < nbrHarmonics; ndx++)
+	{
+		props.amplitude[ndx] = (float)pow((ndx + 1), (ndx));
+		props.frequency[ndx] = (float)pow((1.0 / (ndx + 1.0)), (ndx + 1));
+	}
+
 	allocConsole();
 
-	while (-1 != (choice = getopt(argc, argv, "dvh")))
+	while (-1 != (choice = getopt(argc, argv, "dvhg:l:c:b:e:w:W:H:s:o:p:S:t:T:")))
 	{
 		switch (choice)
 		{
@@ -44,13 +89,95 @@ int main(int argc, char** argv)
 
 			break;
 
+		case 'g':
+			outFile = optarg;
+			break;
+
+		case 'l':
+			inFile = optarg;
+			break;
+
+		case 'c':
+			checkpoint = (uint32_t)strtoul(optarg, nullptr, 10);
+			break;
+
+		case 'b':
+		{
+			char*              end = nullptr;
+			unsigned long long first = strtoull(optarg, &end, 10);
+			unsigned long long last = ('-' == *end) ? strtoull(end + 1, nullptr, 10) : first;
+			if ((end == optarg) || (last < first) || (last - first >= UINT32_MAX))       // the count of seeds must fit 32 bits
+			{
+				std::cout << "b needs a range of seeds n-m with n <= m and at most " << UINT32_MAX << " seeds, not " << optarg << std::endl;
+				showHelp(argv[0]);
+				return (1);
+			}
+			if (last > UINT32_MAX)
+			{
+				std::cout << "b needs seeds no greater than " << UINT32_MAX << ", not " << optarg << std::endl;
+				showHelp(argv[0]);
+				return (1);
+			}
+			firstSeed = (uint32_t)first;
+			cntSeeds = (uint32_t)(last - first + 1);
+			bBatch = true;
+			break;
+		}
+
+		case 'e':
+			imageFile = optarg;
+			break;
+
+		case 'w':
+			imageWidth = (uint32_t)strtoul(optarg, nullptr, 10);
+			if ((imageWidth == 0) || (imageWidth > (1u << 24)))
+			{
+				std::cout << "w needs a width between 1 and " << (1u << 24) << " pixels, not " << optarg << std::endl;
+				showHelp(argv[0]);
+				return (1);
+			}
+			break;
+
+		case 'W':
+			props.imageWidth = atof(optarg);
+			break;
+
+		case 'H':
+			props.imageHeight = atof(optarg);
+			break;
+
+		case 's':
+			props.hexagonSize = atof(optarg);
+			break;
+
+		case 'o':
+			props.hexagonOrient = ((optarg[0] == 'h') || (optarg[0] == 'H')) ? hexGrid::orien::HORIZONTAL : hexGrid::orien::VERTICAL;
+			break;
+
+		case 'p':
+			props.cntPlates = (uint32_t)strtoul(optarg, nullptr, 10);
+			break;
+
+		case 'S':
+			seed = (uint32_t)strtoul(optarg, nullptr, 10);
+			break;
+
+		case 't':
+			timeStep = strtoull(optarg, nullptr, 10);
+			break;
+
+		case 'T':
+			maxTime = strtoull(optarg, nullptr, 10);
+			break;
+
 		case 'v':
 			showVersion(argv[0]);
 			return(0);
 
-		case '?':
-			std::cout << "Unknown command line option " << optarg[optind] << std::endl;
-			[[fallthrough]];
+		case '?':                                            // getopt has named the option already, optarg is not set
+			showHelp(argv[0]);
+			return (1);
+
 		case 'h':
 
 			showHelp(argv[0]);
@@ -58,17 +185,55 @@ int main(int argc, char** argv)
 		}
 	}
 
+	if (!outFile.empty() && inFile.empty() && !checkProps(props))
+	{
+		showHelp(argv[0]);
+		return (1);
+	}
+
+	if (!imageFile.empty() && (outFile.empty() || bBatch))
+	{
+		std::cout << "e exports the world generated with g, it cannot be used alone or with b" << std::endl;
+		showHelp(argv[0]);
+		return (1);
+	}
+
 	CLogger* pLogger = CLogger::getInstance();
 	pLogger->regOutDevice(cmdLine, cmdColorOut);
 	pLogger->setLevel(CLogger::level::INFO);
 	pLogger->outMsg(cmdLine, CLogger::level::SUCCESS, "initialized logging engine");
 
+	if (!outFile.empty() && bBatch)                          // a world per seed, side by side
+	{
+		batchGen batch(props, timeStep, maxTime, outFile);
+
+		ret = (batch.run(firstSeed, cntSeeds) && (batch.getFailed() == 0)) ? 0 : 1;
+
+		pLogger->delInstance();
+		deallocConsole();
+		return ret;
+	}
+	else if (!outFile.empty())                               // no window, no scene, just the simulation
+	{
+		ret = generate(props, seed, timeStep, maxTime, checkpoint, inFile, outFile);
+		if ((ret == 0) && !imageFile.empty()) ret = exportImage(outFile, imageFile, imageWidth);
+
+		pLogger->delInstance();
+		deallocConsole();
+		return ret;
+	}
+
+#ifdef TERRAINGEN_HEADLESS
+	showHelp(argv[0]);                                       // built without the GUI, there is nothing to show
+	ret = 1;
+#else
 	QApplication a(argc, argv);
 
 	terrainGen   mainWindow;
 	mainWindow.show();
 
 	ret = a.exec();
+#endif
 
 	pLogger->outMsg(cmdLine, CLogger::level::SUCCESS, "shutting down logging engine");
 	pLogger->delInstance();
@@ -77,6 +242,61 @@ int main(int argc, char** argv)
 	return ret;
 }
 
+/**********************************************************************************************************************
+ * Function: checkProps
+ *
+ * Abstract: Checks the map asked for on the command line before anything is generated: the map and the hexagons must
+ *           have a size, the grid must have at least one cell and fewer than noCell, the map must be wider and higher
+ *           than twice the margin of the plate centers (see simulation::centerMargin), and there must be between 1
+ *           and min(65535, cells) plates (a cell holds its plate in 16 bits).
+ *
+ * Input   : props -- [in] the properties of the map
+ *
+ * Returns : true if a world can be generated, false otherwise (the reason is printed)
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+bool checkProps(const imageProps& props)
+{
+	uint32_t rows = 0;
+	uint32_t cols = 0;
+
+	if (!(props.imageWidth > 0) || !(props.imageHeight > 0) || !(props.hexagonSize > 0))
+	{
+		std::cout << "the width, height (W, H) and hexagon size (s) must be greater than 0" << std::endl;
+		return false;
+	}
+
+	if ((props.imageWidth / props.hexagonSize < 2E9) && (props.imageHeight / props.hexagonSize < 2E9))     // rows and columns fit 32 bits
+		hexGrid::dimensions(props.hexagonOrient, props.hexagonSize, props.imageWidth, props.imageHeight, &rows, &cols);
+
+	uint64_t cells = (uint64_t)rows * cols;
+	if ((cells == 0) || (cells >= noCell))
+	{
+		std::cout << "a map of " << props.imageWidth << " x " << props.imageHeight << " with hexagons of size " << props.hexagonSize
+		          << " has no cells, or too many" << std::endl;
+		return false;
+	}
+
+	double margin = simulation::centerMargin(props.hexagonOrient, props.hexagonSize);
+	if ((props.imageWidth <= 2 * margin) || (props.imageHeight <= 2 * margin))
+	{
+		std::cout << "the width and height (W, H) must be greater than " << 2 * margin << ", the plate centers keep " << margin
+		          << " from the edges" << std::endl;
+		return false;
+	}
+
+	if ((props.cntPlates < 1) || (props.cntPlates > 65535) || (props.cntPlates > cells))
+	{
+		std::cout << "the number of plates (p) must be between 1 and " << std::min<uint64_t>(65535, cells) << " for " << cells << " cells"
+		          << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+
 void showVersion(const char* name)
 {
 	std::cout << name << " A procedural terrain generator, based on plat tectonics.  Version " << static_cast<int>(MAJOR) << "." << static_cast<int>(MINOR) << "." << static_cast<int>(PATCH) << std::endl;
@@ -99,5 +319,105 @@ void showHelp(const char* name)
 	std::cout << "Usage: " << name << " [options]  \nThe options are:" << std::endl;
 	std::cout << "v             displays program version, and then exits" << std::endl;
 	std::cout << "h             displays a short usage screen (this screen) and then exits" << std::endl;
+	std::cout << "g <file>      generates a world without the GUI and writes it to <file> (a terrain file)" << std::endl;
+	std::cout << "l <file>      with g, carries on from the world in <file> instead of a new one (e.g. a checkpoint)" << std::endl;
+	std::cout << "c <seconds>   with g, saves a checkpoint to <file>.checkpoint every <seconds>, for l after a crash" << std::endl;
+	std::cout << "b <n>-<m>     with g, generates a world for each seed from n to m, on all cores, to <file><seed>.ter," << std::endl;
+	std::cout << "              with a summary of the worlds in <file>summary.csv" << std::endl;
+	std::cout << "e <image>     with g, exports the plates of the world as <image>, .png or .tif" << std::endl;
+	std::cout << "w <pixels>    with e, width of the exported image (the width of the map)" << std::endl;
+	std::cout << "W <width>     with g, width of the image (1024)" << std::endl;
+	std::cout << "H <height>    with g, height of the image (768)" << std::endl;
+	std::cout << "s <size>      with g, size of a hexagon (18)" << std::endl;
+	std::cout << "o <v|h>       with g, orientation of the hexagons, vertical or horizontal (v)" << std::endl;
+	std::cout << "p <plates>    with g, number of plates (8)" << std::endl;
+	std::cout << "S <seed>      with g, seed of the random number generator (random)" << std::endl;
+	std::cout << "t <years>     with g, length of a time step (100000)" << std::endl;
+	std::cout << "T <years>     with g, time at which the run ends (4500000000)" << std::endl;
+
+}
 
-}
\ No newline at end of file
+
+/**********************************************************************************************************************
+ * Function: generate
+ *
+ * Abstract: Generates a world without the GUI: runs the whole pipeline (grid, centers, plates, motion, time steps) on
+ *           the simulation thread and writes the result as a terrain file.  No widget or scene item is created, so the
+ *           run starts as soon as the simulation thread does.  A world loaded from a file carries on from the stage
+ *           and time it was saved at.
+ *
+ * Input   : props      -- [in] properties of the image, ignored when a world is loaded
+ *           seed       -- [in] seed of the random number generator, ignored when a world is loaded
+ *           timeStep   -- [in] length of a time step in years
+ *           maxTime    -- [in] time at which the run ends, in years
+ *           checkpoint -- [in] seconds between checkpoints (see simulation::checkpoint), 0 for none
+ *           inFile     -- [in] world to carry on from, empty for a new one
+ *           outFile    -- [in] terrain file written
+ *
+ * Returns : 0 if the world was written, 1 otherwise
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+int generate(const imageProps& props, uint32_t seed, uint64_t timeStep, uint64_t maxTime, uint32_t checkpoint, const std::string& inFile,
+             const std::string& outFile)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	CLogger*   pLogger = CLogger::getInstance();
+	simulation sim(0, seed);
+
+	if (!inFile.empty())
+	{
+		if (!sim.load(inFile)) return 1;
+	}
+	else
+		sim.newMap(props);
+
+	if (checkpoint > 0) sim.checkpoint(outFile + ".checkpoint", checkpoint);
+	sim.run(props.cntPlates, timeStep, maxTime);
+	if (!sim.save(outFile)) return 1;                        // queued behind the run, so waits for it
+
+	sim.acquire();
+	const simSnapshot& snap = sim.snapshot();
+
+	long long elapsed = (long long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+	pLogger->outMsg(cmdLine, CLogger::level::SUCCESS, "generated %s: seed %u, %d plates, %llu years, %lld ms", outFile.c_str(), sim.getSeed(),
+	                (int)snap.plates.size(), (unsigned long long)snap.curTime, elapsed);
+	return 0;
+}
+
+/**********************************************************************************************************************
+ * Function: exportImage
+ *
+ * Abstract: Exports a world written by generate as an image of its plates (see mapExport), without the GUI.  The world
+ *           is read back from its file, as the simulation keeps its grid to itself.
+ *
+ * Input   : worldFile -- [in] terrain file to export
+ *           imageFile -- [in] image written, the extension picks the format (.png, .tif)
+ *           width     -- [in] width of the image in pixels, 0 for the width of the map; the height keeps its aspect
+ *
+ * Returns : 0 if the image was written, 1 otherwise
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+int exportImage(const std::string& worldFile, const std::string& imageFile, uint32_t width)
+{
+	worldState            state;
+	hexGrid               grid;
+	std::vector<uint32_t> palette(1, 0xFF000000);            // indexed by plate, 0 = no plate
+
+	if (!worldFile::read(worldFile, &state, &grid)) return 1;
+
+	palette.resize(state.plates.size() + 1, 0xFF000000);
+	for (const platesT& plate : state.plates)
+		if (plate.ndx < palette.size()) palette[plate.ndx] = plate.color;
+
+	if (width == 0) width = (uint32_t)std::max(1L, std::lround(state.props.imageWidth));
+
+	threadPool pool;
+	mapExport  exporter(&grid, &palette, &pool);
+
+	if (!exporter.write(imageFile, state.props, width)) return 1;
+
+	CLogger::getInstance()->outMsg(cmdLine, CLogger::level::SUCCESS, "exported %s to %s", worldFile.c_str(), imageFile.c_str());
+	return 0;
+}
@@ -1,5 +1,8 @@
 #include "mapDisplay.h"
 #include "terrainGen.h"
+#include "hexGrid.h"
+#include "hexLayer.h"
+#include "logger.h"
 
 #include <QGraphicsView>
 #include <QMouseEvent>
@@ -8,12 +11,33 @@
 
 mapDisplay::mapDisplay(QWidget* p) : QGraphicsView(p)
 {
-  
+	setupView();
 }
 
 mapDisplay::mapDisplay(QGraphicsScene* scene, QWidget* p) : QGraphicsView(p)
 {
+	setupView();
+}
+
 
+/**********************************************************************************************************************
+* function  : setupView
+*
+* abstract  : Settings shared by the constructors.  The layers choose how much detail to draw from the view transform,
+*             so zooming keeps the point under the cursor fixed, and the layers never draw outside their bounding
+*             rectangles so the view does not have to pad the exposed area for antialiasing.
+*
+* parameters: void
+*
+* retuns    : void
+*
+* written   : Oct 2026 (gkhuber)
+**********************************************************************************************************************/
+void mapDisplay::setupView()
+{
+	setTransformationAnchor(QGraphicsView::AnchorUnderMouse);
+	setOptimizationFlag(QGraphicsView::DontAdjustForAntialiasing, true);
+	setViewportUpdateMode(QGraphicsView::SmartViewportUpdate);
 }
 
 mapDisplay::~mapDisplay()
@@ -49,8 +73,9 @@ void mapDisplay::contextMenuEvent(QContextMenuEvent*)
 *
 * abstract  : This handles operations with the mouse wheel.  An unmodified wheel event causes the immage to scroll
 *             veritcally (the default behavior).  If the control (CTRL) button is held down, then the image is zoomed
-*             either in or out based on the direction of the scroll wheel turning.  Finally, if the alternate key (ALT)
-*             is held down we scroll either left or right.
+*             either in or out based on the direction of the scroll wheel turning, and the zoom and the level of detail
+*             the grid is drawn at (see hexLayer::detailFor) are shown in the status bar.  Finally, if the alternate key
+*             (ALT) is held down we scroll either left or right.
 *
 * parameters:
 *
@@ -75,6 +100,16 @@ void mapDisplay::wheelEvent(QWheelEvent* evt)
 	{
 		if (deltaY > 0) scale(zoomFactor, zoomFactor);
 		else scale(1 / zoomFactor, 1 / zoomFactor);
+
+		if (nullptr != m_pMainWnd)
+		{
+			static const char* detailName[] = { "outlines", "filled cells", "raster" };
+			double   width, height;
+			double   lod = transform().m11();
+
+			m_pMainWnd->getGrid().cellSize(&width, &height);
+			m_pMainWnd->statusBar()->showMessage(QString("zoom %1%, drawing %2").arg(qRound(100 * lod)).arg(detailName[hexLayer::detailFor(width * lod)]));
+		}
 	}
 	else
 	{
@@ -103,8 +138,10 @@ void mapDisplay::mouseMoveEvent(QMouseEvent* evt)
 	const int margin = 20;                                  // margin width in pixels
 
 	QPointF   sceneLoc = mapToScene(evt->pos());
+	uint32_t  cellID = m_pMainWnd->getGrid().cellAt(pointF(sceneLoc.x(), sceneLoc.y()));
 
 	QString strStatus = QString("cursor at %1, %2").arg(sceneLoc.x()).arg(sceneLoc.y());
+	if (cellID != noCell) strStatus += QString("  cell %1").arg(cellID);
 	m_pMainWnd->statusBar()->showMessage(strStatus);
 
 
@@ -113,16 +150,33 @@ void mapDisplay::mouseMoveEvent(QMouseEvent* evt)
 /**********************************************************************************************************************
 * function  : mousePressEvent
 *
-* abstract  :
+* abstract  : A left click picks the grid cell under the cursor, the cell is found with hexGrid::cellAt and reported in
+*             the status bar and the log.
 *
-* parameters:
+* parameters: evt -- [in] pointer to the mouse event
 *
-* retuns    :
+* retuns    : void
 *
 * written   : Feb2025 (gkhuber)
 **********************************************************************************************************************/
 void mapDisplay::mousePressEvent(QMouseEvent* evt)
 {
+	if (Qt::LeftButton == evt->button())
+	{
+		const hexGrid& grid = m_pMainWnd->getGrid();
+		QPointF        sceneLoc = mapToScene(evt->pos());
+		uint32_t       cellID = grid.cellAt(pointF(sceneLoc.x(), sceneLoc.y()));
+
+		if (cellID != noCell)
+		{
+			uint32_t row = cellID / grid.getCols();
+			uint32_t col = cellID % grid.getCols();
+
+			m_pMainWnd->statusBar()->showMessage(QString("selected cell %1 (row %2, col %3)").arg(cellID).arg(row).arg(col));
+			CLogger::getInstance()->outMsg(cmdLine, CLogger::level::INFO, "selected cell %d (row %d, col %d)", cellID, row, col);
+		}
+	}
+
 	QGraphicsView::mousePressEvent(evt);
 }
 
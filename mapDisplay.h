@@ -19,6 +19,7 @@ public:
 	void setMainWndPtr(QMainWindow*);
 
 protected:
+	void setupView();
 	void contextMenuEvent(QContextMenuEvent*);
 	void mouseMoveEvent(QMouseEvent*);
 	void mousePressEvent(QMouseEvent*);
@@ -0,0 +1,86 @@
+
+#include "mapExport.h"
+#include "imageWriter.h"
+#include "hexGrid.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+
+mapExport::mapExport(const hexGrid* grid, const std::vector<uint32_t>* palette, threadPool* pool) : m_grid(grid), m_renderer(grid, palette, pool),
+                     m_background(0xFFFFFFFF)
+{
+  m_renderer.setMode(mapRenderer::mode::PLATES);
+}
+
+
+/**********************************************************************************************************************
+ * Function: write
+ *
+ * Abstract: Renders the map and streams it to a file, a strip at a time.  Each strip covers the full width of the
+ *           map and stripRows rows of pixels; the last strip may be shorter.
+ *
+ * Input   : path     -- [in] name of the file, the extension picks the format
+ *           props    -- [in] properties of the map, the grid must have been built from them
+ *           width    -- [in] size of the image in pixels
+ *           height   -- [in] 0 to keep the aspect ratio of the map
+ *           progress -- [in] called after each strip with the rows written and the height, may be nullptr
+ *
+ * Returns : true if the image was written
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+bool mapExport::write(const std::string& path, const imageProps& props, uint32_t width, uint32_t height, std::function<void(uint32_t, uint32_t)> progress)
+{
+  if ((m_grid->getCount() == 0) || (m_grid->getOrient() != props.hexagonOrient) || (m_grid->getSize() != props.hexagonSize))
+  {
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::ERR, "export: the grid was not built from the image properties");
+    return false;
+  }
+
+  if (height == 0) height = (uint32_t)std::lround(width * props.imageHeight / props.imageWidth);
+  if ((width == 0) || (height == 0) || (width > INT32_MAX) || (height > INT32_MAX))
+  {
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::ERR, "export: empty or too large image (%u x %u)", width, height);
+    return false;
+  }
+
+  std::unique_ptr<imageWriter> writer(imageWriter::create(path));
+  if (!writer || !writer->open(path, width, height)) return false;
+
+  uint32_t              stripRows = (uint32_t)std::clamp<uint64_t>(stripBytes / (4ull * width), 1, height);
+  double                scaleY = props.imageHeight / height;                  // scene units per row of pixels
+  std::vector<uint32_t> strip((size_t)width * stripRows);                     // premultiplied 0xAARRGGBB
+  std::vector<uint8_t>  rgb(3ull * width * stripRows);
+
+  m_renderer.setBackground(m_background);
+  CLogger::getInstance()->outMsg(cmdLine, CLogger::level::INFO, "exporting %u x %u image to %s, %u rows per strip", width, height, path.c_str(), stripRows);
+
+  for (uint32_t row = 0; row < height; row += stripRows)
+  {
+    uint32_t cntRows = std::min(stripRows, height - row);
+
+    m_renderer.render({ strip.data(), (int)width, (int)stripRows, (int)width }, { 0, row * scaleY, props.imageWidth, stripRows * scaleY },
+                      { 0, 0, (int)width, (int)cntRows });
+
+    for (uint64_t ndx = 0; ndx < (uint64_t)width * cntRows; ndx++)
+    {
+      uint32_t px = strip[ndx];
+      uint32_t a = px >> 24;
+      uint8_t* out = &rgb[3 * ndx];
+
+      for (int ch = 0; ch < 3; ch++)                                          // undo the premultiplication
+      {
+        uint32_t c = (px >> (16 - 8 * ch)) & 0xFF;
+        out[ch] = (uint8_t)((a == 255) ? c : (a == 0) ? 0 : std::min<uint32_t>(255, (c * 255 + a / 2) / a));
+      }
+    }
+
+    if (!writer->writeRows(rgb.data(), cntRows)) return false;
+    if (progress) progress(row + cntRows, height);
+  }
+
+  return writer->close();
+}
@@ -0,0 +1,48 @@
+/**********************************************************************************************************************
+ * Class    : mapExport
+ *
+ * Abstract : Exports the map as one large image, PNG or TIFF (see imageWriter).  The image is rendered by a mapRenderer
+ *            and written one horizontal strip at a time: a strip is rendered on the thread pool, converted to RGB and
+ *            handed to the writer, and the same strip buffer is reused for the next one.  The memory used is that of
+ *            one strip (about stripBytes) whatever the size of the image, so posters far larger than memory can be
+ *            exported.  Nothing here needs the scene or the GUI, so the command line exports too (main.cpp, -e).
+ *            The image covers the map described by the imageProps (imageWidth x imageHeight scene units), which must
+ *            be the properties the grid was built from.
+ *
+ * History  : created Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+
+#ifndef _mapExport_h_
+#define _mapExport_h_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <functional>
+
+#include "constants.h"
+#include "mapRenderer.h"
+
+class hexGrid;
+class threadPool;
+
+class mapExport
+{
+public:
+  mapExport(const hexGrid* grid, const std::vector<uint32_t>* palette, threadPool* pool = nullptr);
+
+  void setMode(uint8_t mode) { m_renderer.setMode(mode); }
+  void setBackground(uint32_t bg) { m_background = bg; }
+
+  bool write(const std::string& path, const imageProps& props, uint32_t width, uint32_t height = 0,
+             std::function<void(uint32_t, uint32_t)> progress = nullptr);
+
+private:
+  static const uint64_t stripBytes = 64ull << 20;   // memory used by the strip buffer
+
+  const hexGrid*  m_grid;
+  mapRenderer     m_renderer;
+  uint32_t        m_background;           // 0xAARRGGBB
+};
+
+#endif
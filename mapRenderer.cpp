@@ -0,0 +1,278 @@
+
+#include "mapRenderer.h"
+#include "hexGrid.h"
+#include "threadPool.h"
+#include "constants.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+static inline uint32_t argb(uint32_t r, uint32_t g, uint32_t b, uint32_t a = 255) { return (a << 24) | (r << 16) | (g << 8) | b; }
+
+static inline uint32_t premultiply(uint32_t px)
+{
+  uint32_t a = px >> 24;
+
+  if (a == 255) return px;
+  auto mul = [a](uint32_t c) { return (c * a + 127) / 255; };
+  return argb(mul((px >> 16) & 0xFF), mul((px >> 8) & 0xFF), mul(px & 0xFF), a);
+}
+
+
+mapRenderer::mapRenderer(const hexGrid* grid, const std::vector<uint32_t>* palette, threadPool* pool) : m_grid(grid), m_palette(palette), m_pool(pool),
+                         m_mode(mapRenderer::mode::STYLE), m_background(0)
+{
+
+}
+
+
+/**********************************************************************************************************************
+ * Function: render
+ *
+ * Abstract: Redraws part of an image.  The whole image covers 'scene', only the pixels inside 'pixels' are written.
+ *           The pixels are cut into tiles which are handed to the thread pool; a small region is a single tile and is
+ *           drawn on the calling thread.
+ *
+ * Input   : image  -- [in/out] image to draw into, premultiplied 0xAARRGGBB pixels
+ *           scene  -- [in] rectangle of the scene covered by the whole image
+ *           pixels -- [in] region of the image to draw
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void mapRenderer::render(const rasterT& image, const sceneRectT& scene, const pixelRectT& pixels) const
+{
+  int left = std::max(pixels.left, 0);
+  int top = std::max(pixels.top, 0);
+  int right = std::min(pixels.left + pixels.width, image.width);           // one past the region
+  int bottom = std::min(pixels.top + pixels.height, image.height);
+
+  if ((left >= right) || (top >= bottom)) return;
+
+  std::vector<uint32_t> colors;
+  buildColors(&colors);
+
+  int      cntX = (right - left + tileSize - 1) / tileSize;
+  int      cntY = (bottom - top + tileSize - 1) / tileSize;
+  uint64_t cntTiles = (uint64_t)cntX * cntY;
+
+  auto drawTiles = [&](uint64_t begin, uint64_t end)
+  {
+    for (uint64_t ndx = begin; ndx < end; ndx++)
+    {
+      int x = left + (int)(ndx % cntX) * tileSize;
+      int y = top + (int)(ndx / cntX) * tileSize;
+
+      renderTile(image, scene, { x, y, std::min(tileSize, right - x), std::min(tileSize, bottom - y) }, colors);
+    }
+  };
+
+  if ((nullptr != m_pool) && (cntTiles > 1))
+    m_pool->parallelFor(cntTiles, 1, drawTiles);
+  else
+    drawTiles(0, cntTiles);
+}
+
+
+/**********************************************************************************************************************
+ * Function: elevationColor
+ *
+ * Abstract: Maps an elevation to a color, dark to light blue below sea level, then green, brown and white above.
+ *
+ * Input   : elevation -- [in] elevation in meters
+ *
+ * Returns : opaque color
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+uint32_t mapRenderer::elevationColor(float elevation)
+{
+  struct stop { float elev; int r, g, b; };
+  static const stop ramp[] = { { -6000.0f, 0, 0, 96 }, { 0.0f, 64, 128, 255 }, { 0.0f, 34, 139, 34 }, { 2000.0f, 139, 90, 43 },
+                               { 5000.0f, 255, 255, 255 } };
+  static const int  cntStops = sizeof(ramp) / sizeof(ramp[0]);
+
+  if (elevation <= ramp[0].elev) return argb(ramp[0].r, ramp[0].g, ramp[0].b);
+
+  for (int ndx = 1; ndx < cntStops; ndx++)
+  {
+    if ((elevation < ramp[ndx].elev) || ((elevation == ramp[ndx].elev) && (elevation < 0)))
+    {
+      const stop& lo = ramp[ndx - 1];
+      const stop& hi = ramp[ndx];
+      float       t = (elevation - lo.elev) / (hi.elev - lo.elev);
+
+      return argb(lo.r + (int)(t * (hi.r - lo.r)), lo.g + (int)(t * (hi.g - lo.g)), lo.b + (int)(t * (hi.b - lo.b)));
+    }
+  }
+
+  return argb(ramp[cntStops - 1].r, ramp[cntStops - 1].g, ramp[cntStops - 1].b);
+}
+
+
+/**********************************************************************************************************************
+ * Function: downsample
+ *
+ * Abstract: Scales an image down by half into part of another, each pixel is the average of the 2x2 pixels under it
+ *           (pixels past the edge of the source count as transparent).  The colors are premultiplied by alpha so a
+ *           plain average blends them correctly.  Used to build image pyramids.
+ *
+ * Input   : src  -- [in] image to scale down, premultiplied 0xAARRGGBB pixels
+ *           dst  -- [in/out] image to write into, same format
+ *           left -- [in] position in dst of the top left corner of the scaled image
+ *           top  -- [in]
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber) -- moved here from hexLayer::buildLevels
+ *********************************************************************************************************************/
+void mapRenderer::downsample(const rasterT& src, const rasterT& dst, int left, int top)
+{
+  int width = std::min((src.width + 1) / 2, dst.width - left);
+  int height = std::min((src.height + 1) / 2, dst.height - top);
+
+  for (int y = 0; y < height; y++)
+  {
+    const uint32_t* line0 = src.bits + (size_t)(2 * y) * src.stride;
+    const uint32_t* line1 = (2 * y + 1 < src.height) ? line0 + src.stride : nullptr;
+    uint32_t*       out = dst.bits + (size_t)(top + y) * dst.stride + left;
+
+    for (int x = 0; x < width; x++)
+    {
+      uint32_t px[4] = { line0[2 * x], 0, 0, 0 };
+      uint32_t sum[4] = { 0, 0, 0, 0 };
+
+      if (2 * x + 1 < src.width) px[1] = line0[2 * x + 1];
+      if (nullptr != line1) px[2] = line1[2 * x];
+      if ((nullptr != line1) && (2 * x + 1 < src.width)) px[3] = line1[2 * x + 1];
+
+      for (uint32_t p : px)
+      {
+        sum[0] += p >> 24;
+        sum[1] += (p >> 16) & 0xFF;
+        sum[2] += (p >> 8) & 0xFF;
+        sum[3] += p & 0xFF;
+      }
+      out[x] = argb((sum[1] + 2) / 4, (sum[2] + 2) / 4, (sum[3] + 2) / 4, (sum[0] + 2) / 4);
+    }
+  }
+}
+
+
+void mapRenderer::buildColors(std::vector<uint32_t>* colors) const
+{
+  colors->clear();
+  if (nullptr == m_palette) return;
+
+  for (uint32_t color : *m_palette)
+    colors->push_back(premultiply(color));
+}
+
+
+/**********************************************************************************************************************
+ * Function: renderTile
+ *
+ * Abstract: Fills the pixels of one tile, scanline by scanline.  Pixel (i, j) of the image has its center at
+ *           scene.left + (i + 0.5) * sx, scene.top + (j + 0.5) * sy.  For a scanline at y, the rows of cells that can
+ *           cross it are those whose center is within half a hexagon height of y.  Across a cell at vertical distance
+ *           dy from its center the hexagon is 2 * hw wide, with
+ *              vertical   (pointy top)  hw = w / 2                 for dy <= s / 2,  sqrt(3) * (s - dy) beyond
+ *              horizontal (flat top)    hw = s - dy / sqrt(3)
+ *           and the pixels whose centers lie in [cx - hw, cx + hw) take the color of the cell.
+ *
+ * Input   : image  -- [in/out] image to draw into
+ *           scene  -- [in] rectangle of the scene covered by the whole image
+ *           pixels -- [in] the tile, inside the image
+ *           colors -- [in] color of each plate
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void mapRenderer::renderTile(const rasterT& image, const sceneRectT& scene, const pixelRectT& pixels, const std::vector<uint32_t>& colors) const
+{
+  const uint16_t* cellPlate = m_grid->plates();
+  const uint8_t*  cellStyle = m_grid->styles();
+  const float*    cellElevation = m_grid->elevations();
+  const bool      bVertical = (m_grid->getOrient() == hexGrid::orien::VERTICAL);
+  const double    size = m_grid->getSize();
+  const int64_t   rows = m_grid->getRows();
+  const int64_t   cols = m_grid->getCols();
+  const double    sx = scene.width / image.width;
+  const double    sy = scene.height / image.height;
+  const uint32_t  background = premultiply(m_background);
+  const int       right = pixels.left + pixels.width;                      // one past the tile
+  double          width, height;
+
+  m_grid->cellSize(&width, &height);
+
+  const double    rowStep = bVertical ? 0.75 * height : 0.5 * height;
+  const double    colStep = bVertical ? width : 1.5 * width;
+  const double    oddShift = bVertical ? 0.5 * width : 0.75 * width;
+
+  // scene x of the left and right edges of the tile, used to pick the columns to visit
+  const double    xLeft = scene.x + pixels.left * sx;
+  const double    xRight = scene.x + right * sx;
+
+  for (int py = pixels.top; py < pixels.top + pixels.height; py++)
+  {
+    uint32_t* line = image.bits + (size_t)py * image.stride;
+    double    y = scene.y + (py + 0.5) * sy;
+
+    std::fill(line + pixels.left, line + right, background);
+
+    if (rows == 0) continue;
+
+    int64_t rowFirst = std::max<int64_t>(0, (int64_t)std::ceil((y - height) / rowStep));
+    int64_t rowLast = std::min<int64_t>(rows - 1, (int64_t)std::floor(y / rowStep));
+
+    for (int64_t row = rowFirst; row <= rowLast; row++)
+    {
+      double  shift = (row & 1) ? oddShift : 0;
+      double  cy = 0.5 * height + row * rowStep;
+      int64_t colFirst = std::max<int64_t>(0, (int64_t)std::floor((xLeft - width - shift) / colStep));
+      int64_t colLast = std::min<int64_t>(cols - 1, (int64_t)std::ceil((xRight - shift) / colStep));
+
+      for (int64_t col = colFirst; col <= colLast; col++)
+      {
+        uint32_t id = (uint32_t)(row * cols + col);
+        double   cx = 0.5 * width + shift + col * colStep;
+        double   dy = std::fabs(y - cy);
+        double   hw;
+
+        if (bVertical)
+          hw = (dy <= 0.5 * size) ? 0.5 * width : sqrt3 * (size - dy);
+        else
+          hw = size - dy / sqrt3;
+        if (hw <= 0) continue;
+
+        // pixels with their center in [cx - hw, cx + hw)
+        int i0 = std::max(pixels.left, (int)std::ceil((cx - hw - scene.x) / sx - 0.5));
+        int i1 = std::min(right, (int)std::ceil((cx + hw - scene.x) / sx - 0.5));
+        if (i0 >= i1) continue;
+
+        uint32_t color = background;
+        uint16_t plate = cellPlate[id];
+        uint8_t  style = cellStyle[id];
+
+        switch (m_mode)
+        {
+          case mapRenderer::mode::PLATES:
+            if ((plate != 0) && (plate < colors.size())) color = colors[plate];
+            break;
+          case mapRenderer::mode::ELEVATION:
+            color = elevationColor(cellElevation[id]);
+            break;
+          default:
+            if (((style & bHollow) != bHollow) && ((style & bFilled) == bFilled))
+              color = (((style & bColor) == bColor) && (plate < colors.size())) ? colors[plate] : argb(0, 0, 0);
+            break;
+        }
+
+        std::fill(line + i0, line + i1, color);
+      }
+    }
+  }
+}
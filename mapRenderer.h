@@ -0,0 +1,99 @@
+/**********************************************************************************************************************
+ * Class    : mapRenderer
+ *
+ * Abstract : An offscreen renderer that rasterizes the cells of the hexGrid model straight into a buffer of pixels,
+ *            without a scene and without QPainter, so it needs nothing but the standard library.  The area to draw is cut into square tiles that are rendered in parallel on
+ *            a thread pool; each tile is filled one scanline at a time: for every scanline the renderer visits the
+ *            cells whose rows cross it, works out where the edges of each hexagon cross the scanline, and fills that
+ *            span of pixels with the color of the cell.  A pixel belongs to the cell that holds its center, so
+ *            neighboring cells never overlap and never leave gaps.
+ *            An image maps to a rectangle of the scene, and pixels need not be square.  The same renderer draws the
+ *            image pyramid of the hex layer (see hexLayer) and the exported images (see mapExport, tileExport).
+ *            Pixels are 32 bit premultiplied 0xAARRGGBB, the layout of QImage::Format_ARGB32_Premultiplied, so the GUI
+ *            hands its QImages over through 'rasterOf' without copying them.
+ *            What a cell looks like depends on the mode:
+ *               STYLE     -- as the hex layer shows it, filled cells in their color, other cells in the background,
+ *               PLATES    -- every cell in the color of its plate, cells without a plate in the background,
+ *               ELEVATION -- a color ramp from deep ocean to snow.
+ *
+ * History  : created Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+
+#ifndef _mapRenderer_h_
+#define _mapRenderer_h_
+
+#include <cstdint>
+#include <vector>
+
+class hexGrid;
+class threadPool;
+
+class mapRenderer
+{
+public:
+  enum mode : std::uint8_t { STYLE = 0, PLATES = 1, ELEVATION = 2 };
+
+  typedef struct raster
+  {
+    uint32_t*  bits;                               // first pixel of the top row
+    int        width;
+    int        height;
+    int        stride;                             // pixels from one row to the next
+  } rasterT;
+
+  typedef struct sceneRect
+  {
+    double     x, y, width, height;
+  } sceneRectT;
+
+  typedef struct pixelRect
+  {
+    int        left, top, width, height;
+  } pixelRectT;
+
+  mapRenderer(const hexGrid* grid, const std::vector<uint32_t>* palette, threadPool* pool = nullptr);
+
+  void    setMode(uint8_t mode) { m_mode = mode; }
+  uint8_t getMode() const { return m_mode; }
+  void    setBackground(uint32_t bg) { m_background = bg; }
+  void    setPool(threadPool* pool) { m_pool = pool; }
+
+  void    render(const rasterT& image, const sceneRectT& scene, const pixelRectT& pixels) const;
+
+  static uint32_t elevationColor(float elevation);
+  static void     downsample(const rasterT& src, const rasterT& dst, int left, int top);
+
+private:
+  static const int  tileSize = 256;                // pixels along the side of a tile
+
+  const hexGrid*              m_grid;
+  const std::vector<uint32_t>* m_palette;          // color of each plate (0xAARRGGBB), indexed by plate (0 = no plate)
+  threadPool*                 m_pool;
+  uint8_t                     m_mode;
+  uint32_t                    m_background;        // 0xAARRGGBB, not premultiplied
+
+  void buildColors(std::vector<uint32_t>* colors) const;
+  void renderTile(const rasterT& image, const sceneRectT& scene, const pixelRectT& pixels, const std::vector<uint32_t>& colors) const;
+};
+
+#ifdef QT_GUI_LIB
+#include <QImage>
+#include <QRect>
+#include <QRectF>
+
+// views of the Qt types for the GUI, the image must be in QImage::Format_ARGB32_Premultiplied
+inline mapRenderer::rasterT rasterOf(QImage* image)
+{
+  return { reinterpret_cast<uint32_t*>(image->bits()), image->width(), image->height(), (int)(image->bytesPerLine() / 4) };
+}
+
+inline mapRenderer::rasterT rasterOf(const QImage& image)                  // read only, for the source of downsample
+{
+  return { const_cast<uint32_t*>(reinterpret_cast<const uint32_t*>(image.constBits())), image.width(), image.height(), (int)(image.bytesPerLine() / 4) };
+}
+
+inline mapRenderer::sceneRectT sceneOf(const QRectF& rect) { return { rect.x(), rect.y(), rect.width(), rect.height() }; }
+inline mapRenderer::pixelRectT pixelsOf(const QRect& rect) { return { rect.x(), rect.y(), rect.width(), rect.height() }; }
+#endif
+
+#endif
@@ -0,0 +1,112 @@
+
+#include "mappedFile.h"
+#include "logger.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <filesystem>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+
+#ifdef _WIN32
+mappedFile::mappedFile() : m_data(nullptr), m_size(0), m_hFile(INVALID_HANDLE_VALUE), m_hMapping(nullptr)
+#else
+mappedFile::mappedFile() : m_data(nullptr), m_size(0)
+#endif
+{
+
+}
+
+
+mappedFile::~mappedFile()
+{
+  close();
+}
+
+
+/**********************************************************************************************************************
+ * Function: open
+ *
+ * Abstract: Maps a file, copy-on-write.  Any file mapped before is let go first.
+ *
+ * Input   : path -- [in] name of the file, UTF-8
+ *
+ * Returns : true if the file is mapped
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+bool mappedFile::open(const std::string& path)
+{
+  close();
+
+#ifdef _WIN32
+  LARGE_INTEGER size;
+
+  m_hFile = CreateFileW(std::filesystem::u8path(path).wstring().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                        FILE_ATTRIBUTE_NORMAL, nullptr);
+  if ((m_hFile == INVALID_HANDLE_VALUE) || !GetFileSizeEx(m_hFile, &size))
+  {
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::ERR, "mapped file: cannot open %s (error %lu)", path.c_str(), GetLastError());
+    close();
+    return false;
+  }
+
+  m_size = (uint64_t)size.QuadPart;
+  if (m_size > 0)
+  {
+    m_hMapping = CreateFileMappingW(m_hFile, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    if (m_hMapping != nullptr) m_data = static_cast<uint8_t*>(MapViewOfFile(m_hMapping, FILE_MAP_COPY, 0, 0, 0));
+  }
+#else
+  struct stat info;
+  int         fd = ::open(path.c_str(), O_RDONLY);
+
+  if ((fd < 0) || (fstat(fd, &info) != 0))
+  {
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::ERR, "mapped file: cannot open %s", path.c_str());
+    if (fd >= 0) ::close(fd);
+    return false;
+  }
+
+  m_size = (uint64_t)info.st_size;
+  if (m_size > 0)
+  {
+    void* addr = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (addr != MAP_FAILED) m_data = static_cast<uint8_t*>(addr);
+  }
+  ::close(fd);                                               // the mapping keeps the file open
+#endif
+
+  if (nullptr == m_data)
+  {
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::ERR, "mapped file: cannot map %s", path.c_str());
+    close();
+    return false;
+  }
+
+  return true;
+}
+
+
+void mappedFile::close()
+{
+#ifdef _WIN32
+  if (nullptr != m_data) UnmapViewOfFile(m_data);
+  if (nullptr != m_hMapping) CloseHandle(m_hMapping);
+  if (m_hFile != INVALID_HANDLE_VALUE) CloseHandle(m_hFile);
+  m_hMapping = nullptr;
+  m_hFile = INVALID_HANDLE_VALUE;
+#else
+  if (nullptr != m_data) munmap(m_data, m_size);
+#endif
+
+  m_data = nullptr;
+  m_size = 0;
+}
@@ -0,0 +1,44 @@
+/**********************************************************************************************************************
+ * Class    : mappedFile
+ *
+ * Abstract : Maps a whole file into memory, copy-on-write.  The pages are read from disk the first time they are
+ *            touched, so mapping a file costs next to nothing whatever its size, and only the parts that are used are
+ *            ever read.  The memory may be written to; the first write to a page makes a private copy of it, so the
+ *            file itself is never changed.
+ *            The mapping lasts until the object is destroyed.  The file must not be truncated while it is mapped,
+ *            so a program that wants to overwrite a file it has mapped must let go of the mapping first.
+ *
+ * History  : created Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+
+#ifndef _mappedFile_h_
+#define _mappedFile_h_
+
+#include <cstdint>
+#include <string>
+
+class mappedFile
+{
+public:
+  mappedFile();
+  ~mappedFile();
+
+  bool     open(const std::string& path);
+  void     close();
+
+  uint8_t* data() const { return m_data; }
+  uint64_t size() const { return m_size; }
+
+private:
+  uint8_t*  m_data;
+  uint64_t  m_size;
+#ifdef _WIN32
+  void*     m_hFile;
+  void*     m_hMapping;
+#endif
+
+  mappedFile(const mappedFile&) = delete;
+  mappedFile& operator=(const mappedFile&) = delete;
+};
+
+#endif
@@ -0,0 +1,136 @@
+#include "memStats.h"
+
+#include <atomic>
+#include <new>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+
+#ifdef __WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#endif
+
+static const size_t cntHeader = 16;                            // the size of a block is kept in front of it, keeps the alignment
+
+static std::atomic<uint64_t> s_allocs(0);
+static std::atomic<uint64_t> s_allocBytes(0);
+static std::atomic<uint64_t> s_inUse(0);
+static std::atomic<uint64_t> s_peak(0);                        // of s_inUse
+static std::atomic<uint64_t> s_base(0);                        // s_inUse at the reset
+static bool                  s_bRssReset = false;
+
+
+static void* countedAlloc(size_t size)
+{
+  void* block = malloc(size + cntHeader);
+  if (nullptr == block) throw std::bad_alloc();
+
+  *(size_t*)block = size;
+
+  s_allocs.fetch_add(1, std::memory_order_relaxed);
+  s_allocBytes.fetch_add(size, std::memory_order_relaxed);
+
+  uint64_t inUse = s_inUse.fetch_add(size, std::memory_order_relaxed) + size;
+  uint64_t peak = s_peak.load(std::memory_order_relaxed);
+  while ((inUse > peak) && !s_peak.compare_exchange_weak(peak, inUse, std::memory_order_relaxed))
+    ;
+
+  return (char*)block + cntHeader;
+}
+
+
+static void countedFree(void* ptr)
+{
+  if (nullptr == ptr) return;
+
+  void* block = (char*)ptr - cntHeader;
+  s_inUse.fetch_sub(*(size_t*)block, std::memory_order_relaxed);
+  free(block);
+}
+
+
+void* operator new(size_t size) { return countedAlloc(size); }
+void* operator new[](size_t size) { return countedAlloc(size); }
+void  operator delete(void* ptr) noexcept { countedFree(ptr); }
+void  operator delete[](void* ptr) noexcept { countedFree(ptr); }
+void  operator delete(void* ptr, size_t) noexcept { countedFree(ptr); }
+void  operator delete[](void* ptr, size_t) noexcept { countedFree(ptr); }
+
+
+/**********************************************************************************************************************
+ * Function: reset
+ *
+ * Abstract: Starts counting again: the allocations from 0, the peak heap from the bytes in use now and, where the
+ *           system allows it, the peak RSS from the memory resident now.
+ *
+ * Input   : void
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void memStats::reset()
+{
+  s_allocs = 0;
+  s_allocBytes = 0;
+  s_base = s_inUse.load();
+  s_peak = s_base.load();
+
+#ifdef __WIN32
+  s_bRssReset = false;                                         // the peak working set cannot be reset
+#else
+  FILE* file = fopen("/proc/self/clear_refs", "w");
+  s_bRssReset = (nullptr != file) && (fputs("5", file) >= 0);
+  if (nullptr != file) s_bRssReset = (0 == fclose(file)) && s_bRssReset;
+#endif
+}
+
+
+uint64_t memStats::getAllocs() { return s_allocs; }
+uint64_t memStats::getAllocBytes() { return s_allocBytes; }
+uint64_t memStats::getInUse() { return s_inUse; }
+uint64_t memStats::getPeakHeap() { return s_peak - s_base; }
+bool     memStats::isPeakRssReset() { return s_bRssReset; }
+
+
+/**********************************************************************************************************************
+ * Function: getPeakRss
+ *
+ * Abstract: Reads the peak resident memory of the process, VmHWM of /proc/self/status on Linux, the peak working set
+ *           on Windows.
+ *
+ * Input   : void
+ *
+ * Returns : the peak in bytes, 0 if it cannot be read
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+uint64_t memStats::getPeakRss()
+{
+#ifdef __WIN32
+  PROCESS_MEMORY_COUNTERS counters;
+
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+  return (uint64_t)counters.PeakWorkingSetSize;
+#else
+  FILE*    file = fopen("/proc/self/status", "r");
+  char     line[256];
+  uint64_t peak = 0;
+
+  if (nullptr == file) return 0;
+
+  while (fgets(line, sizeof(line), file))
+  {
+    if (0 == strncmp(line, "VmHWM:", 6))
+    {
+      peak = 1024 * strtoull(line + 6, nullptr, 10);           // in kB
+      break;
+    }
+  }
+
+  fclose(file);
+  return peak;
+#endif
+}
@@ -0,0 +1,37 @@
+/**********************************************************************************************************************
+ * Class    : memStats
+ *
+ * Abstract : Counts the memory a program uses, for the benchmarks (see scaleSweep.h).  memStats.cpp replaces the global
+ *            operator new and delete, so it must be linked into the executable itself, not into a library, and only
+ *            into programs that want the counts; every allocation through new then pays for a few atomic operations.
+ *            Counted since the last 'reset':
+ *               allocations -- calls of operator new, and the bytes they asked for,
+ *               peak heap   -- the most bytes allocated through new at any one time, counted from the bytes in use at
+ *                              the reset,
+ *               peak RSS    -- the most memory the process had resident.  On Linux the peak is reset by writing to
+ *                              /proc/self/clear_refs; where it cannot be reset (or read) it is the peak of the whole
+ *                              process (or 0), which 'isPeakRssReset' tells.
+ *            Memory allocated with malloc is not counted by the first two, only by the peak RSS.
+ *
+ * History  : created Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+
+#ifndef _memStats_h_
+#define _memStats_h_
+
+#include <cstdint>
+
+class memStats
+{
+public:
+  static void     reset();
+
+  static uint64_t getAllocs();
+  static uint64_t getAllocBytes();
+  static uint64_t getInUse();
+  static uint64_t getPeakHeap();
+  static uint64_t getPeakRss();
+  static bool     isPeakRssReset();
+};
+
+#endif
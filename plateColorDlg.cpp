@@ -56,7 +56,7 @@ void plateColorDlg::setupUI()
 
     m_clrBox[ndx] = new QLabel();
     m_clrBox[ndx]->setText(QString("plate%1").arg(ndx));
-    QString   clrStr = QString("QLabel { background-color: %1; color: black;}").arg(plateColors[ndx].name());
+    QString   clrStr = QString("QLabel { background-color: %1; color: black;}").arg(QColor::fromRgba(plateColors[ndx]).name());
     m_clrBox[ndx]->setStyleSheet(clrStr);
     m_clrBox[ndx]->resize(100, 16);
 
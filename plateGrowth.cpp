@@ -0,0 +1,223 @@
+
+#include "plateGrowth.h"
+#include "hexGrid.h"
+#include "threadPool.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <chrono>
+
+static const uint64_t noClaim = 0xFFFFFFFFFFFFFFFF;
+static const uint64_t claimDone = 0x80000000;                 // set in a claim once the winner has taken the cell
+static const uint64_t cntGrain = 1024;                        // border cells per chunk handed to a thread
+
+
+/**********************************************************************************************************************
+ * Function: claimMin
+ *
+ * Abstract: Atomically replaces the claim on a cell with 'key' if key is lower than the current claim.
+ *
+ * Input   : claim -- [in/out] the claim on the cell
+ *           key   -- [in] the new claim
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+static void claimMin(std::atomic<uint64_t>& claim, uint64_t key)
+{
+  uint64_t cur = claim.load(std::memory_order_relaxed);
+  while ((key < cur) && !claim.compare_exchange_weak(cur, key, std::memory_order_relaxed))
+    ;
+}
+
+
+/**********************************************************************************************************************
+ * Function: plateGrowth
+ *
+ * Abstract: Constructs the growth engine.  The plates must already have their centers placed, i.e. the cell holding
+ *           each center is claimed in the grid and is the only entry in the plate's border list.
+ *
+ * Input   : grid      -- [in] pointer to the grid model that will be modified
+ *           plates    -- [in] pointer to the array of plates
+ *           cntPlates -- [in] number of plates in the array
+ *           pool      -- [in] pointer to the threads to grow with, nullptr to grow on the calling thread
+ *
+ * Returns : none
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+plateGrowth::plateGrowth(hexGrid* grid, platesT* plates, uint32_t cntPlates, threadPool* pool) : m_grid(grid), m_plates(plates), m_cntPlates(cntPlates), m_pool(pool), m_step(0), m_claimed(0), m_done(false)
+{
+  m_grid->buildNeighbors();                                  // the grid does not build its neighbor table until it is needed
+
+  for (uint32_t plateNdx = 0; plateNdx < m_cntPlates; plateNdx++)
+    m_claimed += m_plates[plateNdx].vec.size();
+
+  m_claims.reset(new std::atomic<uint64_t>[m_grid->getCount()]);
+  for (uint32_t id = 0; id < m_grid->getCount(); id++)
+    m_claims[id].store(noClaim, std::memory_order_relaxed);
+}
+
+
+plateGrowth::~plateGrowth()
+{
+
+}
+
+
+/**********************************************************************************************************************
+ * Function: step
+ *
+ * Abstract: Performs one growth step of all plates at once.  The step has three phases, the first two are spread
+ *           across the thread pool:
+ *             (1) claim   -- for each border cell, every unfilled neighbor is claimed with the key
+ *                            (stamp << 32) | plateIndex, keeping the lowest key.  The stamp decreases every step, so
+ *                            a claim from this step always beats a stale claim left over from an earlier step.
+ *             (2) commit  -- for each border cell, every neighbor whose claim is this plate's key is taken by the
+ *                            plate.  Marking the claim as done makes sure a cell is taken only once.
+ *             (3) borders -- the cells taken are sorted by (plate, cell id) and become the new plate borders.
+ *           The cells claimed during the step are available from 'getChanged' so that a view can repaint just them.
+ *
+ * Input   : void
+ *
+ * Returns : true if the map changed during this step, false once the plates have stopped growing
+ *
+ * Written : Oct 2026 (gkhuber) -- moved here from terrainGen::onSimPlatesImpl
+ *           Oct 2026 (gkhuber) -- grow all plates concurrently
+ *********************************************************************************************************************/
+bool plateGrowth::step()
+{
+  uint16_t*       cellPlate = m_grid->plates();                                    // cell arrays of the grid model
+  uint8_t*        cellStyle = m_grid->styles();
+  const uint64_t  stamp = (uint64_t)(0xFFFFFFFF - m_step) << 32;
+
+  m_step++;
+  m_changed.clear();
+  m_won.clear();
+
+  // gather the borders of all the plates into one list
+  m_frontier.clear();
+  m_frontierPlate.clear();
+  for (uint32_t plateNdx = 0; plateNdx < m_cntPlates; plateNdx++)
+  {
+    m_frontier.insert(m_frontier.end(), m_plates[plateNdx].vec.begin(), m_plates[plateNdx].vec.end());
+    m_frontierPlate.insert(m_frontierPlate.end(), m_plates[plateNdx].vec.size(), plateNdx);
+  }
+
+  auto claim = [this, cellStyle, stamp](uint64_t begin, uint64_t end)
+  {
+    for (uint64_t ndx = begin; ndx < end; ndx++)
+    {
+      const uint32_t* pNbrs = m_grid->neighbors(m_frontier[ndx]);
+      uint64_t        key = stamp | m_frontierPlate[ndx];
+
+      for (uint32_t a = 0; a < cntNeighbors; a++)
+      {
+        if (pNbrs[a] == noNeighbor) continue;                                      // neighbor is off the edge of the map
+        if ((cellStyle[pNbrs[a]] & bFilled) == bFilled) continue;                  // cell already belongs to a plate
+
+        claimMin(m_claims[pNbrs[a]], key);
+      }
+    }
+  };
+
+  auto commit = [this, cellPlate, cellStyle, stamp](uint64_t begin, uint64_t end)
+  {
+    std::vector<uint64_t> won;
+
+    for (uint64_t ndx = begin; ndx < end; ndx++)
+    {
+      const uint32_t* pNbrs = m_grid->neighbors(m_frontier[ndx]);
+      uint32_t        plateNdx = m_frontierPlate[ndx];
+      uint64_t        key = stamp | plateNdx;
+
+      for (uint32_t a = 0; a < cntNeighbors; a++)
+      {
+        if (pNbrs[a] == noNeighbor) continue;
+
+        uint64_t expected = key;
+        if (m_claims[pNbrs[a]].compare_exchange_strong(expected, key | claimDone, std::memory_order_relaxed))
+        {
+          cellPlate[pNbrs[a]] = m_plates[plateNdx].ndx;                            // only the winner writes the cell
+          cellStyle[pNbrs[a]] = bFilled | bColor;
+          won.push_back(((uint64_t)plateNdx << 32) | pNbrs[a]);
+        }
+      }
+    }
+
+    std::lock_guard<std::mutex> guard(m_lockWon);
+    m_won.insert(m_won.end(), won.begin(), won.end());
+  };
+
+  if (nullptr != m_pool)
+  {
+    m_pool->parallelFor(m_frontier.size(), cntGrain, claim);
+    m_pool->parallelFor(m_frontier.size(), cntGrain, commit);
+  }
+  else
+  {
+    claim(0, m_frontier.size());
+    commit(0, m_frontier.size());
+  }
+
+  // the order the threads finished in is not deterministic, sorting puts the new borders in (plate, cell) order
+  std::sort(m_won.begin(), m_won.end());
+
+  for (uint32_t plateNdx = 0; plateNdx < m_cntPlates; plateNdx++)
+    m_plates[plateNdx].vec.clear();
+
+  m_changed.reserve(m_won.size());
+  for (uint64_t won : m_won)
+  {
+    m_plates[won >> 32].vec.push_back((uint32_t)won);
+    m_changed.push_back((uint32_t)won);
+  }
+
+  m_claimed += m_changed.size();
+  m_done = m_changed.empty();
+
+  CLogger::getInstance()->outMsg(cmdLine, CLogger::level::DEBUG, "growth step %d claimed %d cells", m_step, (int)m_changed.size());
+
+  return !m_done;
+}
+
+
+/**********************************************************************************************************************
+ * Function: run
+ *
+ * Abstract: Steps the growth until no plate can grow any further.  There is no delay between steps, the only cost is
+ *           the growth itself.  If a progress callback is given it is invoked at most once every intervalMs
+ *           milliseconds, and once more when the growth is complete.
+ *
+ * Input   : progress   -- [in] function to call with the current step and the number of claimed cells, may be nullptr
+ *           intervalMs -- [in] minimum time, in milliseconds, between two calls to the progress function
+ *
+ * Returns : number of steps taken
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+uint32_t plateGrowth::run(progressFnct progress, uint32_t intervalMs)
+{
+  typedef std::chrono::steady_clock  clock;
+
+  clock::time_point  lastReport = clock::now();
+  const clock::duration interval = std::chrono::milliseconds(intervalMs);
+
+  while (!m_done)
+  {
+    step();
+
+    if ((progress) && (clock::now() - lastReport >= interval))
+    {
+      progress(m_step, m_claimed);
+      lastReport = clock::now();
+    }
+  }
+
+  if (progress) progress(m_step, m_claimed);
+
+  CLogger::getInstance()->outMsg(cmdLine, CLogger::level::INFO, "plate growth complete after %d steps, %llu cells claimed", m_step, (unsigned long long)m_claimed);
+
+  return m_step;
+}
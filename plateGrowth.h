@@ -0,0 +1,69 @@
+/**********************************************************************************************************************
+ * Class    : plateGrowth
+ *
+ * Abstract : This class grows the tectonic plates outward from their centers until every cell of the grid belongs to
+ *            a plate.  Each plate keeps the list of cells on its border (platesT::vec); one growth step claims every
+ *            unclaimed neighbor of those cells and makes the claimed cells the new border.  The engine works only on
+ *            the hexGrid model and does not touch the scene, so it can be used in two ways:
+ *               (1) stepped, one call to 'step' per timer tick, which is used to animate the growth, or
+ *               (2) run to completion with 'run', which steps as fast as possible and reports progress through a
+ *                   callback that is invoked at most once per reporting interval.
+ *            A step expands the borders of all plates at the same time (a multi-source breadth first search).  If a
+ *            threadPool is given the border cells are split across its threads.  Every plate that reaches an unclaimed
+ *            cell during a step places an atomic claim on it, and the claim with the lowest plate index wins.  Since
+ *            the winner does not depend on the order the claims arrive in, and the new borders are sorted by cell id,
+ *            the plate map is the same for any number of threads (and the same as growing the plates one after
+ *            another in index order).
+ *
+ * History  : created Oct 2026 (gkhuber)
+ *            Oct 2026 (gkhuber) grow all plates concurrently with a deterministic claim rule
+ *********************************************************************************************************************/
+
+#ifndef _plateGrowth_h_
+#define _plateGrowth_h_
+
+#include <cstdint>
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <functional>
+
+#include "constants.h"
+
+class hexGrid;
+class threadPool;
+
+typedef std::function<void(uint32_t, uint64_t)>  progressFnct;          // (step, number of cells claimed so far)
+
+class plateGrowth
+{
+public:
+  plateGrowth(hexGrid* grid, platesT* plates, uint32_t cntPlates, threadPool* pool = nullptr);
+  ~plateGrowth();
+
+  bool     step();
+  uint32_t run(progressFnct progress = nullptr, uint32_t intervalMs = 100);
+
+  bool     isDone() const { return m_done; }
+  uint32_t getStep() const { return m_step; }
+  uint64_t getClaimed() const { return m_claimed; }
+  const std::vector<uint32_t>& getChanged() const { return m_changed; }
+
+private:
+  hexGrid*               m_grid;
+  platesT*               m_plates;
+  uint32_t               m_cntPlates;
+  threadPool*            m_pool;               // threads to grow with, nullptr to grow on the calling thread
+  std::unique_ptr<std::atomic<uint64_t>[]> m_claims;   // per cell claim, (step stamp << 32) | plate index
+  std::vector<uint32_t>  m_frontier;           // border cells of all plates for the current step
+  std::vector<uint32_t>  m_frontierPlate;      // index into m_plates of each border cell
+  std::vector<uint64_t>  m_won;                // (plate index << 32) | cell, for each cell claimed by the step
+  std::mutex             m_lockWon;
+  uint32_t               m_step;               // number of growth steps taken
+  uint64_t               m_claimed;            // number of cells that belong to a plate
+  bool                   m_done;               // true once a step claims no cells
+  std::vector<uint32_t>  m_changed;            // cells claimed by the last step
+};
+
+#endif
@@ -0,0 +1,335 @@
+
+#include "plateMotion.h"
+#include "hexGrid.h"
+#include "threadPool.h"
+#include "logger.h"
+
+#include <cmath>
+
+static const uint64_t noClaim = 0xFFFFFFFFFFFFFFFF;
+static const uint64_t cntGrain = 4096;                        // cells per chunk handed to a thread
+static const float    newCrustElevation = -2500.0f;           // depth, in meters, of the crust formed at a ridge
+static const float    upliftRate = 0.001f;                    // meters / year of uplift where plates collide
+
+
+/**********************************************************************************************************************
+ * Function: nearestShift
+ *
+ * Abstract: Finds the lattice vector closest to a displacement.  The lattice points are the (X, Y) with X + Y even,
+ *           so the closest one is among the few points around (dx / stepX, dy / stepY).
+ *
+ * Input   : dx, dy       -- [in] displacement in scene units
+ *           stepX, stepY -- [in] scene distance of one unit of X and of Y
+ *           pX, pY       -- [out] the closest lattice vector
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+static void nearestShift(double_t dx, double_t dy, double_t stepX, double_t stepY, int32_t* pX, int32_t* pY)
+{
+  double_t fx = dx / stepX;
+  double_t fy = dy / stepY;
+  int32_t  x0 = (int32_t)std::floor(fx);
+  int32_t  y0 = (int32_t)std::floor(fy);
+  double_t best = -1;
+
+  for (int32_t x = x0 - 1; x <= x0 + 2; x++)
+  {
+    for (int32_t y = y0 - 1; y <= y0 + 2; y++)
+    {
+      if (((x + y) & 1) != 0) continue;                        // not a lattice point
+
+      double_t ex = (x - fx) * stepX;
+      double_t ey = (y - fy) * stepY;
+      double_t dist = ex * ex + ey * ey;
+
+      if ((best < 0) || (dist < best))
+      {
+        best = dist;
+        *pX = x;
+        *pY = y;
+      }
+    }
+  }
+}
+
+
+/**********************************************************************************************************************
+ * Function: plateMotion
+ *
+ * Abstract: Constructs the motion kernel.  The plates must cover the grid (see plateGrowth), and the plate index stored
+ *           in each cell must be platesT::ndx, which is the position of the plate in the array plus one.
+ *
+ * Input   : grid      -- [in] pointer to the grid model that will be modified
+ *           plates    -- [in] pointer to the array of plates, the centers are moved with the plates
+ *           cntPlates -- [in] number of plates in the array
+ *           speed     -- [in] speed of each plate in cm / year
+ *           direction -- [in] direction of each plate in degrees, measured in scene coordinates
+ *           cmPerUnit -- [in] scale of the map, cm per scene unit
+ *           pool      -- [in] pointer to the threads to use, nullptr to work on the calling thread
+ *
+ * Returns : none
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+plateMotion::plateMotion(hexGrid* grid, platesT* plates, uint32_t cntPlates, const double_t* speed, const double_t* direction, double_t cmPerUnit,
+                         threadPool* pool) : m_grid(grid), m_plates(plates), m_cntPlates(cntPlates), m_pool(pool), m_moved(0), m_overlapped(0), m_vacated(0)
+{
+  m_velX.resize(m_cntPlates);
+  m_velY.resize(m_cntPlates);
+  m_residX.assign(m_cntPlates, 0);
+  m_residY.assign(m_cntPlates, 0);
+  m_shiftX.assign(m_cntPlates, 0);
+  m_shiftY.assign(m_cntPlates, 0);
+
+  for (uint32_t ndx = 0; ndx < m_cntPlates; ndx++)
+  {
+    m_velX[ndx] = (speed[ndx] / cmPerUnit) * cos(direction[ndx] * (pi / 180));
+    m_velY[ndx] = (speed[ndx] / cmPerUnit) * sin(direction[ndx] * (pi / 180));
+  }
+
+  if (m_grid->getOrient() == hexGrid::orien::VERTICAL)
+  {
+    m_stepX = 0.5 * sqrt3 * m_grid->getSize();                // half the width of a hexagon
+    m_stepY = 1.5 * m_grid->getSize();                        // three quarters of the height
+  }
+  else
+  {
+    m_stepX = 1.5 * m_grid->getSize();                        // three quarters of the width
+    m_stepY = 0.5 * sqrt3 * m_grid->getSize();                // half the height
+  }
+
+  uint32_t cntCells = m_grid->getCount();
+
+  m_claims.reset(new std::atomic<uint64_t>[cntCells]);
+  m_arrivals.reset(new std::atomic<uint8_t>[cntCells]);
+  for (uint32_t id = 0; id < cntCells; id++)
+  {
+    m_claims[id].store(noClaim, std::memory_order_relaxed);
+    m_arrivals[id].store(0, std::memory_order_relaxed);
+  }
+
+  m_nextPlate.resize(cntCells);
+  m_nextStyle.resize(cntCells);
+  m_nextElevation.resize(cntCells);
+}
+
+
+plateMotion::~plateMotion()
+{
+
+}
+
+
+/**********************************************************************************************************************
+ * Function: setResiduals
+ *
+ * Abstract: Restores the displacements not yet applied, as read back with getResidX and getResidY, so that a run
+ *           restarted from a saved world carries on exactly as the run that saved it.
+ *
+ * Input   : residX -- [in] per plate, displacement not yet applied along X, in scene units
+ *           residY -- [in] per plate, along Y
+ *
+ * Returns : true if there was one of each per plate, otherwise nothing is changed
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+bool plateMotion::setResiduals(const std::vector<double_t>& residX, const std::vector<double_t>& residY)
+{
+  if ((residX.size() != m_cntPlates) || (residY.size() != m_cntPlates)) return false;
+
+  m_residX = residX;
+  m_residY = residY;
+  return true;
+}
+
+
+/**********************************************************************************************************************
+ * Function: step
+ *
+ * Abstract: Moves the plates for one time step.  The displacement of each plate is added to what is left over from the
+ *           previous steps, and the closest lattice vector is taken out of it.  If no plate has moved a whole cell
+ *           the grid is not touched at all, otherwise the cells are moved by a scatter pass and a gather pass.
+ *
+ * Input   : years -- [in] length of the time step
+ *
+ * Returns : true if any cell changed
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+bool plateMotion::step(uint64_t years)
+{
+  bool  bMove = false;
+
+  for (uint32_t ndx = 0; ndx < m_cntPlates; ndx++)
+  {
+    m_residX[ndx] += m_velX[ndx] * years;
+    m_residY[ndx] += m_velY[ndx] * years;
+
+    nearestShift(m_residX[ndx], m_residY[ndx], m_stepX, m_stepY, &m_shiftX[ndx], &m_shiftY[ndx]);
+
+    double_t dx = m_shiftX[ndx] * m_stepX;
+    double_t dy = m_shiftY[ndx] * m_stepY;
+
+    m_residX[ndx] -= dx;
+    m_residY[ndx] -= dy;
+    m_plates[ndx].center_x += dx;
+    m_plates[ndx].center_y += dy;
+
+    if ((m_shiftX[ndx] != 0) || (m_shiftY[ndx] != 0)) bMove = true;
+  }
+
+  m_moved = 0;
+  m_overlapped = 0;
+  m_vacated = 0;
+  m_changed.clear();
+
+  if (!bMove) return false;
+
+  std::atomic<uint64_t> counts[3] = { {0}, {0}, {0} };              // moved, overlapped, vacated
+  uint64_t              cntCells = m_grid->getCount();
+
+  if (nullptr != m_pool)
+  {
+    m_pool->parallelFor(cntCells, cntGrain, [this](uint64_t begin, uint64_t end) { scatter(begin, end); });
+    m_pool->parallelFor(cntCells, cntGrain, [this, years, &counts](uint64_t begin, uint64_t end) { gather(begin, end, years, counts); });
+  }
+  else
+  {
+    scatter(0, cntCells);
+    gather(0, cntCells, years, counts);
+  }
+
+  m_grid->swapCells(m_nextPlate, m_nextStyle, m_nextElevation);
+
+  m_moved = counts[0];
+  m_overlapped = counts[1];
+  m_vacated = counts[2];
+
+  CLogger::getInstance()->outMsg(cmdLine, CLogger::level::DEBUG, "motion step: %llu cells moved, %llu overlapped, %llu vacated", (unsigned long long)m_moved,
+                                 (unsigned long long)m_overlapped, (unsigned long long)m_vacated);
+
+  return true;
+}
+
+
+/**********************************************************************************************************************
+ * Function: scatter
+ *
+ * Abstract: Claims the destination of every cell in [begin, end).  The claim key orders the arrivals at a cell: higher
+ *           elevation first, then lower plate index, then lower source cell, so the winner is the same whatever order
+ *           the threads get there in.  Cells moved off the edge of the map are lost.
+ *
+ * Input   : begin -- [in] first cell
+ *           end   -- [in] one past the last cell
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void plateMotion::scatter(uint64_t begin, uint64_t end)
+{
+  const uint16_t* cellPlate = m_grid->plates();
+  const float*    cellElevation = m_grid->elevations();
+  const int64_t   rows = m_grid->getRows();
+  const int64_t   cols = m_grid->getCols();
+
+  for (uint64_t id = begin; id < end; id++)
+  {
+    uint16_t plate = cellPlate[id];
+    if ((plate == 0) || (plate > m_cntPlates)) continue;           // cell does not belong to a plate
+
+    int64_t row = id / cols;
+    int64_t x = 2 * (id % cols) + (row & 1) + m_shiftX[plate - 1];
+    row += m_shiftY[plate - 1];
+
+    if ((row < 0) || (row >= rows) || (x < 0)) continue;
+    int64_t col = (x - (row & 1)) / 2;
+    if (col >= cols) continue;
+
+    uint64_t dest = row * cols + col;
+    float    elev = std::fmin(std::fmax(cellElevation[id] + 32768.0f, 0.0f), 65535.0f);
+    uint64_t key = ((uint64_t)(65535 - (uint16_t)elev) << 48) | ((uint64_t)plate << 32) | id;
+
+    uint64_t cur = m_claims[dest].load(std::memory_order_relaxed);
+    while ((key < cur) && !m_claims[dest].compare_exchange_weak(cur, key, std::memory_order_relaxed))
+      ;
+    m_arrivals[dest].fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+
+/**********************************************************************************************************************
+ * Function: gather
+ *
+ * Abstract: Builds the next state of every cell in [begin, end) from the claims made by 'scatter', and resets the
+ *           claims for the next step.  Cells whose plate or style change are added to the list of changed cells.
+ *
+ * Input   : begin  -- [in] first cell
+ *           end    -- [in] one past the last cell
+ *           years  -- [in] length of the time step, used for the uplift of overlapped cells
+ *           counts -- [in/out] number of cells moved, overlapped and vacated
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void plateMotion::gather(uint64_t begin, uint64_t end, uint64_t years, std::atomic<uint64_t>* counts)
+{
+  const uint16_t* cellPlate = m_grid->plates();
+  const uint8_t*  cellStyle = m_grid->styles();
+  const float*    cellElevation = m_grid->elevations();
+  uint64_t        moved = 0;
+  uint64_t        overlapped = 0;
+  uint64_t        vacated = 0;
+  std::vector<uint32_t> changed;
+
+  for (uint64_t id = begin; id < end; id++)
+  {
+    uint64_t key = m_claims[id].load(std::memory_order_relaxed);          // each cell is gathered by one thread only
+    uint8_t  arrivals = m_arrivals[id].load(std::memory_order_relaxed);
+
+    if (key != noClaim) m_claims[id].store(noClaim, std::memory_order_relaxed);
+    if (arrivals != 0) m_arrivals[id].store(0, std::memory_order_relaxed);
+
+    if (key == noClaim)
+    {
+      m_nextPlate[id] = cellPlate[id];
+      m_nextStyle[id] = cellStyle[id];
+      m_nextElevation[id] = cellElevation[id];
+
+      if (cellPlate[id] != 0)                                       // the plate moved away, new crust fills the gap
+      {
+        m_nextStyle[id] = bFilled | bColor;
+        m_nextElevation[id] = newCrustElevation;
+        vacated++;
+      }
+    }
+    else
+    {
+      uint32_t src = (uint32_t)key;
+
+      m_nextPlate[id] = (uint16_t)(key >> 32);
+      m_nextStyle[id] = cellStyle[src];
+      m_nextElevation[id] = cellElevation[src];
+
+      if (src != id) moved++;
+      if (arrivals > 1)                                             // plates collide, the winner is pushed up
+      {
+        m_nextElevation[id] += upliftRate * years;
+        overlapped++;
+      }
+    }
+
+    if ((m_nextPlate[id] != cellPlate[id]) || (m_nextStyle[id] != cellStyle[id]))
+      changed.push_back((uint32_t)id);                              // the cell looks different
+  }
+
+  counts[0] += moved;
+  counts[1] += overlapped;
+  counts[2] += vacated;
+
+  std::lock_guard<std::mutex> guard(m_lockChanged);
+  m_changed.insert(m_changed.end(), changed.begin(), changed.end());
+}
@@ -0,0 +1,93 @@
+/**********************************************************************************************************************
+ * Class    : plateMotion
+ *
+ * Abstract : This class moves the tectonic plates across the grid, one time step per call to 'step'.  Each plate moves
+ *            rigidly along its velocity vector.  The motion is kept on the hexagonal lattice: the displacement of a
+ *            plate is accumulated every step, and once it reaches a lattice vector every cell of the plate is
+ *            translated by that vector; the remainder is carried over to the next step, so plates move at the right
+ *            average speed however short the time step.
+ *            A step is done in two passes over the cell arrays, both spread across the thread pool:
+ *               (1) scatter -- each cell of a plate that moves is claimed at its destination.  Where two plates arrive
+ *                              at the same cell (a convergent boundary) the cell with the higher elevation wins, ties
+ *                              going to the lower plate index, and the loser is subducted.
+ *               (2) gather  -- each cell takes the state of the cell that won it.  Overlapped cells are uplifted.  A
+ *                              cell that nobody moved into (a divergent boundary, or the trailing edge of the map) is
+ *                              new crust of the plate that moved away from it.
+ *            The next state is built in separate arrays and swapped into the grid, so a pass never reads a value
+ *            written by the same step and the result does not depend on the number of threads.
+ *            Positions on the lattice are measured in doubled coordinates, X = 2 * col + (row & 1) and Y = row, for
+ *            both orientations; a lattice vector is any (dX, dY) with dX + dY even.
+ *
+ *            The remainders are part of the state of the simulation: a run restarted from a saved world only moves
+ *            the plates exactly as the run that saved it if they are saved and restored too (see 'setResiduals').
+ *
+ * History  : created Oct 2026 (gkhuber)
+ *            Oct 2026 (gkhuber) the remainders can be read and restored
+ *********************************************************************************************************************/
+
+#ifndef _plateMotion_h_
+#define _plateMotion_h_
+
+#include <cstdint>
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#include "constants.h"
+
+class hexGrid;
+class threadPool;
+
+class plateMotion
+{
+public:
+  plateMotion(hexGrid* grid, platesT* plates, uint32_t cntPlates, const double_t* speed, const double_t* direction, double_t cmPerUnit,
+              threadPool* pool = nullptr);
+  ~plateMotion();
+
+  bool     step(uint64_t years);
+
+  uint64_t getMoved() const { return m_moved; }
+  uint64_t getOverlapped() const { return m_overlapped; }
+  uint64_t getVacated() const { return m_vacated; }
+  const std::vector<uint32_t>& getChanged() const { return m_changed; }
+  const std::vector<double_t>& getResidX() const { return m_residX; }
+  const std::vector<double_t>& getResidY() const { return m_residY; }
+  bool     setResiduals(const std::vector<double_t>& residX, const std::vector<double_t>& residY);
+
+private:
+  hexGrid*                m_grid;
+  platesT*                m_plates;
+  uint32_t                m_cntPlates;
+  threadPool*             m_pool;
+
+  // per plate, indexed by (platesT::ndx - 1)
+  std::vector<double_t>   m_velX;               // scene units / year
+  std::vector<double_t>   m_velY;
+  std::vector<double_t>   m_residX;             // displacement not yet applied, in scene units
+  std::vector<double_t>   m_residY;
+  std::vector<int32_t>    m_shiftX;             // lattice vector applied this step, doubled coordinates
+  std::vector<int32_t>    m_shiftY;
+
+  // per cell
+  std::unique_ptr<std::atomic<uint64_t>[]> m_claims;    // (elevation rank << 48) | (plate << 32) | source cell
+  std::unique_ptr<std::atomic<uint8_t>[]>  m_arrivals;  // number of cells moved into the cell
+  std::vector<uint16_t>   m_nextPlate;
+  std::vector<uint8_t>    m_nextStyle;
+  std::vector<float>      m_nextElevation;
+
+  double_t                m_stepX;              // scene distance of one unit of X
+  double_t                m_stepY;              // scene distance of one unit of Y
+
+  uint64_t                m_moved;              // cells that moved during the last step
+  uint64_t                m_overlapped;         // cells reached by more than one plate during the last step
+  uint64_t                m_vacated;            // cells left empty during the last step
+  std::vector<uint32_t>   m_changed;            // cells whose plate or style changed during the last step
+  std::mutex              m_lockChanged;
+
+  void scatter(uint64_t begin, uint64_t end);
+  void gather(uint64_t begin, uint64_t end, uint64_t years, std::atomic<uint64_t>* counts);
+};
+
+#endif
@@ -0,0 +1,265 @@
+#include "scaleSweep.h"
+#include "benchmark.h"
+#include "memStats.h"
+#include "hexGrid.h"
+#include "plateGrowth.h"
+#include "plateMotion.h"
+#include "threadPool.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+
+static const double   hexSize = 8;
+static const uint64_t stepYears = 10000000;                    // as benchmark's motionStep
+static const double_t mapSpan = 4.0075E9;                      // cm, as in simulation.cpp
+
+
+scaleSweep::scaleSweep(uint64_t maxCells, uint32_t maxPlates, uint32_t cntThreads, uint32_t cntSteps) : m_maxCells(maxCells), m_maxPlates(maxPlates),
+  m_cntSteps(cntSteps), m_pool(nullptr)
+{
+  if (cntThreads > 1) m_pool = new threadPool(cntThreads);
+}
+
+
+scaleSweep::~scaleSweep()
+{
+  delete m_pool;
+}
+
+
+const char* scaleSweep::phaseName(uint8_t phase)
+{
+  static const char* names[CNT_PHASES] = { "grid", "centers", "growth", "motion", "timeStep" };
+
+  return (phase < CNT_PHASES) ? names[phase] : "unknown";
+}
+
+
+/**********************************************************************************************************************
+ * Function: run
+ *
+ * Abstract: Runs the sweep, the cell counts 1K, 10K, ... up to m_maxCells, each with the plate counts 4, 16, ... up to
+ *           m_maxPlates.
+ *
+ * Input   : void
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void scaleSweep::run()
+{
+  for (uint64_t cells = 1000; cells <= m_maxCells; cells *= 10)
+    for (uint32_t cntPlates = 4; cntPlates <= m_maxPlates; cntPlates *= 4)
+      runOne(cells, cntPlates);
+}
+
+
+/**********************************************************************************************************************
+ * Function: runOne
+ *
+ * Abstract: Makes a world of about 'cells' cells and 'cntPlates' plates, phase by phase, and records each phase.  The
+ *           map is 4:3 and the grid gets as close to the number of cells as whole rows and columns allow.
+ *
+ * Input   : cells     -- [in] number of cells wanted
+ *           cntPlates -- [in] number of plates
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void scaleSweep::runOne(uint64_t cells, uint32_t cntPlates)
+{
+  double                        start;
+  double                        width;
+  double                        height;
+  hexGrid                       grid;
+  std::vector<platesT>          plates;
+  std::vector<double_t>         speed;
+  std::vector<double_t>         direction;
+  std::unique_ptr<plateGrowth>  growth;
+  std::unique_ptr<plateMotion>  motion;
+
+  // a column is sqrt(3) * size wide, a row 1.5 * size high; cols / rows = 4/3 * 1.5 / sqrt(3) gives a 4:3 map
+  uint32_t cols = (uint32_t)std::max(1.0, std::round(std::sqrt(cells * (4.0 / 3.0) * 1.5 / sqrt3)));
+  uint32_t rows = (uint32_t)std::max(1.0, std::round((double)cells / cols));
+
+  cells = (uint64_t)rows * cols;
+  CLogger::getInstance()->outMsg(cmdLine, CLogger::level::INFO, "sweep: %llu cells, %u plates", (unsigned long long)cells, cntPlates);
+
+  begin(&start);
+  grid.build(hexGrid::orien::VERTICAL, hexSize, rows, cols);
+  grid.buildNeighbors();
+  end(cells, cntPlates, GRID, start);
+
+  grid.extent(&width, &height);
+
+  begin(&start);
+  benchmark::placeCenters(&grid, &plates, cntPlates, 1);
+  end(cells, cntPlates, CENTERS, start);
+
+  begin(&start);
+  growth.reset(new plateGrowth(&grid, plates.data(), cntPlates, m_pool));
+  growth->run();
+  growth.reset();
+  end(cells, cntPlates, GROWTH, start);
+
+  begin(&start);
+  benchmark::genMotion(cntPlates, 1, &speed, &direction);
+  motion.reset(new plateMotion(&grid, plates.data(), cntPlates, speed.data(), direction.data(), mapSpan / width, m_pool));
+  end(cells, cntPlates, MOTION, start);
+
+  begin(&start);
+  for (uint32_t step = 0; step < m_cntSteps; step++)
+    motion->step(stepYears);
+  end(cells, cntPlates, TIMESTEP, start);
+}
+
+
+void scaleSweep::begin(double* start)
+{
+  memStats::reset();
+  *start = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+void scaleSweep::end(uint64_t cells, uint32_t cntPlates, uint8_t phase, double start)
+{
+  sampleT sample;
+
+  sample.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count() - start;
+  sample.cells = cells;
+  sample.plates = cntPlates;
+  sample.phase = phase;
+  sample.peakRss = memStats::getPeakRss();
+  sample.peakHeap = memStats::getPeakHeap();
+  sample.allocs = memStats::getAllocs();
+  sample.allocBytes = memStats::getAllocBytes();
+  m_samples.push_back(sample);
+}
+
+
+/**********************************************************************************************************************
+ * Function: scaling
+ *
+ * Abstract: Computes the scaling exponent of a sample: the slope of log(time) over log(cells) between the sample and
+ *           the sample of the same phase and plates at the next smaller cell count.
+ *
+ * Input   : ndx -- [in] index of the sample
+ *
+ * Returns : the exponent, NAN for the smallest cell count or if a time is too short to measure
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+double scaleSweep::scaling(size_t ndx) const
+{
+  const sampleT& cur = m_samples[ndx];
+  const sampleT* prev = nullptr;
+
+  for (size_t other = 0; other < ndx; other++)
+  {
+    const sampleT& sample = m_samples[other];
+
+    if ((sample.phase == cur.phase) && (sample.plates == cur.plates) && (sample.cells < cur.cells))
+      prev = &sample;
+  }
+
+  if ((nullptr == prev) || (prev->seconds <= 0) || (cur.seconds <= 0)) return NAN;
+
+  return std::log(cur.seconds / prev->seconds) / std::log((double)cur.cells / prev->cells);
+}
+
+
+/**********************************************************************************************************************
+ * Function: print
+ *
+ * Abstract: Prints the samples as a table per plate count on the console.
+ *
+ * Input   : void
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void scaleSweep::print() const
+{
+  const double mb = 1024.0 * 1024.0;
+
+  for (uint32_t cntPlates = 4; cntPlates <= m_maxPlates; cntPlates *= 4)
+  {
+    printf("\n%u plates\n", cntPlates);
+    printf("%10s %-9s %12s %8s %12s %12s %10s %12s\n", "cells", "phase", "wall ms", "scaling", "peak RSS MB", "peak heap MB", "allocs", "alloc MB");
+
+    for (size_t ndx = 0; ndx < m_samples.size(); ndx++)
+    {
+      const sampleT& sample = m_samples[ndx];
+      double         exponent = scaling(ndx);
+      char           strScaling[16] = "-";
+
+      if (sample.plates != cntPlates) continue;
+      if (!std::isnan(exponent)) snprintf(strScaling, sizeof(strScaling), "%.2f", exponent);
+
+      printf("%10llu %-9s %12.3f %8s %12.1f %12.1f %10llu %12.1f\n", (unsigned long long)sample.cells, phaseName(sample.phase), 1000 * sample.seconds,
+             strScaling, sample.peakRss / mb, sample.peakHeap / mb, (unsigned long long)sample.allocs, sample.allocBytes / mb);
+    }
+  }
+
+  if (!memStats::isPeakRssReset()) printf("\npeak RSS could not be reset, it is the peak of the whole run so far\n");
+}
+
+
+/**********************************************************************************************************************
+ * Function: writeCsv
+ *
+ * Abstract: Writes the samples as CSV, one row per phase of each world:
+ *              cells,plates,phase,wall_ms,scaling,peak_rss_bytes,peak_heap_bytes,allocs,alloc_bytes
+ *           'scaling' is empty for the smallest cell count.
+ *
+ * Input   : path -- [in] name of the file
+ *
+ * Returns : true if the file was written, false otherwise
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+bool scaleSweep::writeCsv(const std::string& path) const
+{
+  std::ofstream out(path, std::ios::trunc);
+
+  if (!out.is_open())
+  {
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::ERR, "sweep: cannot create %s", path.c_str());
+    return false;
+  }
+
+  out << "cells,plates,phase,wall_ms,scaling,peak_rss_bytes,peak_heap_bytes,allocs,alloc_bytes\n";
+
+  for (size_t ndx = 0; ndx < m_samples.size(); ndx++)
+  {
+    const sampleT& sample = m_samples[ndx];
+    double         exponent = scaling(ndx);
+    char           line[256];
+
+    snprintf(line, sizeof(line), "%llu,%u,%s,%.4f,", (unsigned long long)sample.cells, sample.plates, phaseName(sample.phase), 1000 * sample.seconds);
+    out << line;
+    if (!std::isnan(exponent))
+    {
+      snprintf(line, sizeof(line), "%.3f", exponent);
+      out << line;
+    }
+    out << ',' << sample.peakRss << ',' << sample.peakHeap << ',' << sample.allocs << ',' << sample.allocBytes << '\n';
+  }
+
+  out.close();
+
+  if (out.fail())
+  {
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::ERR, "sweep: failed writing %s", path.c_str());
+    return false;
+  }
+  return true;
+}
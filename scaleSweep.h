@@ -0,0 +1,76 @@
+/**********************************************************************************************************************
+ * Class    : scaleSweep
+ *
+ * Abstract : Measures how the stages of a new world scale with the size of the map and the number of plates, to find
+ *            the stage that stops scaling first.  The cell counts go up ten times at a time, from 1K to 'maxCells'
+ *            (10M by default), the plate counts four times at a time, from 4 to 'maxPlates' (256 by default).  For each
+ *            pair a world is made from scratch, phase by phase:
+ *               grid     -- hexGrid::build and hexGrid::buildNeighbors, for a map of 4:3 with hexagons of size 8,
+ *               centers  -- the plate centers (see benchmark::placeCenters),
+ *               growth   -- plateGrowth, until the map is covered,
+ *               motion   -- the motion vectors and the plateMotion kernel,
+ *               timeStep -- 'cntSteps' time steps of 10M years (long enough for every plate to move).
+ *            Each phase records its wall time, the peak RSS and the peak heap during the phase, and the number and
+ *            bytes of its allocations (see memStats.h, which must be linked into the program).  Growth and time steps
+ *            use a threadPool if asked for, everything else runs on the calling thread; all seeds are fixed.
+ *            'print' shows a table per plate count, with the scaling exponent of each phase: the slope of log(time)
+ *            over log(cells) from the cell count below, so 1 is linear and a phase above 1 goes superlinear.
+ *            'writeCsv' writes one row per phase of each world.
+ *
+ * History  : created Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+
+#ifndef _scaleSweep_h_
+#define _scaleSweep_h_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class threadPool;
+
+class scaleSweep
+{
+public:
+  enum phase : std::uint8_t { GRID = 0, CENTERS = 1, GROWTH = 2, MOTION = 3, TIMESTEP = 4, CNT_PHASES = 5 };
+
+  typedef struct sample
+  {
+    uint64_t  cells;
+    uint32_t  plates;
+    uint8_t   phase;
+    double    seconds;
+    uint64_t  peakRss;                     // bytes
+    uint64_t  peakHeap;                    // bytes allocated through new at the peak, above those in use before
+    uint64_t  allocs;
+    uint64_t  allocBytes;
+  } sampleT;
+
+  scaleSweep(uint64_t maxCells = 10000000, uint32_t maxPlates = 256, uint32_t cntThreads = 0, uint32_t cntSteps = 5);
+  ~scaleSweep();
+
+  void     run();
+  void     runOne(uint64_t cells, uint32_t cntPlates);
+
+  const std::vector<sampleT>& getSamples() const { return m_samples; }
+  double   scaling(size_t ndx) const;
+  void     print() const;
+  bool     writeCsv(const std::string& path) const;
+
+  static const char* phaseName(uint8_t phase);
+
+private:
+  uint64_t              m_maxCells;
+  uint32_t              m_maxPlates;
+  uint32_t              m_cntSteps;            // time steps of the last phase
+  threadPool*           m_pool;                // for growth and time steps, nullptr => serial
+  std::vector<sampleT>  m_samples;
+
+  void     begin(double* start);
+  void     end(uint64_t cells, uint32_t cntPlates, uint8_t phase, double start);
+
+  scaleSweep(const scaleSweep&) = delete;
+  scaleSweep& operator=(const scaleSweep&) = delete;
+};
+
+#endif
@@ -0,0 +1,992 @@
+
+#include "simulation.h"
+#include "plateGrowth.h"
+#include "plateMotion.h"
+#include "threadPool.h"
+#include "worldFile.h"
+#include "history.h"
+#include "worldSaver.h"
+#include "logger.h"
+
+#include <cmath>
+#include <algorithm>
+#include <future>
+#include <memory>
+#include <sstream>
+
+static const std::chrono::milliseconds publishInterval(16);        // publish at most ~60 snapshots a second
+static const double_t mapSpan = 4.0075E9;                           // cm, the width of the map spans the equator
+
+
+/**********************************************************************************************************************
+ * Function: simulation
+ *
+ * Abstract: Constructs an empty simulation and starts its worker thread.
+ *
+ * Input   : cntThreads -- [in] number of threads used by the parallel kernels, 0 => one per hardware core
+ *           seed       -- [in] seed for the random number generator
+ *
+ * Returns : none
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+simulation::simulation(uint32_t cntThreads, uint32_t seed) : m_props(), m_width(0), m_height(0), m_phase(phase::EMPTY), m_step(0), m_claimed(0), m_curTime(0),
+                                                             m_seed(seed), m_gen(seed), m_motion(nullptr), m_history(nullptr), m_keyInterval(0), m_checkpointer(nullptr), m_serial(0), m_bAllDirty(true), m_bAsLoaded(false), m_cntLogged(0), m_fullSerial(0), m_cntCellLog(0), m_cellFrom(0), m_elevFrom(0), m_bElevDirty(false), m_ackSerial(0), m_bSide(false), m_bBusy(false), m_bQuit(false), m_bStop(false)
+{
+  m_pool = new threadPool(cntThreads);
+  m_checkpointer = new worldSaver();
+  m_logger = CLogger::getInstance();
+  m_worker = std::thread(&simulation::workerLoop, this);
+
+  CLogger::getInstance()->outMsg(cmdLine, CLogger::level::INFO, "simulation started, seed %u, %d threads", m_seed, m_pool->getCount());
+}
+
+
+simulation::~simulation()
+{
+  {
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_commands.clear();
+    m_bQuit = true;
+    m_bStop = true;
+  }
+  m_cvCommand.notify_all();
+
+  m_worker.join();
+  delete m_checkpointer;                                              // finishes the checkpoint being written
+  delete m_history;
+  delete m_motion;
+  delete m_pool;
+}
+
+
+void simulation::newMap(const imageProps& props) { post([this, props]() { doNewMap(props); }); }
+void simulation::placeCenters(uint32_t cntPlates) { post([this, cntPlates]() { doPlaceCenters(cntPlates); }); }
+void simulation::growPlates(uint32_t delayMs) { post([this, delayMs]() { doGrowPlates(delayMs); }); }
+void simulation::genMotion() { post([this]() { doGenMotion(); }); }
+void simulation::timeStep(uint64_t years) { post([this, years]() { doTimeStep(years); }); }
+bool simulation::save(const std::string& path) { return call([this, path]() { return doSave(path); }); }
+bool simulation::load(const std::string& path) { return call([this, path]() { return doLoad(path); }); }
+void simulation::record(const std::string& path, uint32_t keyInterval) { post([this, path, keyInterval]() { doRecord(path, keyInterval); }); }
+void simulation::saveAsync(worldSaver* saver) { postSide([this, saver]() { doSnapshot(saver); }); }
+void simulation::checkpoint(const std::string& path, uint32_t seconds) { post([this, path, seconds]() { doCheckpoint(path, seconds); }); }
+
+
+void simulation::prepPlates()
+{
+  post([this]()
+    {
+      // nothing to compute: growth leaves every plate with its border, and the elevations are changed by the motion
+      // alone, so this step only lets the motion be generated
+      if (m_phase == phase::PLATES) m_phase = phase::PREPARED;
+    });
+}
+
+
+/**********************************************************************************************************************
+ * Function: run
+ *
+ * Abstract: Queues a full run of the simulation.  The stages that have not been done yet (centers, plates, motion) are
+ *           done first, then the plates are moved one time step at a time until maxTime is reached or the run is
+ *           stopped.
+ *
+ * Input   : cntPlates -- [in] number of plates, used if the centers have not been placed yet
+ *           years     -- [in] length of a time step in years
+ *           maxTime   -- [in] time at which the run ends, in years
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber) -- moved here from terrainGen::onSimRun
+ *********************************************************************************************************************/
+void simulation::run(uint32_t cntPlates, uint64_t years, uint64_t maxTime)
+{
+  post([this, cntPlates, years, maxTime]()
+    {
+      if (m_phase < phase::CENTERS) doPlaceCenters(cntPlates);
+      if (m_phase < phase::PLATES) doGrowPlates(0);
+      if (m_phase == phase::PLATES) m_phase = phase::PREPARED;
+      if (m_phase < phase::MOTION) doGenMotion();
+
+      if ((m_phase != phase::MOTION) || (years == 0)) return;
+
+      while ((m_curTime < maxTime) && !m_bStop)
+        doTimeStep(years);
+
+      CLogger::getInstance()->outMsg(cmdLine, CLogger::level::INFO, "run %s at %llu years", (m_bStop ? "stopped" : "complete"), (unsigned long long)m_curTime);
+    });
+}
+
+
+/**********************************************************************************************************************
+ * Function: stop
+ *
+ * Abstract: Drops every queued command and asks the running command, if any, to return as soon as it can.  Only the
+ *           command running at the time of the call is stopped, commands queued afterwards run normally.
+ *
+ * Input   : void
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void simulation::stop()
+{
+  std::lock_guard<std::mutex> guard(m_lock);
+
+  m_commands.clear();
+  if (m_bBusy) m_bStop = true;
+}
+
+
+/**********************************************************************************************************************
+ * Function: acquire
+ *
+ * Abstract: Makes the newest snapshot available through 'snapshot', and tells the worker that the GUI now shows it so
+ *           that later snapshots list the cells changed since this one.
+ *
+ * Input   : void
+ *
+ * Returns : true if there is a new snapshot, false if nothing has been published since the last call
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+bool simulation::acquire()
+{
+  if (!m_snapshots.acquire()) return false;
+
+  m_ackSerial.store(m_snapshots.front().serial, std::memory_order_release);
+  return true;
+}
+
+
+void simulation::wait()
+{
+  std::unique_lock<std::mutex> guard(m_lock);
+  m_cvIdle.wait(guard, [this]() { return (m_commands.empty() && m_side.empty() && !m_bBusy); });
+}
+
+
+void simulation::post(std::function<void()> cmd)
+{
+  {
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_commands.push_back(std::move(cmd));
+  }
+  m_cvCommand.notify_one();
+}
+
+
+void simulation::postSide(std::function<void()> cmd)
+{
+  {
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_side.push_back(std::move(cmd));
+    m_bSide = true;
+  }
+  m_cvCommand.notify_one();
+}
+
+
+/**********************************************************************************************************************
+ * Function: runSide
+ *
+ * Abstract: Runs the side commands queued so far.  Called by the worker before it takes the next command, and by long
+ *           running commands between their steps, where the state is consistent.  Costs one atomic load when there is
+ *           nothing to run.
+ *
+ * Input   : void
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void simulation::runSide()
+{
+  std::deque<std::function<void()>> side;
+
+  if (!m_bSide.load(std::memory_order_acquire)) return;
+
+  {
+    std::lock_guard<std::mutex> guard(m_lock);
+    side.swap(m_side);
+    m_bSide = false;
+  }
+
+  for (std::function<void()>& cmd : side) cmd();
+}
+
+
+/**********************************************************************************************************************
+ * Function: call
+ *
+ * Abstract: Queues a command and waits for its result.  If the command is dropped by 'stop' before it runs, the result
+ *           is false.
+ *
+ * Input   : cmd -- [in] the command
+ *
+ * Returns : the value returned by the command
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+bool simulation::call(std::function<bool()> cmd)
+{
+  std::shared_ptr<std::promise<bool>> done = std::make_shared<std::promise<bool>>();
+  std::future<bool>                   result = done->get_future();
+
+  post([done, cmd]() { done->set_value(cmd()); });
+
+  try
+  {
+    return result.get();
+  }
+  catch (const std::future_error&)                                    // the command was dropped
+  {
+    return false;
+  }
+}
+
+
+void simulation::workerLoop()
+{
+  CLogger::setThreadInstance(m_logger);
+
+  for (;;)
+  {
+    std::function<void()> cmd;
+
+    {
+      std::unique_lock<std::mutex> guard(m_lock);
+      m_cvCommand.wait(guard, [this]() { return (m_bQuit || !m_commands.empty() || !m_side.empty()); });
+
+      if (m_bQuit) return;
+
+      if (m_side.empty())
+      {
+        cmd = std::move(m_commands.front());
+        m_commands.pop_front();
+        m_bStop = false;
+      }
+      m_bBusy = true;
+    }
+
+    runSide();                                                        // side commands go before the next command
+    if (cmd)
+    {
+      cmd();
+      publish(true, false);                                           // the state at the end of every command
+    }
+
+    {
+      std::lock_guard<std::mutex> guard(m_lock);
+      m_bBusy = false;
+      if (m_commands.empty() && m_side.empty()) m_cvIdle.notify_all();
+    }
+  }
+}
+
+
+/**********************************************************************************************************************
+ * Function: publish
+ *
+ * Abstract: Copies the current state into the back slot of the triple buffer and publishes it.  Unless forced, a
+ *           snapshot is only published if the last one is at least one publishing interval old, so that the
+ *           simulation does not spend its time copying states that the GUI will never draw.
+ *           The cells changed since the last publish are logged with the serial of the snapshot.  The cells are left
+ *           out of the snapshot until the map loaded from a file changes.  The snapshot lists
+ *           the cells of every logged snapshot newer than the one the GUI acknowledged, older entries are dropped.
+ *           The cell arrays of a slot are brought up to date from the changes published since the slot was last
+ *           filled (m_cellLog, kept up to a quarter of the map), so a publish costs the cells changed, not the map.
+ *           They are copied whole only when every cell changed or the slot is older than the log.  The time steps
+ *           change the elevation of every cell that moves without listing it, so after a time step the elevations
+ *           are copied whole.
+ *
+ * Input   : force -- [in] publish even if the last snapshot is recent
+ *           busy  -- [in] value of simSnapshot::busy
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void simulation::publish(bool force, bool busy)
+{
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+  if (!force && (now - m_lastPublish < publishInterval)) return;
+  m_lastPublish = now;
+
+  simSnapshot& snap = m_snapshots.back();
+  uint32_t     cntCells = m_grid.getCount();
+
+  uint64_t ack = m_ackSerial.load(std::memory_order_acquire);
+
+  while (!m_dirtyLog.empty() && (m_dirtyLog.front().first <= ack))            // the GUI has seen these changes
+  {
+    m_cntLogged -= m_dirtyLog.front().second.size();
+    m_dirtyLog.pop_front();
+  }
+
+  snap.serial = ++m_serial;
+  if (!m_dirty.empty()) m_bAsLoaded = false;
+
+  if (m_bAllDirty)                                                             // changes for the cell arrays of the slots
+  {
+    m_cellLog.clear();
+    m_cntCellLog = 0;
+    m_cellFrom = snap.serial;
+  }
+  else if (!m_dirty.empty())
+  {
+    m_cellLog.emplace_back(snap.serial, m_dirty);
+    m_cntCellLog += m_dirty.size();
+    while (m_cntCellLog > cntCells / 4)
+    {
+      m_cntCellLog -= m_cellLog.front().second.size();
+      m_cellFrom = m_cellLog.front().first;
+      m_cellLog.pop_front();
+    }
+  }
+  if (m_bElevDirty) m_elevFrom = snap.serial;
+  m_bElevDirty = false;
+
+  if (m_bAllDirty || (m_cntLogged + m_dirty.size() > cntCells / 4))           // cheaper to redraw everything
+  {
+    m_fullSerial = snap.serial;
+    m_dirtyLog.clear();
+    m_cntLogged = 0;
+  }
+  else if (!m_dirty.empty())
+  {
+    m_cntLogged += m_dirty.size();
+    m_dirtyLog.emplace_back(snap.serial, std::move(m_dirty));
+  }
+  m_dirty.clear();
+  m_bAllDirty = false;
+
+  snap.allDirty = (m_fullSerial > ack);
+  snap.dirty.clear();
+  if (!snap.allDirty)
+    for (const std::pair<uint64_t, std::vector<uint32_t>>& entry : m_dirtyLog)
+      snap.dirty.insert(snap.dirty.end(), entry.second.begin(), entry.second.end());
+
+  snap.phase = m_phase;
+  snap.busy = busy;
+  snap.step = m_step;
+  snap.claimed = m_claimed;
+  snap.curTime = m_curTime;
+  snap.recording = !m_historyPath.empty();
+  if (m_bAsLoaded)                                                             // the GUI maps the same file, copying
+  {                                                                            // the cells would read all of it
+    snap.plate.clear();
+    snap.style.clear();
+    snap.elevation.clear();
+  }
+  else if ((snap.plate.size() != cntCells) || (snap.cellSerial < m_cellFrom))
+  {
+    snap.plate.assign(m_grid.plates(), m_grid.plates() + cntCells);
+    snap.style.assign(m_grid.styles(), m_grid.styles() + cntCells);
+    snap.elevation.assign(m_grid.elevations(), m_grid.elevations() + cntCells);
+  }
+  else
+  {
+    for (const std::pair<uint64_t, std::vector<uint32_t>>& entry : m_cellLog)
+    {
+      if (entry.first <= snap.cellSerial) continue;                           // the slot has these already
+
+      for (uint32_t id : entry.second)
+      {
+        snap.plate[id] = m_grid.getPlate(id);
+        snap.style[id] = m_grid.getStyle(id);
+        snap.elevation[id] = m_grid.getElevation(id);
+      }
+    }
+    if (snap.cellSerial < m_elevFrom)
+      snap.elevation.assign(m_grid.elevations(), m_grid.elevations() + cntCells);
+  }
+  snap.cellSerial = m_bAsLoaded ? 0 : snap.serial;
+
+  snap.plates.resize(m_plates.size());
+  for (size_t ndx = 0; ndx < m_plates.size(); ndx++)
+  {
+    snap.plates[ndx].ndx = m_plates[ndx].ndx;
+    snap.plates[ndx].center_x = m_plates[ndx].center_x;
+    snap.plates[ndx].center_y = m_plates[ndx].center_y;
+    snap.plates[ndx].color = m_plates[ndx].color;
+    snap.plates[ndx].speed = (ndx < m_speed.size()) ? m_speed[ndx] : 0;
+    snap.plates[ndx].direction = (ndx < m_direction.size()) ? m_direction[ndx] : 0;
+  }
+
+  m_snapshots.publish();
+}
+
+
+/**********************************************************************************************************************
+ * Function: markDirty
+ *
+ * Abstract: Adds cells to the list of cells changed since the last publish.  Once the list would hold more than a
+ *           quarter of the map it is dropped and the whole map is marked as changed.
+ *
+ * Input   : cells -- [in] ids of the changed cells
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void simulation::markDirty(const std::vector<uint32_t>& cells)
+{
+  if (!cells.empty()) m_bAsLoaded = false;
+  if (m_bAllDirty) return;
+
+  if (m_dirty.size() + cells.size() > m_grid.getCount() / 4)
+  {
+    m_bAllDirty = true;
+    m_dirty.clear();
+    return;
+  }
+
+  m_dirty.insert(m_dirty.end(), cells.begin(), cells.end());
+}
+
+
+void simulation::doNewMap(imageProps props)
+{
+  uint32_t rows;
+  uint32_t cols;
+
+  stopRecording();
+  delete m_motion;
+  m_motion = nullptr;
+  m_plates.clear();
+  m_speed.clear();
+  m_direction.clear();
+  m_step = 0;
+  m_claimed = 0;
+  m_curTime = 0;
+  m_props = props;
+  m_width = props.imageWidth;
+  m_height = props.imageHeight;
+  m_bAllDirty = true;
+  m_bAsLoaded = false;
+
+  rows = 0;                                                           // stay 0 if the rows or columns do not fit 32 bits
+  cols = 0;
+  if ((props.hexagonSize > 0) && (props.imageWidth / props.hexagonSize < 2E9) && (props.imageHeight / props.hexagonSize < 2E9) &&
+      !hexGrid::dimensions(props.hexagonOrient, props.hexagonSize, props.imageWidth, props.imageHeight, &rows, &cols))
+  {
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::ERR, "simulation: unsupported orientation %d", (int)props.hexagonOrient);
+    m_grid.clear();
+    m_phase = phase::EMPTY;
+    return;
+  }
+
+  if ((rows == 0) || (cols == 0) || ((uint64_t)rows * cols >= noCell))
+  {
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::ERR, "simulation: a map of %.1f x %.1f with hexagons of size %.1f has no cells, or too many",
+                                   props.imageWidth, props.imageHeight, props.hexagonSize);
+    m_grid.clear();
+    m_phase = phase::EMPTY;
+    return;
+  }
+
+  m_grid.build(props.hexagonOrient, props.hexagonSize, rows, cols);
+  m_phase = phase::GRID;
+}
+
+
+/**********************************************************************************************************************
+ * Function: centerMargin
+ *
+ * Abstract: The distance a plate center keeps from the edges of the image, about one hexagon.  A map must be more than
+ *           twice this wide and high to hold a center.
+ *
+ * Input   : orient -- [in] orientation of the hexagons
+ *           size   -- [in] size of a hexagon
+ *
+ * Returns : the margin, in scene units
+ *
+ * Written : Oct 2026 (gkhuber) -- moved here from doPlaceCenters
+ *********************************************************************************************************************/
+double_t simulation::centerMargin(uint8_t orient, double_t size)
+{
+  if (orient == hexGrid::orien::HORIZONTAL) return size * (1 + 2 * sin30);
+  if (orient == hexGrid::orien::VERTICAL) return 2 * size * cos30;
+  return size;
+}
+
+
+/**********************************************************************************************************************
+ * Function: doPlaceCenters
+ *
+ * Abstract: Randomly chooses the plate centers, at least one grid cell away from the edge of the image.  The cell
+ *           holding each center is claimed by its plate and becomes the plate's border.
+ *
+ * Input   : cntPlates -- [in] number of plates to create
+ *
+ * Returns : void
+ *
+ * Written : Dec 2021 (GKHuber) as terrainGen::onSimCenters
+ *           Oct 2026 (gkhuber) -- moved to the simulation thread
+ *********************************************************************************************************************/
+void simulation::doPlaceCenters(uint32_t cntPlates)
+{
+  double_t margin = centerMargin(m_grid.getOrient(), m_grid.getSize());
+
+  if (m_phase != phase::GRID)
+  {
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::WARNING, "simulation: plate centers need a new map");
+    return;
+  }
+
+  if ((cntPlates == 0) || (cntPlates > 0xFFFF) || (cntPlates > m_grid.getCount()))       // a cell holds its plate in 16 bits
+  {
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::ERR, "simulation: %u plates do not fit a map of %u cells", cntPlates, m_grid.getCount());
+    return;
+  }
+
+  if ((m_width <= 2 * margin) || (m_height <= 2 * margin))           // no point is a margin away from every edge
+  {
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::ERR, "simulation: a map of %.1f x %.1f is too small for plate centers %.1f from its edges",
+                                   m_width, m_height, margin);
+    return;
+  }
+
+  CLogger::getInstance()->outMsg(cmdLine, CLogger::level::INFO, "generating %d centers", cntPlates);
+
+  m_plates.assign(cntPlates, platesT());
+
+  std::uniform_real_distribution<>  dist(0.0, 1.0);                 // generates a random real number in range[0,1.0)
+
+  for (uint32_t ndx = 0; ndx < cntPlates; ndx++)
+  {
+    double_t tempX;
+    double_t tempY;
+
+    do                                                               // clamp location to at least one grid cell from image boundary.
+    {
+      tempX = m_width * dist(m_gen);
+      tempY = m_height * dist(m_gen);
+    } while ((tempX < margin) || ((m_width - tempX) < margin) || (tempY < margin) || ((m_height - tempY) < margin));
+
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::INFO, "plate %d: center is at (%.4f, %.4f)", ndx, tempX, tempY);
+
+    m_plates[ndx].ndx = ndx + 1;                                     // set index for plate
+    m_plates[ndx].center_x = tempX;
+    m_plates[ndx].center_y = tempY;
+    m_plates[ndx].color = plateColor(ndx);
+
+    uint32_t cellID = m_grid.cellAt(pointF(tempX, tempY));          // hexagon holding the center
+    if (cellID != noCell)
+    {
+      m_grid.setPlate(cellID, m_plates[ndx].ndx);
+      m_grid.setStyle(cellID, bFilled | bColor | bDispCenter);
+      m_plates[ndx].vec.push_back(cellID);                           // add hex to plate list
+      m_dirty.push_back(cellID);
+      m_claimed++;
+
+      CLogger::getInstance()->outMsg(cmdLine, CLogger::level::DEBUG, "hexagon %d belongs to plate %d", cellID, ndx);
+    }
+  }
+
+  m_phase = phase::CENTERS;
+}
+
+
+/**********************************************************************************************************************
+ * Function: doGrowPlates
+ *
+ * Abstract: Grows the plates out from their centers until the whole map is covered.  A snapshot is offered to the GUI
+ *           after every step (it is only published if the publishing interval has passed).
+ *
+ * Input   : delayMs -- [in] pause between steps, used to animate the growth.  0 runs the growth as fast as possible
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void simulation::doGrowPlates(uint32_t delayMs)
+{
+  if (m_phase != phase::CENTERS)
+  {
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::WARNING, "simulation: plates need their centers placed");
+    return;
+  }
+
+  plateGrowth growth(&m_grid, m_plates.data(), (uint32_t)m_plates.size(), m_pool);
+
+  while (!m_bStop && growth.step())
+  {
+    markDirty(growth.getChanged());
+    m_step = growth.getStep();
+    m_claimed = growth.getClaimed();
+    publish(delayMs > 0);
+    runSide();
+
+    if (delayMs > 0) std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
+  }
+
+  m_step = growth.getStep();
+  m_claimed = growth.getClaimed();
+  if (growth.isDone()) m_phase = phase::PLATES;
+
+  CLogger::getInstance()->outMsg(cmdLine, CLogger::level::INFO, "plate growth %s after %d steps, %llu cells claimed", (growth.isDone() ? "complete" : "stopped"),
+                                 m_step, (unsigned long long)m_claimed);
+}
+
+
+/**********************************************************************************************************************
+ * Function: doGenMotion
+ *
+ * Abstract: tectonic plates velocity is between 1 to 10 cm a year, most are in the range of 2 to 5 cm a year.  assume
+ *           a normally distributed velociy with \mu = 4.5, and \sigma = 2.0, and a uniformly distributed direction.
+ *
+ * Input   : void
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber) -- moved here from terrainGen::onSimMotion
+ *********************************************************************************************************************/
+void simulation::doGenMotion()
+{
+  std::normal_distribution<double_t>        norDist(4.5, 2.0);
+  std::uniform_real_distribution<double_t>  dirDist(0.0, 360.0);
+
+  if (m_phase != phase::PREPARED)
+  {
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::WARNING, "simulation: motion needs finalized plates");
+    return;
+  }
+
+  m_speed.resize(m_plates.size());
+  m_direction.resize(m_plates.size());
+
+  for (size_t ndx = 0; ndx < m_plates.size(); ndx++)
+  {
+    double_t plateSpeed = norDist(m_gen);
+    if (plateSpeed < 0) plateSpeed = 2.0;
+
+    m_speed[ndx] = plateSpeed;
+    m_direction[ndx] = dirDist(m_gen);
+
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::INFO, "plate %d: speed %.4f, direction %.4f", (int)ndx, m_speed[ndx], m_direction[ndx]);
+  }
+
+  delete m_motion;
+  m_motion = new plateMotion(&m_grid, m_plates.data(), (uint32_t)m_plates.size(), m_speed.data(), m_direction.data(), mapSpan / m_width, m_pool);
+
+  m_phase = phase::MOTION;
+}
+
+
+/**********************************************************************************************************************
+ * Function: doTimeStep
+ *
+ * Abstract: simulates the plates moving for a single time step, see plateMotion::step.  When recording, the step is
+ *           appended to the history file, which is created first if this is the first step recorded.
+ *
+ * Input   : years -- [in] length of the time step
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber) -- moved here from terrainGen::onSimTimeDelta
+ *********************************************************************************************************************/
+void simulation::doTimeStep(uint64_t years)
+{
+  if (m_phase != phase::MOTION) return;
+  if (!m_historyPath.empty() && (nullptr == m_history)) startRecording();
+
+  if (m_motion->step(years))
+  {
+    m_bAsLoaded = false;                                              // elevations change without being listed
+    m_bElevDirty = true;
+    markDirty(m_motion->getChanged());
+  }
+
+  m_curTime += years;
+  if ((nullptr != m_history) && !m_history->append(m_grid, m_plates.data(), m_curTime)) stopRecording();
+
+  publish(false);
+  runSide();
+  if (!m_checkpointPath.empty() && (std::chrono::steady_clock::now() >= m_nextCheckpoint)) takeCheckpoint();
+}
+
+
+/**********************************************************************************************************************
+ * Function: getState
+ *
+ * Abstract: Copies the state of the simulation, all but the cells, for a terrain file.  The generator is copied as the
+ *           text std::mt19937 writes itself as, which holds its whole state, and the plate motion as the displacement
+ *           it has not applied yet, so that a run loaded from the file carries on exactly as this one.
+ *
+ * Input   : state -- [out] the state
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *           Oct 2026 (gkhuber) -- generator and residual displacements
+ *********************************************************************************************************************/
+void simulation::getState(worldState* state) const
+{
+  std::ostringstream generator;
+
+  generator << m_gen;
+
+  state->props = m_props;
+  state->plates = m_plates;
+  state->speed = m_speed;
+  state->direction = m_direction;
+  state->seed = m_seed;
+  state->phase = m_phase;
+  state->step = m_step;
+  state->claimed = m_claimed;
+  state->curTime = m_curTime;
+  state->generator = generator.str();
+  state->residX.clear();
+  state->residY.clear();
+  if (nullptr != m_motion)
+  {
+    state->residX = m_motion->getResidX();
+    state->residY = m_motion->getResidY();
+  }
+}
+
+
+/**********************************************************************************************************************
+ * Function: doSave
+ *
+ * Abstract: Writes the state of the simulation to a terrain file.
+ *
+ * Input   : path -- [in] name of the file
+ *
+ * Returns : true if the file was written
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+bool simulation::doSave(const std::string& path)
+{
+  worldState state;
+
+  if (m_phase == phase::EMPTY)
+  {
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::WARNING, "simulation: there is no map to save");
+    return false;
+  }
+
+  m_grid.detachCells();                                               // the file may be the one the grid is mapped from
+  getState(&state);
+
+  return worldFile::write(path, state, m_grid);
+}
+
+
+/**********************************************************************************************************************
+ * Function: doSnapshot
+ *
+ * Abstract: Copies the state of the simulation and hands the copy to a saver, which writes it on its own thread.  Runs
+ *           as a side command, so the copy is of the state between two steps.  The copy of the cells is about 7 bytes
+ *           a cell, a few milliseconds for a large map.
+ *
+ * Input   : saver -- [in/out] saver reserved for the save by worldSaver::begin
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void simulation::doSnapshot(worldSaver* saver)
+{
+  std::unique_ptr<worldState> state;
+  std::unique_ptr<hexGrid> grid;
+  uint32_t cntCells = m_grid.getCount();
+
+  if (m_phase == phase::EMPTY)
+  {
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::WARNING, "simulation: there is no map to save");
+    saver->abandon();
+    return;
+  }
+
+  m_grid.detachCells();                                               // the file may be the one the grid is mapped from
+
+  state.reset(new worldState);
+  getState(state.get());
+
+  grid.reset(new hexGrid);
+  grid->build(m_grid.getOrient(), m_grid.getSize(), m_grid.getRows(), m_grid.getCols());
+  std::copy(m_grid.plates(), m_grid.plates() + cntCells, grid->plates());
+  std::copy(m_grid.styles(), m_grid.styles() + cntCells, grid->styles());
+  std::copy(m_grid.elevations(), m_grid.elevations() + cntCells, grid->elevations());
+
+  saver->write(std::move(state), std::move(grid));
+}
+
+
+/**********************************************************************************************************************
+ * Function: doLoad
+ *
+ * Abstract: Replaces the state of the simulation with the one in a terrain file.  The file is read into a separate grid
+ *           first, so a file that cannot be read leaves the simulation as it was.  The grid uses the cell arrays of the
+ *           file in place (see worldFile::read), and the snapshots leave the cells out until they change, so loading
+ *           a file does not read the cells at all.  The generator and the plate motion are restored as they were
+ *           saved, so the run carries on exactly as the one that saved the file.  An older file without them has the
+ *           generator seeded again from the seed of the file, and the plates carry on with nothing left over from the
+ *           steps before the save.
+ *
+ * Input   : path -- [in] name of the file
+ *
+ * Returns : true if the file was read
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+bool simulation::doLoad(const std::string& path)
+{
+  worldState state;
+  hexGrid    grid;
+
+  if (!worldFile::read(path, &state, &grid)) return false;
+
+  stopRecording();
+  delete m_motion;
+  m_motion = nullptr;
+
+  m_grid.swap(grid);
+  m_props = state.props;
+  m_width = m_props.imageWidth;
+  m_height = m_props.imageHeight;
+  m_plates.swap(state.plates);
+  m_speed.swap(state.speed);
+  m_direction.swap(state.direction);
+  m_seed = state.seed;
+  m_gen.seed(m_seed);
+  if (!state.generator.empty())
+  {
+    std::istringstream generator(state.generator);
+    generator >> m_gen;
+    if (generator.fail())
+    {
+      CLogger::getInstance()->outMsg(cmdLine, CLogger::level::WARNING, "simulation: %s has a damaged generator state, seeded again", path.c_str());
+      m_gen.seed(m_seed);
+    }
+  }
+  m_phase = std::min(state.phase, (uint8_t)phase::MOTION);
+  m_step = state.step;
+  m_claimed = state.claimed;
+  m_curTime = state.curTime;
+
+  if ((m_phase == phase::MOTION) && ((m_speed.size() != m_plates.size()) || (m_direction.size() != m_plates.size())))
+    m_phase = phase::PREPARED;                                          // the motion vectors are missing, generate them again
+  if (m_phase == phase::MOTION)
+  {
+    m_motion = new plateMotion(&m_grid, m_plates.data(), (uint32_t)m_plates.size(), m_speed.data(), m_direction.data(), mapSpan / m_width, m_pool);
+    if (!state.residX.empty() && !m_motion->setResiduals(state.residX, state.residY))
+      CLogger::getInstance()->outMsg(cmdLine, CLogger::level::WARNING, "simulation: %s has residuals that do not match its plates", path.c_str());
+  }
+
+  m_dirty.clear();
+  m_bAllDirty = true;
+  m_bAsLoaded = true;
+  return true;
+}
+
+
+/**********************************************************************************************************************
+ * Function: doRecord
+ *
+ * Abstract: Starts recording the time steps into a history file, or stops recording.  A recording already under way
+ *           is closed first.  The file itself is created by the next time step (see startRecording).
+ *
+ * Input   : path        -- [in] name of the file, empty to stop recording
+ *           keyInterval -- [in] most frames from one keyframe to the next
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void simulation::doRecord(const std::string& path, uint32_t keyInterval)
+{
+  stopRecording();
+
+  m_historyPath = path;
+  m_keyInterval = keyInterval;
+}
+
+
+/**********************************************************************************************************************
+ * Function: startRecording
+ *
+ * Abstract: Creates the history file and writes the state before the first time step recorded as its first frame.
+ *           If the file cannot be created recording stops.
+ *
+ * Input   : void
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void simulation::startRecording()
+{
+  m_history = new historyWriter();
+
+  if (!m_history->open(m_historyPath, m_grid, m_width, m_height, (uint32_t)m_plates.size(), m_keyInterval) || !m_history->append(m_grid, m_plates.data(), m_curTime))
+    stopRecording();
+}
+
+
+void simulation::stopRecording()
+{
+  delete m_history;                                                     // closes the file
+  m_history = nullptr;
+  m_historyPath.clear();
+}
+
+
+/**********************************************************************************************************************
+ * Function: doCheckpoint
+ *
+ * Abstract: Starts or stops taking checkpoints.  The first checkpoint is taken by the first time step after 'seconds'
+ *           have gone by.
+ *
+ * Input   : path    -- [in] name of the checkpoint file, empty to stop taking checkpoints
+ *           seconds -- [in] least time from one checkpoint to the next
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void simulation::doCheckpoint(const std::string& path, uint32_t seconds)
+{
+  m_checkpointPath = path;
+  m_checkpointEvery = std::chrono::seconds(seconds);
+  m_nextCheckpoint = std::chrono::steady_clock::now() + m_checkpointEvery;
+}
+
+
+/**********************************************************************************************************************
+ * Function: takeCheckpoint
+ *
+ * Abstract: Saves the world to the checkpoint file, in the background.  If the checkpoint before is still being
+ *           written this one waits for the next step.  The file is replaced only once the new checkpoint is complete, so a crash
+ *           at any time leaves the last complete one.
+ *           The next checkpoint is due after the interval asked for, or after 100 times what copying the state took,
+ *           whichever is longer, which keeps the cost of checkpoints to the simulation below 1%.
+ *
+ * Input   : void
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void simulation::takeCheckpoint()
+{
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  uint8_t status = m_checkpointer->finish();
+
+  if (status == worldSaver::status::FAILED)
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::WARNING, "simulation: checkpoint to %s failed", m_checkpointPath.c_str());
+
+  if (!m_checkpointer->begin(m_checkpointPath)) return;             // still writing, try again after the next step
+  doSnapshot(m_checkpointer);
+
+  std::chrono::steady_clock::duration cost = std::chrono::steady_clock::now() - start;
+  m_nextCheckpoint = start + std::max(m_checkpointEvery, 100 * cost);
+
+  CLogger::getInstance()->outMsg(cmdLine, CLogger::level::INFO, "simulation: checkpoint at %llu years, state copied in %.1f ms", (unsigned long long)m_curTime,
+                                 std::chrono::duration<double, std::milli>(cost).count());
+}
@@ -0,0 +1,215 @@
+/**********************************************************************************************************************
+ * Class    : simulation
+ *
+ * Abstract : This class owns the state of the simulation (the grid model, the plates and the random number generator)
+ *            and runs every stage of the simulation on its own worker thread, so that the GUI thread never waits on
+ *            the simulation and the simulation never waits on the GUI.
+ *            The GUI drives the simulation by queueing commands ('placeCenters', 'growPlates', 'timeStep', 'run',
+ *            ...); the commands are executed in order on the worker thread.  Long running commands check for 'stop'
+ *            between steps.
+ *            The GUI never touches the state of the simulation directly.  Instead the worker publishes an immutable
+ *            snapshot of the state through a lock-free triple buffer (see tripleBuffer.h) after each command, and
+ *            during long running commands at most once per publishing interval.  The GUI calls 'acquire' from a
+ *            frame timer and reads the newest snapshot with 'snapshot'.
+ *            Each snapshot also lists the cells that changed since the snapshot the GUI acquired last, so that the
+ *            GUI only has to redraw those.  Because the GUI may skip snapshots, the worker keeps the changes of every
+ *            snapshot the GUI has not acknowledged yet (see 'acquire') and merges them into the next one.  If the
+ *            list grows past a quarter of the map the snapshot is marked 'allDirty' instead.
+ *            Once the motion vectors are generated each time step moves the plates with a plateMotion kernel.
+ *            'save' and 'load' write and read the state as a terrain file (see worldFile.h).  They are commands as well,
+ *            so they wait for the commands queued before them, and block the caller until they are done.
+ *            'saveAsync' does not wait: it queues a side command, which the worker runs before the next command or,
+ *            during a long running command, between two of its steps.  Side commands are not dropped by 'stop'.  The
+ *            side command copies the state and hands the copy to a worldSaver, which writes it on its own thread.
+ *            A saved world holds the whole state, the generator and what the plates have not been moved by yet
+ *            included, so a run loaded from a file carries on bit for bit as the run that saved it.
+ *            'checkpoint' has the time steps save the world to a file every so often, the same way as 'saveAsync', so
+ *            a long run can be restarted where it was ('load' the file, then 'run' again) after a crash.  The copy of
+ *            the state is the only cost to the simulation, and checkpoints are spaced so that it stays below 1% of
+ *            the time spent stepping.
+ *            The worker logs to the logger of the thread that created the simulation (see CLogger::getInstance), so
+ *            simulations run side by side on threads with loggers of their own do not share one.
+ *            'record' writes every time step into a history file (see history.h) until it is called with no file, the
+ *            map is replaced, or the file cannot be written.  The file is created by the first time step, so recording
+ *            can be asked for before the plates exist.
+ *
+ * History  : created Oct 2026 (gkhuber)
+ *            Oct 2026 (gkhuber) time steps move the plates
+ *            Oct 2026 (gkhuber) snapshots carry the cells that changed
+ *            Oct 2026 (gkhuber) the state can be saved to, and loaded from, a terrain file
+ *            Oct 2026 (gkhuber) time steps can be recorded into a history file
+ *            Oct 2026 (gkhuber) side commands, the state can be saved without waiting for the running command
+ *            Oct 2026 (gkhuber) the whole state is saved, checkpoints
+ *********************************************************************************************************************/
+
+#ifndef _simulation_h_
+#define _simulation_h_
+
+#include <cstdint>
+#include <vector>
+#include <deque>
+#include <random>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <chrono>
+#include <utility>
+#include <string>
+
+#include "constants.h"
+#include "hexGrid.h"
+#include "tripleBuffer.h"
+
+class threadPool;
+class plateMotion;
+class historyWriter;
+class worldSaver;
+class CLogger;
+struct worldState;
+
+struct plateSnapshot
+{
+  uint32_t ndx;                                 // index of the plate (platesT::ndx)
+  double_t center_x;
+  double_t center_y;
+  uint32_t color;                               // 0xAARRGGBB
+  double_t speed;                               // cm / year, 0 until the motion vectors are generated
+  double_t direction;                           // degrees
+};
+
+struct simSnapshot
+{
+  uint64_t                    serial = 0;       // incremented on every publish
+  uint8_t                     phase = 0;        // simulation::phase reached
+  bool                        busy = false;     // true while a command is running
+  uint32_t                    step = 0;         // growth step
+  uint64_t                    claimed = 0;      // cells claimed by the plates
+  uint64_t                    curTime = 0;      // simulated time in years
+  bool                        recording = false;  // time steps are written to a history file
+  std::vector<uint16_t>       plate;            // per cell, see hexGrid; empty while the cells are those of the file loaded
+  std::vector<uint8_t>        style;
+  std::vector<float>          elevation;
+  std::vector<plateSnapshot>  plates;
+  bool                        allDirty = true;  // every cell must be redrawn
+  std::vector<uint32_t>       dirty;            // otherwise, the cells changed since the snapshot the GUI acquired last
+  uint64_t                    cellSerial = 0;   // the cell arrays hold the cells as of this snapshot, for the simulation
+};
+
+class simulation
+{
+public:
+  enum phase : std::uint8_t { EMPTY = 0, GRID = 1, CENTERS = 2, PLATES = 3, PREPARED = 4, MOTION = 5 };
+
+  simulation(uint32_t cntThreads = 0, uint32_t seed = std::random_device{}());
+  ~simulation();
+
+  // commands, queued and executed in order on the simulation thread
+  void newMap(const imageProps& props);
+  void placeCenters(uint32_t cntPlates);
+  void growPlates(uint32_t delayMs = 0);
+  void prepPlates();
+  void genMotion();
+  void timeStep(uint64_t years);
+  void run(uint32_t cntPlates, uint64_t years, uint64_t maxTime);
+  bool save(const std::string& path);
+  bool load(const std::string& path);
+  void record(const std::string& path, uint32_t keyInterval = 100);
+  void saveAsync(worldSaver* saver);
+  void checkpoint(const std::string& path, uint32_t seconds);
+
+  void stop();                                  // abandons the running command and all queued commands
+  void wait();                                  // blocks until the queue is empty and the worker is idle
+
+  // snapshots, GUI thread only
+  bool acquire();
+  const simSnapshot& snapshot() const { return m_snapshots.front(); }
+
+  uint32_t getSeed() const { return m_seed; }
+
+  static double_t centerMargin(uint8_t orient, double_t size);
+
+private:
+  // state of the simulation, only touched on the worker thread
+  imageProps              m_props;                // properties of the map
+  hexGrid                 m_grid;
+  std::vector<platesT>    m_plates;
+  std::vector<double_t>   m_speed;                // per plate, cm / year
+  std::vector<double_t>   m_direction;            // per plate, degrees
+  double_t                m_width;                // size of the image
+  double_t                m_height;
+  uint8_t                 m_phase;
+  uint32_t                m_step;
+  uint64_t                m_claimed;
+  uint64_t                m_curTime;
+  uint32_t                m_seed;
+  std::mt19937            m_gen;
+  threadPool*             m_pool;
+  plateMotion*            m_motion;               // moves the plates, created with the motion vectors
+  historyWriter*          m_history;              // records the time steps, opened by the first one
+  std::string             m_historyPath;          // history file, empty when not recording
+  uint32_t                m_keyInterval;          // most frames from one keyframe to the next
+  worldSaver*             m_checkpointer;         // writes the checkpoints
+  std::string             m_checkpointPath;       // checkpoint file, empty when not checkpointing
+  std::chrono::steady_clock::duration   m_checkpointEvery;  // least time from one checkpoint to the next
+  std::chrono::steady_clock::time_point m_nextCheckpoint;
+
+  // snapshots handed to the GUI
+  tripleBuffer<simSnapshot>             m_snapshots;
+  uint64_t                              m_serial;
+  std::chrono::steady_clock::time_point m_lastPublish;
+  std::vector<uint32_t>                 m_dirty;          // cells changed since the last publish
+  bool                                  m_bAllDirty;      // every cell changed since the last publish
+  bool                                  m_bAsLoaded;      // no cell changed since the map was loaded from a file
+  std::deque<std::pair<uint64_t, std::vector<uint32_t>>>  m_dirtyLog;   // changes of the snapshots not yet acknowledged
+  uint64_t                              m_cntLogged;      // number of cells in m_dirtyLog
+  uint64_t                              m_fullSerial;     // last snapshot marked allDirty
+  std::deque<std::pair<uint64_t, std::vector<uint32_t>>>  m_cellLog;    // changes of recent snapshots, to update the slots
+  uint64_t                              m_cntCellLog;     // number of cells in m_cellLog
+  uint64_t                              m_cellFrom;       // a slot whose cells are older than this is copied whole
+  uint64_t                              m_elevFrom;       // a slot whose elevations are older than this copies them whole
+  bool                                  m_bElevDirty;     // elevations changed, not just of the cells in m_dirty
+  std::atomic<uint64_t>                 m_ackSerial;      // last snapshot acquired by the GUI
+
+  // command queue
+  std::thread                           m_worker;
+  CLogger*                              m_logger;         // logger of the thread that created the simulation
+  std::deque<std::function<void()>>     m_commands;
+  std::deque<std::function<void()>>     m_side;           // side commands, run between the steps of a command
+  std::atomic<bool>                     m_bSide;          // m_side is not empty
+  std::mutex                            m_lock;
+  std::condition_variable               m_cvCommand;
+  std::condition_variable               m_cvIdle;
+  bool                                  m_bBusy;
+  bool                                  m_bQuit;
+  std::atomic<bool>                     m_bStop;
+
+  void post(std::function<void()> cmd);
+  void postSide(std::function<void()> cmd);
+  void runSide();
+  bool call(std::function<bool()> cmd);
+  void workerLoop();
+  void publish(bool force, bool busy = true);
+  void markDirty(const std::vector<uint32_t>& cells);
+
+  void doNewMap(imageProps props);
+  void doPlaceCenters(uint32_t cntPlates);
+  void doGrowPlates(uint32_t delayMs);
+  void doGenMotion();
+  void doTimeStep(uint64_t years);
+  void getState(worldState* state) const;
+  bool doSave(const std::string& path);
+  void doSnapshot(worldSaver* saver);
+  bool doLoad(const std::string& path);
+  void doRecord(const std::string& path, uint32_t keyInterval);
+  void doCheckpoint(const std::string& path, uint32_t seconds);
+  void takeCheckpoint();
+  void startRecording();
+  void stopRecording();
+
+  simulation(const simulation&) = delete;
+  simulation& operator=(const simulation&) = delete;
+};
+
+#endif
@@ -14,53 +14,71 @@
 #include <QSettings>
 #include <QCloseEvent>
 #include <QTimer>
+#include <QInputDialog>
+#include <QSlider>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QFileInfo>
 
 #include <random>
 #include <iostream>
+#include <algorithm>
 
 #include "logger.h"
 #include "terrainGen.h"
 #include "plateColorDlg.h"
 #include "constants.h"
-#include "hexagon.h"
+#include "hexLayer.h"
+#include "labelLayer.h"
 #include "evDist.h"
+#include "simulation.h"
+#include "threadPool.h"
+#include "mapExport.h"
+#include "tileExport.h"
+#include "worldFile.h"
+#include "worldSaver.h"
+#include "history.h"
 #include "mapDisplay.h"
 #include "graphicsLayer.h"
 
 #include "imageProps.h"
 
-terrainGen::terrainGen() : QMainWindow(), m_pDisplay(nullptr), m_pScene(nullptr), m_props(nullptr),  m_curTime(0), m_centers(nullptr), m_bDirty(false), m_fileName("")
+terrainGen::terrainGen() : QMainWindow(), m_pDisplay(nullptr), m_pScene(nullptr), m_props(nullptr),  m_curTime(0), m_bDirty(false), m_fileName("")
 {
-  m_gen = new std::mt19937(m_rd());
-
   readSettings();                                 // read configuration for file....
 
+  m_sim = new simulation(m_cntThreads);           // the simulation runs on its own thread
+  m_renderPool = new threadPool(m_cntThreads);    // rasterizes the map for the view
+  m_saver = new worldSaver;                       // writes terrain files on its own thread
+
   setupUI();                                      // build UI
   setupActions();                                 // build actions for menus
   setupMenu();                                    // setup menus
 
   m_pScene = new QGraphicsScene(this);
+  m_pScene->setItemIndexMethod(QGraphicsScene::NoIndex);  // the scene only holds a few layers, an index does not pay
   m_pDisplay->setScene(m_pScene);
 
+  m_frameTimer = new QTimer(this);                // show the latest state of the simulation, at most ~60 times a second
+  connect(m_frameTimer, &QTimer::timeout, this, &terrainGen::onSimFrame);
+  m_frameTimer->start(16);
+
+  m_autosaveTimer = new QTimer(this);             // save a copy of a running simulation now and then
+  connect(m_autosaveTimer, &QTimer::timeout, this, &terrainGen::onAutosave);
+  if (m_autosaveMinutes > 0) m_autosaveTimer->start(m_autosaveMinutes * 60000);
 }
 
 
 
 terrainGen::~terrainGen()
 {
-    if (m_vecGrid.size() > 0)
-    {
-        //std::vector<CHexagon*>::iterator iter = m_vecGrid.begin();
-        //while (m_vecGrid.end() != iter)
-        //{
-        //    delete (*iter);
-        //    (*iter) = nullptr;
-        //    ++iter;
-        //}
-
-        m_vecGrid.erase(m_vecGrid.begin(), m_vecGrid.end());
-    }
-
+    if (m_bAutosave) m_saver->cancel();           // a save the user asked for is finished, an autosave is not
+    m_sim->stop();
+    m_sim->wait();                                // the simulation copies its state for a save still waiting for it
+    delete m_sim;                                 // stops and joins the simulation thread
+    delete m_saver;                               // joins the thread writing the file
+    delete m_history;
+    delete m_renderPool;
 }
 
 
@@ -99,6 +117,28 @@ void terrainGen::setupUI()
     m_statusbar = new QStatusBar(this);
     m_statusbar->setObjectName("statusbar");
 
+    m_timeline = new QSlider(Qt::Horizontal, m_statusbar);
+    m_timeline->setObjectName("timeline");
+    m_timeline->setMinimumWidth(scrWidth / 3);
+    m_timeline->setToolTip("frame of the history shown");
+    m_timeline->hide();
+    m_statusbar->addPermanentWidget(m_timeline);
+    connect(m_timeline, &QSlider::valueChanged, this, &terrainGen::onTimelineMoved);
+
+    m_saveProgress = new QProgressBar(m_statusbar);
+    m_saveProgress->setObjectName("saveProgress");
+    m_saveProgress->setRange(0, 1000);
+    m_saveProgress->setMaximumWidth(scrWidth / 6);
+    m_saveProgress->hide();
+    m_statusbar->addPermanentWidget(m_saveProgress);
+
+    m_saveCancel = new QPushButton("cancel", m_statusbar);
+    m_saveCancel->setObjectName("saveCancel");
+    m_saveCancel->setToolTip("stop saving, the file is left as it was");
+    m_saveCancel->hide();
+    m_statusbar->addPermanentWidget(m_saveCancel);
+    connect(m_saveCancel, &QPushButton::clicked, this, &terrainGen::onSaveCancel);
+
     verticalLayout->addWidget(m_pDisplay);
     this->setCentralWidget(centralwidget);
     this->setMenuBar(m_menubar);
@@ -124,6 +164,10 @@ void terrainGen::setupActions()
     m_pFileOpen->setStatusTip("open a terrain file");
     connect(m_pFileOpen, SIGNAL(triggered()), this, SLOT(onFileOpen()));
 
+    m_pFileOpenHistory = new QAction("Open History", this);
+    m_pFileOpenHistory->setStatusTip("open a history file recorded by the simulation and step through it on a timeline");
+    connect(m_pFileOpenHistory, SIGNAL(triggered()), this, SLOT(onFileOpenHistory()));
+
     m_pFileNew = new QAction("New", this);
     m_pFileNew->setShortcuts(QKeySequence::New);
     m_pFileNew->setStatusTip("creates a new image");
@@ -144,6 +188,14 @@ void terrainGen::setupActions()
     m_pFileSaveAs->setStatusTip("save current terrain with a new name");
     connect(m_pFileSaveAs, SIGNAL(triggered()), this, SLOT(onFileSaveAs()));
 
+    m_pFileExport = new QAction("Export Image", this);
+    m_pFileExport->setStatusTip("export the plates as a PNG or TIFF image");
+    connect(m_pFileExport, SIGNAL(triggered()), this, SLOT(onFileExport()));
+
+    m_pFileExportTiles = new QAction("Export Tiles", this);
+    m_pFileExportTiles->setStatusTip("export the visible layers as a pyramid of map tiles");
+    connect(m_pFileExportTiles, SIGNAL(triggered()), this, SLOT(onFileExportTiles()));
+
     m_pFileExit = new QAction("Exit", this);
     m_pFileExit->setShortcuts(QKeySequence::Quit);
     m_pFileExit->setStatusTip("exit application");
@@ -211,11 +263,27 @@ void terrainGen::setupActions()
     m_pSimTimeDelta->setEnabled(false);
     connect(m_pSimTimeDelta, SIGNAL(triggered()), this, SLOT(onSimTimeDelta()));
 
+    m_pSimAnimate = new QAction("animate plate growth");
+    m_pSimAnimate->setStatusTip("step plate growth on a timer so it can be watched, instead of running it to completion");
+    m_pSimAnimate->setCheckable(true);
+    m_pSimAnimate->setChecked(m_bAnimate);
+    connect(m_pSimAnimate, &QAction::toggled, this, [this](bool checked) { m_bAnimate = checked; });
+
      m_pSimRun = new QAction("run");
     // m_pSimCenters->setShortcuts();
     m_pSimRun->setStatusTip("run for total time duration");
     connect(m_pSimRun, SIGNAL(triggered()), this, SLOT(onSimRun()));
 
+    m_pSimStop = new QAction("stop");
+    m_pSimStop->setStatusTip("stop the running simulation");
+    m_pSimStop->setEnabled(false);
+    connect(m_pSimStop, SIGNAL(triggered()), this, SLOT(onSimStop()));
+
+    m_pSimRecord = new QAction("record history...");
+    m_pSimRecord->setStatusTip("record every time step of the simulation into a history file");
+    m_pSimRecord->setCheckable(true);
+    connect(m_pSimRecord, &QAction::toggled, this, &terrainGen::onSimRecord);
+
     m_pEditPerfs = new QAction("Preferences", this);
     m_pEditPerfs->setShortcuts(QKeySequence::Preferences);
     m_pEditPerfs->setStatusTip("view/edit application preferences");
@@ -253,11 +321,14 @@ void terrainGen::setupMenu()
 {
     QMenu* fileMenu = menuBar()->addMenu("&File");
     fileMenu->addAction(m_pFileOpen);
+    fileMenu->addAction(m_pFileOpenHistory);
     fileMenu->addAction(m_pFileNew);
     fileMenu->addAction(m_pFileClose);
     fileMenu->addSeparator();
     fileMenu->addAction(m_pFileSave);
     fileMenu->addAction(m_pFileSaveAs);
+    fileMenu->addAction(m_pFileExport);
+    fileMenu->addAction(m_pFileExportTiles);
     fileMenu->addSeparator();
     fileMenu->addAction(m_pFileExit);
 
@@ -283,7 +354,10 @@ void terrainGen::setupMenu()
     simMenu->addAction(m_pSimMotion);
     simMenu->addAction(m_pSimTimeDelta);
     simMenu->addSeparator();
+    simMenu->addAction(m_pSimAnimate);
     simMenu->addAction(m_pSimRun);
+    simMenu->addAction(m_pSimStop);
+    simMenu->addAction(m_pSimRecord);
 
     QMenu* helpMenu = m_menubar->addMenu("&Help");
     helpMenu->addAction(m_pHelpHelp);
@@ -311,11 +385,15 @@ void terrainGen::readSettings()
   m_imageWidth = settings.value("image/width", 1024).toInt();
   m_imageHeight = settings.value("image/height", 768).toInt();
   m_hexagonSize = settings.value("image/gridSize", 18).toInt();
-  m_hexagonOrien = settings.value("image/orientation", hexagon::orien::VERTICAL).toInt();
+  m_hexagonOrien = settings.value("image/orientation", hexGrid::orien::VERTICAL).toInt();
   m_hexagonProps = settings.value("image/hexProps", 0).toInt();
   m_cntPlates = settings.value("simulation/plates", 0).toInt();
   m_timeStep = settings.value("simulation/timeStep", 100000).toInt();            // time step for simulation in years
   m_maxTime = settings.value("simulation/maxTime", 4500000000).toULongLong();    // max length of time for simulation in years.
+  m_bAnimate = settings.value("simulation/animate", false).toBool();             // animate plate growth, or run to completion
+  m_keyInterval = settings.value("simulation/keyInterval", 500).toUInt();        // time steps between keyframes of a history file
+  m_autosaveMinutes = settings.value("simulation/autosaveMinutes", 5).toUInt();  // minutes between autosaves of a run, 0 => never
+  m_cntThreads = settings.value("simulation/threads", 0).toUInt();               // threads used by the simulation, 0 => all cores
 
   // create properties structure ....
   m_props = new struct imageProps;
@@ -366,6 +444,10 @@ void terrainGen::writeSettings()
     settings.setValue("simulation/plates", m_cntPlates);
     settings.setValue("simulation/timeStep", m_timeStep);
     settings.setValue("simulation/maxDuration", m_maxTime);
+    settings.setValue("simulation/animate", m_bAnimate);
+    settings.setValue("simulation/keyInterval", m_keyInterval);
+    settings.setValue("simulation/autosaveMinutes", m_autosaveMinutes);
+    settings.setValue("simulation/threads", m_cntThreads);
 
     settings.beginWriteArray("noise");
     for (int ndx = 0; ndx < nbrHarmonics; ndx++)
@@ -382,16 +464,139 @@ void terrainGen::writeSettings()
  *
  * abstract  : This function performs the actual work of saving a document, it is called by both `onSave' and `onSaveAs'
  *             This function save the current document into the file represented by the variable m_fileName.
+ *             The file is written in the background (see worldSaver.h): the simulation copies its state between two
+ *             steps, so it does not have to be stopped, and the copy is written on a thread of its own while the
+ *             progress is shown in the status bar.  The result is picked up by checkSave.
  *
  * parameters: none
  *
  * returns   : none
  *
  * written   : Dec 2021 (GKHuber)
+ *             Oct 2026 (gkhuber) saves in the background
 ************************************************************************************************************************/
 void terrainGen::doSave()
 {
+    if (!m_saver->begin(m_fileName.toStdString()))
+    {
+        QMessageBox::information(this, "Save", "a save is under way, wait for it to finish");
+        return;
+    }
+
+    m_bAutosave = false;
+    m_grid.detachCells();                          // the file may be the one the grid is mapped from
+    m_sim->saveAsync(m_saver);
+
+    m_saveProgress->setValue(0);
+    m_saveProgress->show();
+    m_saveCancel->show();
+    m_statusbar->showMessage(QString("saving %1").arg(m_fileName));
+}
+
+
+/************************************************************************************************************************
+ * function  : checkSave
+ *
+ * abstract  : Shows the progress of a background save, and reports its result once it is over.  Called with every frame
+ *             (see onSimFrame).
+ *
+ * parameters: void
+ *
+ * returns   : void
+ *
+ * written   : Oct 2026 (gkhuber)
+************************************************************************************************************************/
+void terrainGen::checkSave()
+{
+    uint8_t status = m_saver->getStatus();
+
+    if (status == worldSaver::status::IDLE) return;
+
+    if (status < worldSaver::status::SAVED)
+    {
+        uint64_t total = m_saver->getTotal();
+        if (total > 0) m_saveProgress->setValue((int)(1000 * m_saver->getDone() / total));
+        return;
+    }
+
+    QString fileName = QString::fromStdString(m_saver->getPath());
+
+    m_saver->finish();
+    m_saveProgress->hide();
+    m_saveCancel->hide();
+
+    if (status == worldSaver::status::SAVED)
+    {
+        if (!m_bAutosave) m_bDirty = false;
+        m_statusbar->showMessage(QString("saved %1").arg(fileName));
+    }
+    else if (status == worldSaver::status::CANCELLED)
+        m_statusbar->showMessage(QString("not saved %1, cancelled").arg(fileName));
+    else if (m_bAutosave)
+        m_statusbar->showMessage(QString("could not autosave to %1").arg(fileName));
+    else
+        QMessageBox::warning(this, "Save", QString("could not write %1").arg(fileName));
+
+    m_bAutosave = false;
+}
+
+
+/************************************************************************************************************************
+ * function  : clearScene
+ *
+ * abstract  : Empties the scene.  The layers, and the hex and label layers with them, are deleted by the scene.
+ *
+ * parameters: void
+ *
+ * returns   : void
+ *
+ * written   : Oct 2026 (gkhuber) -- moved here from onFileNew
+************************************************************************************************************************/
+void terrainGen::clearScene()
+{
+    m_bMotionDrawn = false;
+    m_grid.clear();
+    m_pScene->clear();
+    m_hexLayer = nullptr;
+    m_labelLayer = nullptr;
+    for (uint32_t ndx = 0; ndx < mapLayers; ndx++) m_layers[ndx] = nullptr;
+    m_palette.assign(1, 0xFF000000);
+}
 
+
+/************************************************************************************************************************
+ * function  : buildScene
+ *
+ * abstract  : Creates the layers that view the grid (m_grid, which must be built first) and adds the map border of the
+ *             current image properties (m_props).  The cells are updated by onSimFrame from the snapshots of the
+ *             simulation.
+ *
+ * parameters: void
+ *
+ * returns   : void
+ *
+ * written   : Oct 2026 (gkhuber) -- moved here from onFileNew
+************************************************************************************************************************/
+void terrainGen::buildScene()
+{
+    QPen  pen(Qt::black);
+    pen.setWidth(2);
+
+    // initialize array for layers
+    for (uint32_t ndx = 0; ndx < mapLayers; ndx++)
+    {
+      if (ndx == layerGrid) m_layers[ndx] = m_hexLayer = new hexLayer(&m_grid, &m_palette, m_renderPool);
+      else if (ndx == layerLabels) m_layers[ndx] = m_labelLayer = new labelLayer(&m_grid);
+      else m_layers[ndx] = new graphicsLayer;
+      m_isVisible[ndx] = true;                      // by default all layers are visible
+    }
+
+    QGraphicsRectItem* pBorder = new QGraphicsRectItem(0, 0, m_props->imageWidth, m_props->imageHeight, m_layers[layerBorder]);
+    pBorder->setData(0, QVariant("border"));
+    pBorder->setPen(pen);
+
+    // add all the layers to the scene
+    for (uint ndx = 0; ndx < mapLayers; ndx++) m_pScene->addItem(m_layers[ndx]);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -416,7 +621,171 @@ void terrainGen::mouseMoveEvent(QMouseEvent* evt)
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // public slots
-void terrainGen::onFileOpen() { qDebug() << "in onFileOpen"; }
+/************************************************************************************************************************
+ * function  : onFileOpen
+ *
+ * abstract  : Opens a terrain file (see worldFile.h).  The file is mapped into memory, and the grid the scene draws
+ *             (m_grid) uses the cell arrays in the file where they lie, so opening a file takes the same time whatever
+ *             its size and only the cells that are drawn are ever read from disk.  The simulation maps the same file
+ *             on its own thread, and does not send the cells back until it changes them (see simulation::doLoad).
+ *             A file that cannot be read leaves the current document as it was.
+ *
+ * parameters: void
+ *
+ * returns   : void
+ *
+ * written   : Oct 2026 (gkhuber)
+************************************************************************************************************************/
+void terrainGen::onFileOpen()
+{
+    if ((m_fileName != "") && m_bDirty)
+    {
+        int nRet = QMessageBox::question(nullptr, "Save current document", "The current document has been modified, do you with to save?");
+        if (QMessageBox::Yes == nRet)
+        {
+            onFileSave();
+        }
+    }
+
+    QString fileName = QFileDialog::getOpenFileName(this, "Open terrain", ".", "terrain files (*.ter);;all files (*.*)");
+    if (fileName == "") return;
+
+    worldState state;
+    hexGrid    grid;
+
+    m_sim->stop();
+    if (!worldFile::read(fileName.toStdString(), &state, &grid) || !m_sim->load(fileName.toStdString()))
+    {
+        QMessageBox::warning(this, "Open terrain", QString("could not read %1").arg(fileName));
+        return;
+    }
+
+    closeHistory();
+    clearScene();
+    *m_props = state.props;
+    m_grid.swap(grid);
+    buildScene();
+
+    m_fileName = fileName;
+    m_bDirty = false;
+    m_statusbar->showMessage(QString("opened %1").arg(fileName));
+}
+
+
+
+/************************************************************************************************************************
+ * function  : onFileOpenHistory
+ *
+ * abstract  : Opens a history file recorded by the simulation (see history.h) and shows its frames on a timeline, a
+ *             slider next to the status message.  The scene is rebuilt for the map the history was recorded on, and
+ *             while the history is open the view shows the frame picked on the timeline instead of the simulation, so
+ *             the actions that would change the simulation or save it are disabled.  Opening or creating a terrain
+ *             closes the history.  A file that cannot be read leaves the current document as it was.
+ *
+ * parameters: void
+ *
+ * returns   : void
+ *
+ * written   : Oct 2026 (gkhuber)
+************************************************************************************************************************/
+void terrainGen::onFileOpenHistory()
+{
+    QString fileName = QFileDialog::getOpenFileName(this, "Open history", ".", "history files (*.hst);;all files (*.*)");
+    if (fileName == "") return;
+
+    historyReader* history = new historyReader();
+    if (!history->open(fileName.toStdString()) || (history->getWidth() <= 0) || (history->getHeight() <= 0))
+    {
+        QMessageBox::warning(this, "Open history", QString("could not read %1").arg(fileName));
+        delete history;
+        return;
+    }
+
+    m_sim->stop();
+    closeHistory();
+    clearScene();
+
+    m_props->imageWidth = history->getWidth();
+    m_props->imageHeight = history->getHeight();
+    m_props->hexagonSize = history->getSize();
+    m_props->hexagonOrient = history->getOrient();
+    m_props->cntPlates = history->getPlates();
+    m_grid.build(history->getOrient(), history->getSize(), history->getRows(), history->getCols());
+    buildScene();
+
+    for (uint32_t ndx = 0; ndx < history->getPlates(); ndx++)       // a history file does not keep the colors
+      m_palette.push_back(plateColor(ndx));
+
+    m_history = history;
+    m_fileName = "";
+    m_bDirty = false;
+
+    for (QAction* pAction : { m_pFileSave, m_pFileSaveAs, m_pSimCenters, m_pSimPlates, m_pSimPrepPlates, m_pSimMotion, m_pSimTimeDelta, m_pSimRun, m_pSimStop, m_pSimRecord })
+      pAction->setEnabled(false);
+
+    {
+      QSignalBlocker block(m_timeline);
+      m_timeline->setRange(0, (int)m_history->getFrames() - 1);
+      m_timeline->setValue(0);
+    }
+    m_timeline->show();
+    onTimelineMoved(0);
+}
+
+
+/************************************************************************************************************************
+ * function  : closeHistory
+ *
+ * abstract  : Closes the history file shown on the timeline, if any, and hands the view back to the simulation.  The
+ *             actions of the simulation menu are enabled again by the next snapshot (see onSimFrame).
+ *
+ * parameters: void
+ *
+ * returns   : void
+ *
+ * written   : Oct 2026 (gkhuber)
+************************************************************************************************************************/
+void terrainGen::closeHistory()
+{
+    if (nullptr == m_history) return;
+
+    delete m_history;
+    m_history = nullptr;
+    m_timeline->hide();
+
+    m_pFileSave->setEnabled(true);
+    m_pFileSaveAs->setEnabled(true);
+    m_pSimRecord->setEnabled(true);
+}
+
+
+/************************************************************************************************************************
+ * function  : onTimelineMoved
+ *
+ * abstract  : Shows a frame of the history file.  The history rebuilds the frame in m_grid from the nearest keyframe
+ *             (see historyReader::seek), and the hex layer is redrawn from the grid as for a snapshot of the simulation.
+ *
+ * parameters: frame -- [in] the frame picked on the timeline
+ *
+ * returns   : void
+ *
+ * written   : Oct 2026 (gkhuber)
+************************************************************************************************************************/
+void terrainGen::onTimelineMoved(int frame)
+{
+  if ((nullptr == m_history) || (frame < 0)) return;
+
+  if (!m_history->seek((uint32_t)frame, &m_grid))
+  {
+    m_statusbar->showMessage(QString("frame %1 of the history could not be read").arg(frame));
+    return;
+  }
+
+  if (nullptr != m_hexLayer) m_hexLayer->refresh();
+
+  m_curTime = m_history->getTime((uint32_t)frame);
+  m_statusbar->showMessage(QString("history at %1 years, frame %2 of %3").arg(m_curTime).arg(frame).arg(m_history->getFrames() - 1));
+}
 
 
 
@@ -450,52 +819,33 @@ void terrainGen::onFileNew()
     }
     
     // clear the scene and clear the state variables...
-    if (nullptr != m_centers) { delete[] m_centers; m_centers = nullptr;}
-    std::vector<hexagon*>::iterator iter = m_vecGrid.begin();
-    while (m_vecGrid.end() != iter)
-    {
-        delete (*iter);
-        (*iter) = nullptr;
-        ++iter;
-    }
-    m_vecGrid.erase(m_vecGrid.begin(), m_vecGrid.end());
-    m_pScene->clear();
+    m_sim->stop();
+    closeHistory();
+    clearScene();
 
     // get the properties of the new image
     int32_t  ret = dlg.exec();
 
-
-    // initialize array for layers
-    for (uint32_t ndx = 0; ndx < mapLayers; ndx++)
-    {
-      m_layers[ndx] = new graphicsLayer;
-      m_isVisible[ndx] = true;                      // by default all layers are visible
-    }
-
     if(QDialog::Accepted == ret)
     {
       adjustBorderSize();
         // TODO : generate our noise function here...
-        
+
         QPen  pen(Qt::black);
         pen.setWidth(2);
 
         genGrid(pen);
-
-        QGraphicsRectItem* pBorder = new QGraphicsRectItem(0, 0, m_props->imageWidth, m_props->imageHeight, m_layers[4]);
-        pBorder->setData(0, QVariant("border"));
-        pBorder->setPen(pen);
-
-
-        // add all the layers to the scene
-        for (uint ndx = 0; ndx < mapLayers; ndx++) m_pScene->addItem(m_layers[ndx]);
-
+        buildScene();
+        m_sim->newMap(*m_props);                   // the simulation keeps its own copy of the grid
+        m_fileName = "";
     }
 
     m_curTime = 0;
     m_pSimCenters->setEnabled(true);
     m_pSimPlates->setEnabled(false);
+    m_pSimPrepPlates->setEnabled(false);
     m_pSimMotion->setEnabled(false);
+    m_pSimTimeDelta->setEnabled(false);
 }
 
 
@@ -558,7 +908,7 @@ void terrainGen::onFileSaveAs()
 { 
     QString fileName = "";
 
-    fileName = QFileDialog::getSaveFileName(this, "Save current document as", "./terrain.dat", "terrain files (*.dat *.ter);;all files (*.*)");
+    fileName = QFileDialog::getSaveFileName(this, "Save current document as", "./terrain.ter", "terrain files (*.ter);;all files (*.*)");
     if (fileName != "")
     {
         m_fileName = fileName;
@@ -567,6 +917,82 @@ void terrainGen::onFileSaveAs()
 }
 
 
+/************************************************************************************************************************
+ * function  : onFileExport
+ *
+ * abstract  : Exports the plates of the current map as a PNG or TIFF image of any size.  The image is streamed to disk a
+ *             strip at a time by mapExport, from the grid shown in the scene, so the size of the image is only limited
+ *             by the disk.
+ *
+ * parameters: void
+ *
+ * returns   : void
+ *
+ * written   : Oct 2026 (gkhuber)
+************************************************************************************************************************/
+void terrainGen::onFileExport()
+{
+    if (m_grid.getCount() == 0) return;
+
+    QString fileName = QFileDialog::getSaveFileName(this, "Export image", "./terrain.png", "PNG image (*.png);;TIFF image (*.tif *.tiff)");
+    if (fileName == "") return;
+
+    bool ok = false;
+    int  width = QInputDialog::getInt(this, "Export image", "width in pixels", (int)m_props->imageWidth, 1, 1 << 20, 1, &ok);
+    if (!ok) return;
+
+    mapExport exporter(&m_grid, &m_palette, m_renderPool);
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    bool bRet = exporter.write(fileName.toStdString(), *m_props, (uint32_t)width, 0, [this](uint32_t row, uint32_t height)
+    {
+        m_statusbar->showMessage(QString("exporting: %1 of %2 rows").arg(row).arg(height));
+    });
+    QApplication::restoreOverrideCursor();
+
+    if (!bRet) QMessageBox::warning(this, "Export image", QString("could not write %1").arg(fileName));
+    else m_statusbar->showMessage(QString("exported %1").arg(fileName));
+}
+
+
+/************************************************************************************************************************
+ * function  : onFileExportTiles
+ *
+ * abstract  : Exports the visible layers of the current map as a pyramid of 256x256 PNG tiles (<dir>/<z>/<x>/<y>.png)
+ *             for a slippy map viewer.  The deepest zoom is the first one at which a hexagon is 16 pixels wide.  An
+ *             export into a directory that already holds part of the same pyramid carries on where it stopped (see
+ *             tileExport::prepareDir).
+ *
+ * parameters: void
+ *
+ * returns   : void
+ *
+ * written   : Oct 2026 (gkhuber)
+************************************************************************************************************************/
+void terrainGen::onFileExportTiles()
+{
+    if (m_grid.getCount() == 0) return;
+
+    QString dirName = QFileDialog::getExistingDirectory(this, "Export tiles", ".");
+    if (dirName == "") return;
+
+    uint32_t layers = 0;
+    for (uint32_t ndx = 0; ndx < mapLayers; ndx++)
+        if (m_isVisible[ndx]) layers |= (1 << ndx);
+
+    tileExport exporter(&m_grid, &m_palette, m_renderPool);
+    uint32_t   maxZoom = tileExport::zoomFor(*m_props, 16);
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    m_statusbar->showMessage(QString("exporting tiles, zoom 0 to %1").arg(maxZoom));
+    bool bRet = exporter.write(dirName.toStdString(), *m_props, m_sim->getSeed(), m_curTime, maxZoom, layers);
+    QApplication::restoreOverrideCursor();
+
+    if (!bRet) QMessageBox::warning(this, "Export tiles", QString("could not write the tiles to %1").arg(dirName));
+    else m_statusbar->showMessage(QString("exported tiles to %1, zoom 0 to %2").arg(dirName).arg(maxZoom));
+}
+
+
 /************************************************************************************************************************
  * function  : onFileExit 
  *
@@ -608,12 +1034,12 @@ void terrainGen::onViewToggleVisibility()
   std::cout << "in onViewToggleVisibility, index is " << ndx << std::endl;
   if (m_isVisible[ndx])
   {
-    m_layers[ndx]->hide();
+    if (nullptr != m_layers[ndx]) m_layers[ndx]->hide();
     m_isVisible[ndx] = false;
   }
   else
   {
-    m_layers[ndx]->show();
+    if (nullptr != m_layers[ndx]) m_layers[ndx]->show();
     m_isVisible[ndx] = true;
   }
   
@@ -626,6 +1052,8 @@ void terrainGen::onViewRedraw()
   m_pScene->setSceneRect(QRectF(QPointF(0, 0), QSizeF(m_imageWidth, m_imageHeight)));
   
   m_pScene->clear();
+  m_hexLayer = nullptr;
+  m_labelLayer = nullptr;
   //for (CHexagon* h : m_vecGrid)
   //{
   //  h->draw(m_pScene);
@@ -671,12 +1099,9 @@ void terrainGen::onEditPlateColors()
 /************************************************************************************************************************
  * function  :  onSimCenters
  *
- * abstract  : This function randomly chooses the plate centers.  This function assums that a new map has been started,
- *             and at the end of the function the variable m_centers has been created and initialized.  It depends on 
- *             the value of m_cntPlates to determine how many plates to create.
- * 
- *             We generate two random numbers in the rand [0, RAND_MAX] and divide by (RAND_MAX + 1) to generte a 
- *             real number between [0, 1).  This is multiplied by the width (height) to generate the x- (y-) coordinate.
+ * abstract  : This function asks the simulation to randomly choose the plate centers.  This function assums that a new
+ *             map has been started.  It depends on the value of m_props->cntPlates to determine how many plates to
+ *             create.  The centers are shown once the simulation publishes them (see onSimFrame).
  * 
  *             We have the restriction that no plate shall occupy no less than 15% of the total area of the map.
  *
@@ -685,159 +1110,37 @@ void terrainGen::onEditPlateColors()
  * returns   : void
  *
  * written   : Dec 2021 (GKHuber)
+ *             Oct 2026 (gkhuber) -- the centers are placed on the simulation thread, see simulation::doPlaceCenters
 ************************************************************************************************************************/
 void terrainGen::onSimCenters() 
 { 
-
-    double margin = m_hexagonSize;
-
-    // create a vector for plates structure
-    m_plates = new platesT[m_props->cntPlates];
-    m_centers = new QPointF[m_props->cntPlates];
-
-    if (m_hexagonOrien == hexagon::orien::HORIZONTAL)
-      margin = m_hexagonSize * (1 + 2 * sin30);
-    else if (m_hexagonOrien == hexagon::orien::VERTICAL)
-      margin = 2 * m_hexagonSize * cos30;
-    else
-      CLogger::getInstance()->outMsg(cmdLine, CLogger::level::WARNING, "unknown hexagon orientation.");
-
-    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::INFO, "generating %d centes", m_props->cntPlates);
-
-    for (int ndx = 0; ndx < m_props->cntPlates; ndx++)
-    {
-      bool isValid = false;
-      float tempX;
-      float tempY;
-
-      std::uniform_real_distribution<>  dist(0.0, 1.0);  // generates a random real number in range[0,1.0)
-
-      while (!isValid)                               // clamp location to at least one grid cell from image boundary.
-      {      
-        isValid = true;
-        tempX = (m_props->imageWidth)* dist(*m_gen);
-        tempY = (m_props->imageHeight)* dist(*m_gen);
-
-        if ((tempX < margin) || ((m_imageWidth - tempX) < margin) || (tempY < margin) || ((m_imageHeight = tempY) < margin))
-        {
-          CLogger::getInstance()->outMsg(cmdLine, CLogger::level::DEBUG, "rejected point as too close to edge");
-          isValid = false;
-        }
-
-      } while (!isValid);
-
-      CLogger::getInstance()->outMsg(cmdLine, CLogger::level::INFO, "plate %d: center is at (%.4f, %.4f)", ndx, tempX, tempY);
-
-      m_centers[ndx] = QPointF(tempX, tempY);
-      m_plates[ndx].ndx = ndx + 1;                                 // set index for plate
-      m_plates[ndx].center_x = tempX;
-      m_plates[ndx].center_y = tempY;
-      if(ndx < 10) m_plates[ndx].color = plateColors[ndx];         // TODO: handle case if more than 12 plates
-
-      for (hexagon* ph : m_vecGrid)
-      {
-        if (ph->contains(m_centers[ndx]))
-        {
-          ph->setColor(m_plates[ndx].color);                       //ph->setColor(plateColors[ndx]);
-          ph->setStyle(bFilled | bColor | bDispCenter);
-
-          //ph->draw(m_pScene);
-          m_plates[ndx].vec.push_back(ph->getId());                // add hex to plate list
-
-          CLogger::getInstance()->outMsg(cmdLine, CLogger::level::DEBUG, "hexagon %d belongs to plate %d", ph->getId(), ndx);
-          break;
-        }
-      } // end of for-each loop
-    } // end of for loop iterating over plates
-
-    this->update();
-
-    m_pSimCenters->setEnabled(false);
-    m_pSimPlates->setEnabled(true);
+  m_pSimCenters->setEnabled(false);
+  m_sim->placeCenters(m_props->cntPlates);
 }
 
 
+/************************************************************************************************************************
+ * function  : onSimPlates
+ *
+ * abstract  : This function grows the plates out from their centers until the whole map is covered.  The growth runs on
+ *             the simulation thread, as fast as possible by default.  If animated growth has been selected 
+ *             (Simulation | animate plate growth) the simulation pauses 150 ms between steps instead, so that the
+ *             plates can be watched as they grow.  Either way the GUI stays responsive and shows the growth as the
+ *             snapshots arrive.
+ *
+ * parameters: void
+ *
+ * returns   : void
+ *
+ * written   : Oct 2026 (gkhuber)
+************************************************************************************************************************/
 void terrainGen::onSimPlates()
 {
-  m_timer = new  QTimer(this);
-  connect(m_timer, &QTimer::timeout, this, &terrainGen::onSimPlatesImpl);
-  m_timer->start(150);
-}
-
-void terrainGen::onSimPlatesImpl()
-{
-  bool mapChange = false;                                                          // flag to monitor is the map has changed      
-  bool plateChange = false;
-  static uint32_t step = 1;
-
-  CLogger::getInstance()->outMsg(cmdLine, CLogger::level::DEBUG, "in onSimPlates, step %d", step);
-  QApplication::processEvents();
-
-  for (uint32_t plateNdx = 0; plateNdx < m_props->cntPlates; plateNdx++)           // iterate over each plate
-  {
-    plateChange = false;
-    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::DEBUG, "step %d, working with plate %d", step, plateNdx);
-
-    std::vector<uint32_t> newBorder = {};
-
-    platesT* thePlate = &m_plates[plateNdx];                                       // plate we are currently growing
-    uint32_t   cntHexs = thePlate->vec.size();                                     // number of hexagons on the current border
-    QColor     plateColor = thePlate->color;
-
-    for (uint32_t hexNdx = 0; hexNdx < cntHexs; hexNdx++)                          // iterate over the border hexagons
-    {
-      uint32_t gridID = thePlate->vec.at(hexNdx);                                  // grid ID of the border hexagon we are working with
-      hexagon* pHex = m_vecGrid.at(gridID);                                        // actual border hexagon we are working with.
-      double cent_x = pHex->getCenter().x();                                       // coordinates of the center of the hexagon
-      double cent_y = pHex->getCenter().y();
-      
-      for (uint32_t a = 0; a < 6; a++)                                             // iterate over the six neighbors
-      {
-        double tempX = cent_x + 2 * pHex->getSide() * cos((a * 60) * (pi / 180));  // neighbors coordinates
-        double tempY = cent_y + 2 * pHex->getSide() * sin((a * 60) * (pi / 180));
-
-        for (hexagon* testHex : m_vecGrid)                                         // iterate over all grid cells
-        {
-          if (testHex->contains(QPoint(tempX, tempY)))
-          {
-            //CLogger::getInstance()->outMsg(cmdLine, CLogger::level::DEBUG,"   potential border grid cell %d at (%.4f, %.4f)", testHex->getIndex(), tempX, tempY);
-            if (!((testHex->getStyle() & bFilled) == bFilled))                     // is cell filled, if so reject it.
-            {
-              testHex->setColor(plateColor);
-              testHex->setStyle(bFilled | bColor);
-
-              newBorder.push_back(testHex->getId());                             // cell was accepted add to new border
-              break;
-            }
-          } // end if block
-        }   // end grid search for loop
-      }     // end of neighbor search
-    }       // end of processing current neighbors
-
-    thePlate->vec.clear();
-    thePlate->vec = newBorder;                                                      // update border list
-    if (newBorder.size() > 0) plateChange = true;
-    mapChange |= plateChange;
-
-    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::DEBUG, "plate %d grew this step %s, map changed this step", plateNdx, (plateChange ? "yes" : "no"), (mapChange ? "yes" : "no"));
-  } // end of plate loop (i.e. plateNdx loop)
-
-
-  //CLogger::getInstance()->outMsg(cmdLine, CLogger::level::DEBUG, "map changed this step %d : %s", step, (mapChange ? "yes" : "no"));
-
-  if (!mapChange)                                                                  // map did not change on this iteration
-  {
-    m_timer->stop();
-    m_pSimPlates->setEnabled(false);
-    m_pSimPrepPlates->setEnabled(true);
-  }
-
-  step++;
-  this->update();
+  m_pSimPlates->setEnabled(false);
+  m_sim->growPlates(m_bAnimate ? 150 : 0);
 }
 
 
-
 /**************************************************************************************************
  * Function:
  *
@@ -854,68 +1157,30 @@ void terrainGen::onSimPlatesImpl()
  *************************************************************************************************/
 void terrainGen::onSimPrepPlates()
 {
-
   m_pSimPrepPlates->setEnabled(false);
-  m_pSimMotion->setEnabled(true);
+  m_sim->prepPlates();
 }
 
 /**************************************************************************************************
- * Function: 
+ * Function: onSimMotion
  *
- * Abstract:  tectonic plates velocity is between 1 to 10 cm a year, most are in the range of 2 to
- *            5 cm a year.  assume a normally distributed velociy with \mu = 4.5, and \sigma = 2.0
+ * Abstract:  asks the simulation to generate the motion vectors of the plates, see 
+ *            simulation::doGenMotion.  The vectors are drawn once they are published.
  *
  * Input   :
  *
  * Returns :
  *
  * Written : () 
+ *           Oct 2026 (gkhuber) -- the vectors are generated on the simulation thread
  *************************************************************************************************/
 void terrainGen::onSimMotion() 
 {
-
-
-  std::normal_distribution<double_t>  norDist(4.5, 2.0);
-  std::uniform_real_distribution<double_t> dirDist(0.0, 360.0);
-  // TODO : all plates have been drawn -- generate border and store as a path in the plate structure
-  // 
-  // m_plates is an array of platesT structures
-  // TODO : generate motion vector and draw on display, motion vector oragin is plate center
-  for (uint32_t ndx = 0; ndx < m_cntPlates; ndx++)
-  {
-    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::INFO, "generating motion vector for plate %d", ndx);
-
-    double_t plateSpeed = norDist(*m_gen);
-    if (plateSpeed < 0) plateSpeed = 2.0;
-    double_t plateDir = dirDist(*m_gen);
-    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::INFO, "      speed %.4f", plateSpeed);
-    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::INFO, "      direction %.4f", plateDir);
-
-    // TODO : draw vector
-    double_t OrigX = m_plates[ndx].center_x;
-    double_t OrigY = m_plates[ndx].center_y;
-    double_t DestX = OrigX + 10*plateSpeed * cos(plateDir * (pi / 180));
-    double_t DestY = OrigY + 10*plateSpeed * sin(plateDir * (pi / 180));
-
-    QGraphicsLineItem* line = new QGraphicsLineItem(OrigX, OrigY, DestX, DestY);
-    line->setPen(QPen(Qt::black));
-    m_pScene->addItem(line);
-
-    double_t HeadX = DestX + 4 * cos(45 * pi / 180);
-    double_t HeadY = DestY + 4 * cos(45 * pi / 180);
-    QGraphicsLineItem* head = new QGraphicsLineItem(DestX, DestY, HeadX, HeadY);
-    head->setPen(QPen(Qt::black));
-    m_pScene->addItem(head);
-    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::INFO, "       orig: (%.4f,%.4f) dest:(%.4f,%.4f)", OrigX, OrigY, DestX, DestY);
-    
-  }
-
   m_pSimMotion->setEnabled(false);
-  m_pSimTimeDelta->setEnabled(true);
+  m_sim->genMotion();
 }
 
 
-
 /************************************************************************************************************************
  * function  : onSimTimeDelta
  *
@@ -927,14 +1192,11 @@ void terrainGen::onSimMotion()
  * returns   : void
  *
  * written   : Dec 2021 (GKHuber)
+ *             Oct 2026 (gkhuber) -- the step runs on the simulation thread
 ************************************************************************************************************************/
 void terrainGen::onSimTimeDelta()
 { 
-    qDebug() << "in onSimTimeDelta"; 
-    m_curTime += m_timeStep;
-    m_statusbar->showMessage(QString("updating to %1 years").arg(m_curTime));
-
-    _sleep(1);
+  m_sim->timeStep(m_timeStep);
 }
 
 
@@ -944,34 +1206,230 @@ void terrainGen::onSimTimeDelta()
  *
  * abstract  : this runs the simulation from the current time to the maximum time for the simulation.  The simulation is
  *             run in m_timeDelta steps.  a 4.5B year max time, with a step size of 100K years will require 45,000 
-               iterations. If each itertion takes one second this is approximately 12.5 hours -- get a cup of coffee.
+               iterations.  Any stage that has not been done yet (centers, plates, motion) is done first.  The run is
+ *             done on the simulation thread, the GUI shows its progress and can stop it (Simulation | stop).
+ *             A long run is autosaved every so often (see onAutosave); opening the autosave and running again carries
+ *             on from there with the same result as a run that was never interrupted.
  *
  * parameters: void
  *
  * returns   : void 
  *
  * written   : Dec 2021 (GKHuber)
+ *             Oct 2026 (gkhuber) -- the run no longer spins an event loop on the GUI thread for every time step
 ************************************************************************************************************************/
 void terrainGen::onSimRun() 
 { 
-    qDebug() << "in onSimRun"; 
+  m_pSimRun->setEnabled(false);
+  m_sim->run(m_props->cntPlates, m_timeStep, m_maxTime);
+}
+
+
+void terrainGen::onSimStop()
+{
+  m_sim->stop();
+}
 
-    onSimCenters();        // generate plates centers, if not done...
-    onSimPlates();         // generate plates if not done ....
-    onSimPrepPlates();     // finalize plate construction ....
-    onSimMotion();         // generate initial movement vector ....
 
-    for (uint64_t ndx = m_curTime; ndx <= m_maxTime; ndx += m_timeStep)
+void terrainGen::onSaveCancel()
+{
+  m_saver->cancel();
+}
+
+
+/************************************************************************************************************************
+ * function  : onAutosave
+ *
+ * abstract  : Saves a copy of a running simulation every m_autosaveMinutes minutes, in the background like doSave, so a
+ *             crash does not lose a long run.  The copy goes next to the document as <name>.autosave.ter, or to
+ *             autosave.ter before the document has a name.  The document itself is not touched, and stays modified.
+ *             The autosave holds the whole state of the simulation, so it also serves as a checkpoint to restart from.
+ *
+ * parameters: void
+ *
+ * returns   : void
+ *
+ * written   : Oct 2026 (gkhuber)
+************************************************************************************************************************/
+void terrainGen::onAutosave()
+{
+  QString fileName = "autosave.ter";
+
+  if (!m_sim->snapshot().busy || (nullptr != m_history)) return;   // nothing changes
+
+  if (m_fileName != "")
+  {
+    QFileInfo info(m_fileName);
+    fileName = info.path() + "/" + info.completeBaseName() + ".autosave.ter";
+  }
+
+  if (!m_saver->begin(fileName.toStdString())) return;             // a save is under way, try again next time
+
+  m_bAutosave = true;
+  m_sim->saveAsync(m_saver);
+
+  m_saveProgress->setValue(0);
+  m_saveProgress->show();
+  m_saveCancel->show();
+}
+
+
+/************************************************************************************************************************
+ * function  : onSimRecord
+ *
+ * abstract  : Starts or stops recording the time steps of the simulation into a history file (see history.h).  A file
+ *             holds a keyframe every m_keyInterval time steps and the changes of the cells in between.  The simulation
+ *             stops recording by itself when the map is replaced or the file cannot be written, onSimFrame then clears
+ *             the check mark.
+ *
+ * parameters: checked -- [in] true to start recording
+ *
+ * returns   : void
+ *
+ * written   : Oct 2026 (gkhuber)
+************************************************************************************************************************/
+void terrainGen::onSimRecord(bool checked)
+{
+  if (!checked)
+  {
+    m_sim->record("");
+    return;
+  }
+
+  QString fileName = QFileDialog::getSaveFileName(this, "Record history", "./terrain.hst", "history files (*.hst);;all files (*.*)");
+  if (fileName == "")
+  {
+    QSignalBlocker block(m_pSimRecord);
+    m_pSimRecord->setChecked(false);
+    return;
+  }
+
+  m_sim->record(fileName.toStdString(), m_keyInterval);
+}
+
+
+/************************************************************************************************************************
+ * function  : onSimFrame
+ *
+ * abstract  : Frame timer handler.  If the simulation has published a new snapshot since the last frame, the cells that
+ *             changed are copied into the grid model that the scene draws (m_grid) and only their rectangles in the
+ *             hex layer are invalidated, so the cost of a frame follows the number of changed cells rather than the size of the map.
+ *             The progress is shown in the status bar and the actions of the simulation menu are enabled to match the
+ *             stage the simulation has reached.  Only the latest snapshot is shown, snapshots published between two
+ *             frames are never drawn, but the cells they changed are included in the next one.  A snapshot without
+ *             cells (the simulation has not changed the map opened from a file) leaves m_grid as it is.
+ *             A background save is checked first, whether or not there is a new snapshot (see checkSave).
+ *
+ * parameters: void
+ *
+ * returns   : void
+ *
+ * written   : Oct 2026 (gkhuber)
+************************************************************************************************************************/
+void terrainGen::onSimFrame()
+{
+  checkSave();
+
+  if (!m_sim->acquire() || (nullptr != m_history)) return;         // the view shows a history file, not the simulation
+
+  const simSnapshot& snap = m_sim->snapshot();
+  bool               bNewPalette = false;
+
+  bNewPalette = (m_palette.size() != snap.plates.size() + 1);      // palette index matches platesT::ndx
+  for (size_t ndx = 0; !bNewPalette && (ndx < snap.plates.size()); ndx++)
+    bNewPalette = (m_palette[ndx + 1] != snap.plates[ndx].color);
+
+  if (bNewPalette)
+  {
+    m_palette.assign(1, 0xFF000000);
+    for (size_t ndx = 0; ndx < snap.plates.size(); ndx++)
+      m_palette.push_back(snap.plates[ndx].color);
+  }
+
+  bool bCells = (snap.plate.size() == m_grid.getCount());          // snapshot holds the cells of the map on screen
+
+  if (snap.allDirty || bNewPalette)
+  {
+    if (bCells)
+    {
+      std::copy(snap.plate.begin(), snap.plate.end(), m_grid.plates());
+      std::copy(snap.style.begin(), snap.style.end(), m_grid.styles());
+      std::copy(snap.elevation.begin(), snap.elevation.end(), m_grid.elevations());
+    }
+    if (nullptr != m_hexLayer) m_hexLayer->refresh();
+  }
+  else if (bCells && (nullptr != m_hexLayer))                       // only restyle the cells that changed
+  {
+    for (uint32_t cellID : snap.dirty)
     {
-        onSimTimeDelta();
-        
-        
-        // todo : let message pump do it's things
-        QEventLoop  evtLoop(this);
-        evtLoop.processEvents(QEventLoop::ExcludeUserInputEvents);
+      m_grid.setPlate(cellID, snap.plate[cellID]);
+      m_grid.setStyle(cellID, snap.style[cellID]);
+      m_grid.setElevation(cellID, snap.elevation[cellID]);
+      m_hexLayer->updateCell(cellID);
     }
+  }
+
+  if ((snap.phase >= simulation::phase::MOTION) && !m_bMotionDrawn) drawMotion(snap);
+
+  m_curTime = snap.curTime;
+  if (snap.phase >= simulation::phase::MOTION)
+    m_statusbar->showMessage(QString("updating to %1 years").arg(m_curTime));
+  else if (snap.phase >= simulation::phase::CENTERS)
+    m_statusbar->showMessage(QString("growing plates: step %1, %2 of %3 cells claimed").arg(snap.step).arg(snap.claimed).arg(m_grid.getCount()));
 
-    qDebug() << "current time is: " << m_curTime;
+  if (m_bRecording && !snap.recording && m_pSimRecord->isChecked())  // the simulation stopped recording by itself
+  {
+    QSignalBlocker block(m_pSimRecord);
+    m_pSimRecord->setChecked(false);
+  }
+  m_bRecording = snap.recording;
+
+  m_pSimStop->setEnabled(snap.busy);
+  m_pSimRun->setEnabled(!snap.busy && (snap.phase >= simulation::phase::GRID));
+  if (!snap.busy)
+  {
+    m_pSimCenters->setEnabled(snap.phase == simulation::phase::GRID);
+    m_pSimPlates->setEnabled(snap.phase == simulation::phase::CENTERS);
+    m_pSimPrepPlates->setEnabled(snap.phase == simulation::phase::PLATES);
+    m_pSimMotion->setEnabled(snap.phase == simulation::phase::PREPARED);
+    m_pSimTimeDelta->setEnabled(snap.phase == simulation::phase::MOTION);
+  }
+}
+
+
+/************************************************************************************************************************
+ * function  : drawMotion
+ *
+ * abstract  : Draws the motion vector of each plate as an arrow starting at the plate center.
+ *
+ * parameters: snap -- [in] snapshot holding the plates
+ *
+ * returns   : void
+ *
+ * written   : Oct 2026 (gkhuber) -- moved here from onSimMotion
+************************************************************************************************************************/
+void terrainGen::drawMotion(const simSnapshot& snap)
+{
+  for (const plateSnapshot& plate : snap.plates)
+  {
+    double_t OrigX = plate.center_x;
+    double_t OrigY = plate.center_y;
+    double_t DestX = OrigX + 10 * plate.speed * cos(plate.direction * (pi / 180));
+    double_t DestY = OrigY + 10 * plate.speed * sin(plate.direction * (pi / 180));
+
+    QGraphicsLineItem* line = new QGraphicsLineItem(OrigX, OrigY, DestX, DestY);
+    line->setPen(QPen(Qt::black));
+    m_pScene->addItem(line);
+
+    double_t HeadX = DestX + 4 * cos(45 * pi / 180);
+    double_t HeadY = DestY + 4 * cos(45 * pi / 180);
+    QGraphicsLineItem* head = new QGraphicsLineItem(DestX, DestY, HeadX, HeadY);
+    head->setPen(QPen(Qt::black));
+    m_pScene->addItem(head);
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::INFO, "       orig: (%.4f,%.4f) dest:(%.4f,%.4f)", OrigX, OrigY, DestX, DestY);
+  }
+
+  m_bMotionDrawn = true;
 }
 
 
@@ -1041,7 +1499,7 @@ horizontal:
  * 
  * Input   : void
  *
- * Returns : void.  modifies m_vecGrid 
+ * Returns : void.  modifies m_grid
  *
  * Written : Dec 2025 (gkhuber) 
  *           Mar 2025 (gkhuber) -- modified to incorporate new hexagon class derived from QGraphicsItem.  Also split
@@ -1050,112 +1508,37 @@ horizontal:
  *                                 to just calculate the grid and the display them.  Also implementing the concept of 
  *                                 layers, with the border going in the border-layer, and the grid going in the 
  *                                 grid layer.
+ *           Oct 2026 (gkhuber) -- also builds the neighbor table in m_grid, so that plate growth does not need to
+ *                                 search the grid.  Removed the extra hexagon that was added at the start of the
+ *                                 horizontal grid, it duplicated the first cell of row 0 and broke row-major ids.
+ *           Oct 2026 (gkhuber) -- centers are no longer truncated to integer offsets, so that the hexagons lie exactly
+ *                                 on the lattice used by hexGrid::cellAt.
+ *           Oct 2026 (gkhuber) -- the centers and the state of the cells now live in the hexGrid model, this function
+ *                                 sizes the model and builds the hexagon items that view it.
+ *           Oct 2026 (gkhuber) -- the cells are painted by the hex layer straight from the model, no item is created per
+ *                                 cell for the hexagons.  The size of a label is measured once.
+ *           Oct 2026 (gkhuber) -- center dots and labels are painted by the label layer, only for the cells in view.
  *********************************************************************************************************************/
 void terrainGen::genGrid(QPen pen)
 {
-  QPointF    initialCenter;  // center of top left hexagon
-  float      width;          // width of hexagon, depends on orientation
-  float      height;         // height of hexagon, depends on orientation
-
   CLogger::getInstance()->outMsg(cmdLine, CLogger::level::INFO, "current size of border is (%.4f, %.4f, %.4f, %.4f)", 0, 0, m_props->imageWidth, m_props->imageHeight);
 
-  if (m_props->hexagonOrient == hexagon::orien::VERTICAL)
-  {
-    height = 2 * m_props->hexagonSize;
-    width = m_props->hexagonSize * sqrt3;
-    const double_t deltaHeight = 0.75 * height;
-    const double_t deltaWidth = width;
-    
-    // calculate center of first hexagon
-    initialCenter = QPointF(0.5 * width, 0.5 * height);
-
-    // calculate number of rows and columns
-    int32_t maxRow = ceil(m_props->imageHeight/(0.75*height));
-    int32_t maxCol = ceil(m_props->imageWidth/width);
+  uint32_t   maxRow;         // number of rows in the grid
+  uint32_t   maxCol;         // number of columns in the grid
 
-    // build grid
-    QPointF center = initialCenter;
-    for (int row = 0; row < maxRow; row++)
-    {
-      QPointF rowCenter = initialCenter + QPoint(0, deltaHeight * row);
-      // if row is odd, then need to offset the rowCenter
-      if ((row % 2))
-      {
-        rowCenter += QPointF(0.5 * width, 0);
-      }
-      
-      for (int col = 0; col < maxCol; col++)
-      {
-        center = rowCenter + QPoint(deltaWidth * col, 0);
-        hexagon* temp = new hexagon(center, m_props, m_layers[0]);
-
-        // TODO : construct label and center -- need to do it here so we have access to layers
-        QGraphicsEllipseItem* centerPt = new QGraphicsEllipseItem(center.x() - 2, center.y() - 2, 4, 4, m_layers[5]);
-        centerPt->setBrush(QBrush(Qt::black, Qt::SolidPattern));
-        QRectF bbox;
-        QString txt = temp->getLabel(&bbox);
-        if (bbox.width() < width - 5)              // hexagon is big enough to display label
-        {
-          QGraphicsTextItem* label = new QGraphicsTextItem(txt, m_layers[5]);
-          label->setPos(center - QPoint(0.5*bbox.width(), bbox.height()+3)/* + QPointF(-0.5 * bbox.width(), -0.5 * bbox.height()) */);
-        }
-        m_vecGrid.push_back(temp);
-      }
-    }
-  }
-  else if(m_props->hexagonOrient == hexagon::orien::HORIZONTAL)
-  {
-    width = 2 * m_props->hexagonSize;
-    height = m_props->hexagonSize * sqrt(3);
-    const double_t deltaHeight = 0.5*height;                           // space between adjacent cneters in y direction
-                                                                       // (half of vertical spacing to account for packing)
-    const double_t deltaWidth = 1.50 * width;                          // space between adjacent centers in x direction 
-                                                                       // (twice of horizontal spacing to account packing)
-    initialCenter = QPointF(0.5 * width, 0.5 * height);
-
-    hexagon* temp1 = new hexagon(initialCenter, m_props, m_layers[0]);
-    m_vecGrid.push_back(temp1);
-
-    // calculate number of rows and columns
-    int32_t maxRow = m_props->imageHeight / (0.5*height);
-    int32_t maxCol = ceil(m_props->imageWidth / (1.5*width));
-
-    // build grid
-    QPointF center = initialCenter;
-    for (int row = 0; row < maxRow; row++)
-    {
-      QPointF rowCenter = initialCenter + QPoint(0, deltaHeight * row);
-      // if row is odd, then need to offset the rowCenter
-      if ((row % 2))
-      {
-        rowCenter += QPointF(0.75 * width, 0);
-      }
-
-      for (int col = 0; col < maxCol; col++)
-      {
-        center = rowCenter + QPoint(deltaWidth * col, 0);
-        hexagon* temp = new hexagon(center, m_props, m_layers[0]);
-
-        // TODO : construct label and center -- need to do it here so we have access to layers
-        QGraphicsEllipseItem* centerPt = new QGraphicsEllipseItem(center.x() - 2, center.y() - 2, 4, 4, m_layers[5]);
-        centerPt->setBrush(QBrush(Qt::black, Qt::SolidPattern));
-        QRectF bbox;
-        QString txt = temp->getLabel(&bbox);
-        if (bbox.width() < width - 5)              // hexagon is big enough to display label
-        {
-          QGraphicsTextItem* label = new QGraphicsTextItem(txt, m_layers[5]);
-          label->setPos(center - QPoint(0.5 * bbox.width(), bbox.height() + 3));
-        }
-        m_vecGrid.push_back(temp);
-      }
-    }
-  }
-  else
+  if (!hexGrid::dimensions(m_props->hexagonOrient, m_props->hexagonSize, m_props->imageWidth, m_props->imageHeight, &maxRow, &maxCol))
   {
     QMessageBox::warning(nullptr, "geometry error", "unsupported geometry");
     CLogger::getInstance()->outMsg(cmdLine, CLogger::level::ERR, "unsupported geometry, should be either VERTICAL(1) or "\
                                    "HORIZONTAL(2).Orientation is : % d", (int)m_props->hexagonOrient);
+    return;
   }
+
+  // build the grid model, this calculates the centers and the neighbors of each cell
+  m_grid.build(m_props->hexagonOrient, m_props->hexagonSize, maxRow, maxCol);
+  m_palette.assign(1, 0xFF000000);
+  if (nullptr != m_hexLayer) m_hexLayer->gridChanged();
+  if (nullptr != m_labelLayer) m_labelLayer->gridChanged();
 }
 
 
@@ -1177,7 +1560,7 @@ void terrainGen::adjustBorderSize()
   double_t twoRowHeight;
   double_t twoRowWidth;
 
-  if (m_props->hexagonOrient == hexagon::orien::VERTICAL)
+  if (m_props->hexagonOrient == hexGrid::orien::VERTICAL)
   {
     height = 2 * m_props->hexagonSize;
     width = m_props->hexagonSize * sqrt3;
@@ -1199,7 +1582,7 @@ void terrainGen::adjustBorderSize()
       m_props->imageHeight = (floor(cntHexagons) + 1) * twoRowHeight;
     }
   }
-  else if (m_props->hexagonOrient == hexagon::orien::HORIZONTAL)
+  else if (m_props->hexagonOrient == hexGrid::orien::HORIZONTAL)
   {
     width = 2 * m_props->hexagonSize;
     height = m_props->hexagonSize * sqrt(3);
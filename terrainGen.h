@@ -4,11 +4,13 @@
 #include <QMainWindow>
 #include <QString>
 #include <QPointF>
+#include <QColor>
 #include <random>
 
 #include "constants.h"
 #include "mapDisplay.h"
 #include "graphicsLayer.h"
+#include "hexGrid.h"
 
 class QMenuBar;
 class QStatusBar;
@@ -16,8 +18,17 @@ class QGraphicsView;
 class QGraphicsScene;
 class imagePropDlg;
 class CGEVDist;
-class hexagon;
+class hexLayer;
+class labelLayer;
 class QTimer;
+class simulation;
+class threadPool;
+class historyReader;
+class QSlider;
+class QProgressBar;
+class QPushButton;
+class worldSaver;
+struct simSnapshot;
 
 class terrainGen : public QMainWindow
 {
@@ -28,14 +39,19 @@ public:
     terrainGen();
     ~terrainGen();
 
+    const hexGrid& getGrid() const { return m_grid; }
+
 
 
 public slots:
     void onFileOpen();
+    void onFileOpenHistory();
     void onFileNew();
     void onFileClose();
     void onFileSave();
     void onFileSaveAs();
+    void onFileExport();
+    void onFileExportTiles();
     void onFileExit();
     void onViewZoom();
     void onViewZoomIn();
@@ -49,6 +65,12 @@ public slots:
     void onSimMotion();
     void onSimTimeDelta();
     void onSimRun();
+    void onSimStop();
+    void onSimRecord(bool checked);
+    void onTimelineMoved(int frame);
+    void onSimFrame();
+    void onSaveCancel();
+    void onAutosave();
     void onEditPrefs();
     void onEditPlateColors();
     void onHelpHelp();
@@ -69,6 +91,9 @@ private:
     bool            m_isVisible[mapLayers];
     QMenuBar*       m_menubar;
     QStatusBar*     m_statusbar;
+    QSlider*        m_timeline;                     // frame of the history file shown, hidden without one
+    QProgressBar*   m_saveProgress;                 // progress of a background save, hidden without one
+    QPushButton*    m_saveCancel;
 
     // image parameters
     uint64_t           m_imageWidth;                // these are the default values
@@ -85,15 +110,29 @@ private:
     uint64_t           m_timeStep;
     uint64_t           m_maxTime;
     uint64_t           m_curTime;
-    QPointF*           m_centers;
-    QTimer*            m_timer = nullptr;
+    bool               m_bAnimate;                    // animate plate growth instead of running it to completion
+    uint32_t           m_keyInterval;                 // time steps from one keyframe of a history file to the next
+    bool               m_bRecording = false;          // the simulation was recording at the last frame
+    historyReader*     m_history = nullptr;           // history file shown instead of the simulation, see onFileOpenHistory
+    uint32_t           m_cntThreads;                  // threads used by the simulation, 0 => one per core
+    simulation*        m_sim = nullptr;               // runs the simulation on its own thread
+    QTimer*            m_frameTimer = nullptr;        // picks up the latest snapshot of the simulation
+    threadPool*        m_renderPool = nullptr;        // threads used to rasterize the map
+    worldSaver*        m_saver = nullptr;             // writes terrain files in the background, see doSave
+    bool               m_bAutosave = false;           // the save under way is an autosave
+    uint32_t           m_autosaveMinutes;             // minutes between autosaves of a running simulation, 0 => never
+    QTimer*            m_autosaveTimer = nullptr;
+    bool               m_bMotionDrawn = false;        // motion vectors have been added to the scene
 
     // actions of menus
     QAction* m_pFileOpen;
+    QAction* m_pFileOpenHistory;
     QAction* m_pFileNew;
     QAction* m_pFileClose;
     QAction* m_pFileSave;
     QAction* m_pFileSaveAs;
+    QAction* m_pFileExport;
+    QAction* m_pFileExportTiles;
     QAction* m_pFileExit;
     QAction* m_pViewZoom;
     QAction* m_pViewZoomIn;
@@ -107,7 +146,10 @@ private:
     QAction* m_pSimPrepPlates;
     QAction* m_pSimMotion;
     QAction* m_pSimTimeDelta;
+    QAction* m_pSimAnimate;
     QAction* m_pSimRun;
+    QAction* m_pSimStop;
+    QAction* m_pSimRecord;
     QAction* m_pHelpHelp;
     QAction* m_pHelpAbout;
     QAction* m_pViewLayer[mapLayers];
@@ -116,11 +158,11 @@ private:
     bool                     m_bDirty;
     bool                     m_bInit = false;
     QString                  m_fileName;
-    std::vector<hexagon*>    m_vecGrid;
-    platesT*                 m_plates;
-
-    std::random_device       m_rd;
-    std::mt19937*            m_gen;
+    hexLayer*                m_hexLayer = nullptr;   // view of the grid, paints every cell; owned by the scene
+    labelLayer*              m_labelLayer = nullptr; // center dots and cell ids of the cells in view; owned by the scene
+    hexGrid                  m_grid;                 // grid shown in the scene, a copy of the latest simulation snapshot
+                                                     // or the frame of the history file picked on the timeline
+    std::vector<uint32_t>    m_palette;              // color of each plate (0xAARRGGBB), indexed by plate (0 = no plate)
 
 
     // private functions
@@ -131,9 +173,13 @@ private:
     void setupMenu();
 
     void doSave();
+    void checkSave();
+    void clearScene();
+    void closeHistory();
+    void buildScene();
     void adjustBorderSize();
     void genGrid(QPen);
-    void onSimPlatesImpl();
+    void drawMotion(const simSnapshot& snap);
 };
 
 
@@ -0,0 +1,162 @@
+
+#include "threadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+
+threadPool::threadPool(uint32_t cntThreads) : m_cntThreads(cntThreads), m_cntPending(0), m_bStop(false)
+{
+  if (0 == m_cntThreads)
+    m_cntThreads = std::max(1u, std::thread::hardware_concurrency());
+
+  for (uint32_t ndx = 1; ndx < m_cntThreads; ndx++)                    // the calling thread is the first worker
+    m_workers.emplace_back(&threadPool::workerLoop, this);
+}
+
+
+threadPool::~threadPool()
+{
+  {
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_bStop = true;
+  }
+  m_cvTask.notify_all();
+
+  for (std::thread& worker : m_workers)
+    worker.join();
+}
+
+
+/**********************************************************************************************************************
+ * Function: submit
+ *
+ * Abstract: Queues a task to be run by one of the workers.  If the pool has no worker threads the task is run before
+ *           this function returns.
+ *
+ * Input   : task -- [in] function to run
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void threadPool::submit(std::function<void()> task)
+{
+  if (m_workers.empty())
+  {
+    task();
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_tasks.push_back(std::move(task));
+    m_cntPending++;
+  }
+  m_cvTask.notify_one();
+}
+
+
+void threadPool::wait()
+{
+  std::unique_lock<std::mutex> guard(m_lock);
+  m_cvIdle.wait(guard, [this]() { return (0 == m_cntPending); });
+}
+
+
+/**********************************************************************************************************************
+ * Function: parallelFor
+ *
+ * Abstract: Runs fn over the range [0, count) split into chunks.  Chunks are handed out through an atomic counter, so
+ *           a worker that finishes early simply takes the next chunk.  The state shared by the chunks is reference
+ *           counted, a helper task that only starts after the range is finished finds no work and returns.
+ *
+ * Input   : count -- [in] number of items in the range
+ *           grain -- [in] minimum number of items in a chunk, ranges smaller than this run on the calling thread
+ *           fn    -- [in] function called as fn(begin, end) for each chunk
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void threadPool::parallelFor(uint64_t count, uint64_t grain, const std::function<void(uint64_t, uint64_t)>& fn)
+{
+  struct rangeState
+  {
+    std::atomic<uint64_t>   next{ 0 };
+    std::atomic<uint64_t>   done{ 0 };
+    uint64_t                count = 0;
+    uint64_t                chunk = 0;
+    std::mutex              lock;
+    std::condition_variable cvDone;
+  };
+
+  if (0 == count) return;
+  if (grain < 1) grain = 1;
+
+  if ((m_workers.empty()) || (count <= grain))
+  {
+    fn(0, count);
+    return;
+  }
+
+  std::shared_ptr<rangeState> state = std::make_shared<rangeState>();
+  state->count = count;
+  state->chunk = std::max(grain, count / (4 * (uint64_t)m_cntThreads));   // a few chunks per thread to balance load
+
+  uint64_t cntChunks = (count + state->chunk - 1) / state->chunk;
+  const std::function<void(uint64_t, uint64_t)>* pfn = &fn;                // fn outlives every chunk, see below
+
+  auto body = [state, pfn]()
+  {
+    uint64_t begin;
+    while ((begin = state->next.fetch_add(state->chunk)) < state->count)
+    {
+      uint64_t end = std::min(begin + state->chunk, state->count);
+      (*pfn)(begin, end);
+
+      if (state->done.fetch_add(end - begin) + (end - begin) == state->count)
+      {
+        std::lock_guard<std::mutex> guard(state->lock);
+        state->cvDone.notify_all();
+      }
+    }
+  };
+
+  uint64_t cntHelpers = std::min<uint64_t>(cntChunks - 1, m_workers.size());
+  for (uint64_t ndx = 0; ndx < cntHelpers; ndx++)
+    submit(body);
+
+  body();                                                                 // the caller works too
+
+  // fn is only called while chunks remain, and we do not return until all of them are done
+  std::unique_lock<std::mutex> guard(state->lock);
+  state->cvDone.wait(guard, [&state]() { return (state->done.load() == state->count); });
+}
+
+
+void threadPool::workerLoop()
+{
+  for (;;)
+  {
+    std::function<void()> task;
+
+    {
+      std::unique_lock<std::mutex> guard(m_lock);
+      m_cvTask.wait(guard, [this]() { return (m_bStop || !m_tasks.empty()); });
+
+      if (m_bStop && m_tasks.empty()) return;
+
+      task = std::move(m_tasks.front());
+      m_tasks.pop_front();
+    }
+
+    task();
+
+    {
+      std::lock_guard<std::mutex> guard(m_lock);
+      if (0 == --m_cntPending) m_cvIdle.notify_all();
+    }
+  }
+}
@@ -0,0 +1,54 @@
+/**********************************************************************************************************************
+ * Class    : threadPool
+ *
+ * Abstract : A small pool of worker threads used to spread the simulation and rendering work across the cores of the
+ *            machine.  Work is handed to the pool in one of two ways
+ *               (1) 'submit' queues a single task, 'wait' blocks until every queued task has finished, and
+ *               (2) 'parallelFor' splits the range [0, count) into chunks of at least 'grain' items and runs the
+ *                   chunks on the workers.  The calling thread works on chunks as well, so parallelFor may be called
+ *                   from inside a task without dead-locking the pool.  It returns once every chunk is done.
+ *            A pool created with a single thread runs everything on the calling thread.
+ *
+ * History  : created Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+
+#ifndef _threadPool_h_
+#define _threadPool_h_
+
+#include <cstdint>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+class threadPool
+{
+public:
+  explicit threadPool(uint32_t cntThreads = 0);             // 0 => one thread per hardware core
+  ~threadPool();
+
+  uint32_t getCount() const { return m_cntThreads; }
+
+  void submit(std::function<void()> task);
+  void wait();
+  void parallelFor(uint64_t count, uint64_t grain, const std::function<void(uint64_t, uint64_t)>& fn);
+
+private:
+  uint32_t                           m_cntThreads;         // number of threads doing work, including the caller
+  std::vector<std::thread>           m_workers;
+  std::deque<std::function<void()>>  m_tasks;
+  std::mutex                         m_lock;
+  std::condition_variable            m_cvTask;             // signaled when a task is queued, or on shutdown
+  std::condition_variable            m_cvIdle;             // signaled when the last outstanding task finishes
+  uint64_t                           m_cntPending;         // tasks queued or running
+  bool                               m_bStop;
+
+  void workerLoop();
+
+  threadPool(const threadPool&) = delete;
+  threadPool& operator=(const threadPool&) = delete;
+};
+
+#endif
@@ -0,0 +1,457 @@
+
+#include "tileExport.h"
+#include "hexGrid.h"
+#include "hexLayer.h"
+#include "labelLayer.h"
+#include "threadPool.h"
+#include "logger.h"
+
+#include <QPainter>
+#include <QPen>
+#include <QBuffer>
+#include <QString>
+#include <QStyleOptionGraphicsItem>
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+
+
+const char* tileExport::manifestName = "tiles.manifest";
+
+
+tileExport::tileExport(const hexGrid* grid, const std::vector<uint32_t>* palette, threadPool* pool) : m_grid(grid), m_palette(palette),
+                       m_renderer(grid, palette, pool), m_pool(pool),
+                       m_labels(nullptr), m_maxZoom(0), m_layers(allLayers), m_unit(1), m_cntWritten(0), m_cntEmpty(0), m_cntUniform(0),
+                       m_cntResumed(0), m_bFailed(false)
+{
+  m_renderer.setMode(mapRenderer::mode::PLATES);
+  m_renderer.setBackground(0);
+}
+
+
+tileExport::~tileExport()
+{
+  delete m_labels;
+}
+
+
+/**********************************************************************************************************************
+ * Function: zoomFor
+ *
+ * Abstract: The smallest deepest zoom at which a hexagon is at least the given size.
+ *
+ * Input   : props      -- [in] properties of the map
+ *           cellPixels -- [in] width of a hexagon, in pixels, wanted at the deepest zoom
+ *
+ * Returns : zoom level
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+uint32_t tileExport::zoomFor(const imageProps& props, double cellPixels)
+{
+  double cellWidth = (props.hexagonOrient == hexGrid::orien::VERTICAL) ? props.hexagonSize * sqrt3 : 2 * props.hexagonSize;
+  double pixels = std::fmax(props.imageWidth, props.imageHeight) * cellPixels / cellWidth;     // longer side of the map
+  double zoom = std::ceil(std::log2(std::fmax(pixels / tileSize, 1.0)));
+
+  return (uint32_t)std::fmin(zoom, maxZoomLevel);
+}
+
+
+/**********************************************************************************************************************
+ * Function: write
+ *
+ * Abstract: Builds the tile pyramid.  The subtrees below the first zoom level with enough tiles to keep every thread
+ *           busy are built in parallel, then the few levels above them are built from their roots.
+ *
+ * Input   : dir     -- [in] directory the tiles are written to, created if needed
+ *           props   -- [in] properties of the map, the grid must have been built from them
+ *           seed    -- [in] seed and simulated time of the world shown by the grid, recorded in the manifest
+ *           curTime -- [in]
+ *           maxZoom -- [in] deepest zoom level
+ *           layers  -- [in] layers to draw, bit n for layer n of layerName
+ *
+ * Returns : true if every tile was written
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+bool tileExport::write(const std::string& dir, const imageProps& props, uint32_t seed, uint64_t curTime, uint32_t maxZoom, uint32_t layers)
+{
+  if ((m_grid->getCount() == 0) || (m_grid->getOrient() != props.hexagonOrient) || (m_grid->getSize() != props.hexagonSize))
+  {
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::ERR, "tile export: the grid was not built from the image properties");
+    return false;
+  }
+
+  m_dir = dir;
+  m_props = props;
+  m_maxZoom = std::min(maxZoom, maxZoomLevel);
+  m_layers = layers;
+  m_unit = std::fmax(props.imageWidth, props.imageHeight) / ((double)tileSize * (1ull << m_maxZoom));
+  m_uniform.clear();
+  m_cntWritten = 0;
+  m_cntEmpty = 0;
+  m_cntUniform = 0;
+  m_cntResumed = 0;
+  m_bFailed = false;
+
+  // everything the pixels of a tile depend on; the colors are folded into an FNV-1a hash
+  uint64_t           colors = 14695981039346656037ull;
+  std::ostringstream manifest;
+
+  if (nullptr != m_palette)
+    for (uint32_t color : *m_palette)
+      colors = (colors ^ color) * 1099511628211ull;
+
+  manifest.precision(17);
+  manifest << "terrainGen tiles 1\n" << "width " << props.imageWidth << "\nheight " << props.imageHeight << "\nsize " << props.hexagonSize
+           << "\norient " << (int)props.hexagonOrient << "\nplates " << props.cntPlates << "\nseed " << seed << "\ntime " << curTime
+           << "\ncolors " << std::hex << colors << std::dec << "\nlayers " << m_layers << "\nmaxZoom " << m_maxZoom << "\n";
+
+  if (!prepareDir(manifest.str())) return false;
+
+  if ((m_layers & (1 << layerRivers)) || (m_layers & (1 << layerCoasts)))
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::DEBUG, "tile export: rivers/lakes and coasts are not modeled yet, nothing drawn for them");
+  if ((m_layers & (1 << layerLabels)) && (nullptr == m_labels))
+    m_labels = new labelLayer(m_grid);
+  if (nullptr != m_labels) m_labels->gridChanged();
+
+  // level whose subtrees are built in parallel, at least four subtrees per thread
+  uint32_t cntThreads = (nullptr != m_pool) ? m_pool->getCount() : 1;
+  uint32_t split = 0;
+  while ((split < m_maxZoom) && ((1ull << (2 * split)) < 4ull * cntThreads)) split++;
+
+  uint64_t            side = 1ull << split;
+  std::vector<QImage> level(side * side);
+
+  auto buildSubtrees = [&](uint64_t begin, uint64_t end)
+  {
+    for (uint64_t ndx = begin; (ndx < end) && !m_bFailed; ndx++)
+      level[ndx] = buildTile(split, (uint32_t)(ndx % side), (uint32_t)(ndx / side));
+  };
+
+  if (nullptr != m_pool) m_pool->parallelFor(level.size(), 1, buildSubtrees);
+  else buildSubtrees(0, level.size());
+
+  for (uint32_t z = split; (z > 0) && !m_bFailed; z--)
+  {
+    uint64_t            half = 1ull << (z - 1);
+    std::vector<QImage> parents(half * half);
+
+    for (uint64_t ndx = 0; ndx < parents.size(); ndx++)
+    {
+      uint32_t x = (uint32_t)(ndx % half);
+      uint32_t y = (uint32_t)(ndx / half);
+      QImage   children[4] = { level[(2 * y) * (2 * half) + 2 * x], level[(2 * y) * (2 * half) + 2 * x + 1],
+                               level[(2 * y + 1) * (2 * half) + 2 * x], level[(2 * y + 1) * (2 * half) + 2 * x + 1] };
+
+      parents[ndx] = combine(children);
+      saveTile(z - 1, x, y, parents[ndx]);
+    }
+    level.swap(parents);
+  }
+
+  CLogger::getInstance()->outMsg(cmdLine, CLogger::level::INFO, "tile export to %s, zoom 0 to %u: %llu tiles written (%llu of one color), %llu empty, "
+                                 "%llu already done", dir.c_str(), m_maxZoom, (unsigned long long)m_cntWritten, (unsigned long long)m_cntUniform,
+                                 (unsigned long long)m_cntEmpty, (unsigned long long)m_cntResumed);
+  return !m_bFailed;
+}
+
+
+/**********************************************************************************************************************
+ * Function: prepareDir
+ *
+ * Abstract: Makes sure the tiles already in the directory belong to this export before any of them is reused.  With a
+ *           manifest equal to this one the export resumes.  With a different manifest the tiles are of another map,
+ *           or another view of it, and are removed.  Without a manifest, a directory that is not empty is refused, as
+ *           the files in it are not known to be tiles.  The manifest of this export is then written.
+ *
+ * Input   : manifest -- [in] the manifest of this export
+ *
+ * Returns : true if the tiles can be written
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+bool tileExport::prepareDir(const std::string& manifest)
+{
+  namespace fs = std::filesystem;
+  std::string     path = m_dir + "/" + manifestName;
+  std::error_code ec;
+
+  if (fs::exists(path, ec))
+  {
+    std::ifstream file(path, std::ios::binary);
+    std::string   old((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if (old == manifest) return true;
+
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::INFO, "tile export: %s holds the tiles of another export, removing them", m_dir.c_str());
+    for (uint32_t z = 0; z <= maxZoomLevel; z++)
+      fs::remove_all(m_dir + "/" + std::to_string(z), ec);
+    fs::remove(path, ec);
+  }
+  else if (fs::exists(m_dir, ec) && !fs::is_empty(m_dir, ec))
+  {
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::ERR, "tile export: %s is not empty and has no %s, choose an empty directory",
+                                   m_dir.c_str(), manifestName);
+    return false;
+  }
+
+  std::string part = path + ".part";
+
+  fs::create_directories(m_dir, ec);
+  std::ofstream file(part, std::ios::binary | std::ios::trunc);
+  file << manifest;
+  file.close();
+  if (!file.fail()) fs::rename(part, path, ec);
+  if (file.fail() || ec)
+  {
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::ERR, "tile export: cannot write %s", path.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+
+/**********************************************************************************************************************
+ * Function: buildTile
+ *
+ * Abstract: Builds a tile and, depth first, every tile below it that is not on disk yet.  A tile already on disk is
+ *           loaded instead, its children were written before it (prepareDir has checked it is of this export).
+ *
+ * Input   : z, x, y -- [in] the tile
+ *
+ * Returns : the tile, a null image if it is empty
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+QImage tileExport::buildTile(uint32_t z, uint32_t x, uint32_t y)
+{
+  if (m_bFailed || !onMap(z, x, y)) return QImage();
+
+  std::string path = tilePath(z, x, y);
+  QImage      tile;
+
+  if (std::filesystem::exists(path) && tile.load(QString::fromStdString(path), "PNG"))
+  {
+    m_cntResumed++;
+    return tile.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+  }
+
+  if (z == m_maxZoom)
+  {
+    tile = renderTile(x, y);
+  }
+  else
+  {
+    QImage children[4];
+
+    for (uint32_t ndx = 0; ndx < 4; ndx++)
+      children[ndx] = buildTile(z + 1, 2 * x + (ndx & 1), 2 * y + (ndx >> 1));
+    tile = combine(children);
+  }
+
+  return saveTile(z, x, y, tile) ? tile : QImage();
+}
+
+
+/**********************************************************************************************************************
+ * Function: renderTile
+ *
+ * Abstract: Renders a tile of the deepest zoom.  The painter is set up to map scene coordinates to the tile, so the
+ *           label layer can paint itself into it exactly as it paints into the view, including its own rules on when
+ *           labels are legible.  Outlines are only drawn where a hexagon is big enough to show them (see
+ *           hexLayer::detailFor).
+ *
+ * Input   : x, y -- [in] the tile
+ *
+ * Returns : the tile
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+QImage tileExport::renderTile(uint32_t x, uint32_t y)
+{
+  QRectF scene(x * tileSize * m_unit, y * tileSize * m_unit, tileSize * m_unit, tileSize * m_unit);
+  QImage tile(tileSize, tileSize, QImage::Format_ARGB32_Premultiplied);
+  double cellWidth, cellHeight;
+
+  m_grid->cellSize(&cellWidth, &cellHeight);
+
+  if (m_layers & (1 << layerPlates)) m_renderer.render(rasterOf(&tile), sceneOf(scene), pixelsOf(tile.rect()));
+  else tile.fill(0);
+
+  bool bGrid = (m_layers & (1 << layerGrid)) && (hexLayer::detailFor(cellWidth / m_unit) == hexLayer::detail::OUTLINE);
+  bool bBorder = (m_layers & (1 << layerBorder));
+  bool bLabels = (m_layers & (1 << layerLabels)) && (nullptr != m_labels);
+
+  if (!bGrid && !bBorder && !bLabels) return tile;
+
+  QPainter painter(&tile);
+  painter.scale(1 / m_unit, 1 / m_unit);
+  painter.translate(-scene.left(), -scene.top());
+
+  if (bGrid)
+  {
+    uint32_t rowFirst, rowLast, colFirst, colLast;
+    pointF   corners[6];
+    QPointF  verts[6];
+    QPen     pen(Qt::black);
+
+    pen.setWidth(0);                                         // one pixel whatever the scale
+    painter.setPen(pen);
+    painter.setBrush(Qt::NoBrush);
+
+    m_grid->cellRange(scene.left(), scene.top(), scene.right(), scene.bottom(), &rowFirst, &rowLast, &colFirst, &colLast);
+    for (uint32_t row = rowFirst; row <= rowLast; row++)
+    {
+      for (uint32_t col = colFirst; col <= colLast; col++)
+      {
+        m_grid->vertices(row * m_grid->getCols() + col, corners);
+        for (int ndx = 0; ndx < 6; ndx++) verts[ndx] = QPointF(corners[ndx].x(), corners[ndx].y());
+        painter.drawPolygon(verts, 6);
+      }
+    }
+  }
+
+  if (bBorder)
+  {
+    QPen pen(Qt::black);
+
+    pen.setWidth(2);                                         // as drawn in the view
+    painter.setPen(pen);
+    painter.setBrush(Qt::NoBrush);
+    painter.drawRect(QRectF(0, 0, m_props.imageWidth, m_props.imageHeight));
+  }
+
+  if (bLabels)
+  {
+    QStyleOptionGraphicsItem option;
+
+    option.exposedRect = scene;
+    m_labels->paint(&painter, &option, nullptr);
+  }
+
+  return tile;
+}
+
+
+QImage tileExport::combine(const QImage* children)
+{
+  QImage tile;
+
+  for (uint32_t ndx = 0; ndx < 4; ndx++)
+  {
+    if (children[ndx].isNull()) continue;
+
+    if (tile.isNull())
+    {
+      tile = QImage(tileSize, tileSize, QImage::Format_ARGB32_Premultiplied);
+      tile.fill(0);
+    }
+    mapRenderer::downsample(rasterOf(children[ndx]), rasterOf(&tile), (ndx & 1) * tileSize / 2, (ndx >> 1) * tileSize / 2);
+  }
+
+  return tile;
+}
+
+
+/**********************************************************************************************************************
+ * Function: saveTile
+ *
+ * Abstract: Writes a tile, unless it is empty.  The PNG is written to <y>.png.part and renamed once complete, so a
+ *           tile on disk is always whole.  A tile of a single color reuses the PNG encoded the first time that color
+ *           was seen.
+ *
+ * Input   : z, x, y -- [in] the tile
+ *           tile    -- [in] its pixels, may be a null image
+ *
+ * Returns : true if the tile is not empty (whether or not it was written)
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+bool tileExport::saveTile(uint32_t z, uint32_t x, uint32_t y, const QImage& tile)
+{
+  if (tile.isNull())
+  {
+    m_cntEmpty++;
+    return false;
+  }
+
+  const QRgb* pixels = reinterpret_cast<const QRgb*>(tile.constBits());
+  uint64_t    cntPixels = (uint64_t)tile.width() * tile.height();
+  bool        bUniform = true;
+
+  for (uint64_t ndx = 1; (ndx < cntPixels) && bUniform; ndx++)
+    bUniform = (pixels[ndx] == pixels[0]);
+
+  if (bUniform && (qAlpha(pixels[0]) == 0))
+  {
+    m_cntEmpty++;
+    return false;
+  }
+
+  std::string           path = tilePath(z, x, y);
+  std::string           part = path + ".part";
+  std::error_code       ec;
+  bool                  bRet;
+
+  std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+
+  if (bUniform)
+  {
+    QByteArray png;
+    {
+      std::lock_guard<std::mutex> guard(m_lock);
+      auto iter = m_uniform.find(pixels[0]);
+      if (iter == m_uniform.end())
+      {
+        QBuffer buffer(&png);
+        buffer.open(QIODevice::WriteOnly);
+        tile.save(&buffer, "PNG");
+        m_uniform[pixels[0]] = png;
+      }
+      else
+      {
+        png = iter->second;
+      }
+    }
+
+    std::ofstream file(part, std::ios::binary | std::ios::trunc);
+    file.write(png.constData(), png.size());
+    file.close();
+    bRet = !png.isEmpty() && !file.fail();
+    m_cntUniform++;
+  }
+  else
+  {
+    bRet = tile.save(QString::fromStdString(part), "PNG");
+  }
+
+  if (bRet) std::filesystem::rename(part, path, ec);
+  if (!bRet || ec)
+  {
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::ERR, "tile export: cannot write %s", path.c_str());
+    m_bFailed = true;
+    return true;
+  }
+
+  m_cntWritten++;
+  return true;
+}
+
+
+bool tileExport::onMap(uint32_t z, uint32_t x, uint32_t y) const
+{
+  double span = tileSize * m_unit * (double)(1ull << (m_maxZoom - z));     // scene size of a tile at zoom z
+
+  return (x * span < m_props.imageWidth) && (y * span < m_props.imageHeight);
+}
+
+
+std::string tileExport::tilePath(uint32_t z, uint32_t x, uint32_t y) const
+{
+  return m_dir + "/" + std::to_string(z) + "/" + std::to_string(x) + "/" + std::to_string(y) + ".png";
+}
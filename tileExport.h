@@ -0,0 +1,94 @@
+/**********************************************************************************************************************
+ * Class    : tileExport
+ *
+ * Abstract : Exports the map as a pyramid of 256x256 PNG tiles laid out as <dir>/<z>/<x>/<y>.png, the layout read by
+ *            slippy map viewers.  At the deepest zoom, maxZoom, the longer side of the map spans 256 * 2^maxZoom
+ *            pixels; each zoom level above it is half the size of the one below, and the map sits in the top left
+ *            corner of every level.
+ *            Only the tiles of the deepest zoom are rendered.  The plates are drawn by a mapRenderer, then the grid
+ *            outlines, the map border and the labels are painted over them when those layers are selected (the
+ *            rivers/lakes and coasts layers have nothing to draw yet).  Every other tile is built by scaling down its
+ *            four children (see mapRenderer::downsample).
+ *            The pyramid is built depth first, one subtree per task on the thread pool, so only the tiles along the
+ *            path being built are held in memory.  A tile is written to a temporary file which is then renamed, and
+ *            a parent only after its children, so after an interruption the export resumes where it stopped: a tile
+ *            that exists is loaded rather than built, and its subtree is not visited.
+ *            What is exported is recorded in <dir>/tiles.manifest before the first tile (the image properties, seed,
+ *            simulated time, plate colors, layers and deepest zoom).  Tiles are only reused when the manifest matches
+ *            the export asked for; the tiles of a different export are removed first, and a directory that holds
+ *            other files without a manifest is refused rather than mixed with them.
+ *            Tiles that are completely transparent are not written (viewers draw nothing where a tile is missing).
+ *            Tiles of a single color, common inside the plates, are not encoded one by one; the PNG of each color is
+ *            encoded once and copied.
+ *
+ * History  : created Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+
+#ifndef _tileExport_h_
+#define _tileExport_h_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <atomic>
+
+#include <QImage>
+#include <QByteArray>
+
+#include "constants.h"
+#include "mapRenderer.h"
+
+class hexGrid;
+class threadPool;
+class labelLayer;
+
+class tileExport
+{
+public:
+  static const uint32_t tileSize = 256;
+  static const uint32_t allLayers = (1 << mapLayers) - 1;
+
+  tileExport(const hexGrid* grid, const std::vector<uint32_t>* palette, threadPool* pool = nullptr);
+  ~tileExport();
+
+  bool write(const std::string& dir, const imageProps& props, uint32_t seed, uint64_t curTime, uint32_t maxZoom,
+             uint32_t layers = allLayers);
+
+  static uint32_t zoomFor(const imageProps& props, double cellPixels);
+
+private:
+  static const uint32_t maxZoomLevel = 20;
+  static const char*    manifestName;
+
+  const hexGrid*              m_grid;
+  const std::vector<uint32_t>* m_palette;
+  mapRenderer                 m_renderer;
+  threadPool*                 m_pool;
+  labelLayer*                 m_labels;
+
+  // state of the export in progress
+  std::string                 m_dir;
+  imageProps                  m_props;
+  uint32_t                    m_maxZoom;
+  uint32_t                    m_layers;          // bit n set => layer n of layerName is drawn
+  double                      m_unit;            // scene units per pixel at the deepest zoom
+  std::mutex                  m_lock;
+  std::map<QRgb, QByteArray>  m_uniform;         // PNG of a tile of a single color
+  std::atomic<uint64_t>       m_cntWritten;
+  std::atomic<uint64_t>       m_cntEmpty;
+  std::atomic<uint64_t>       m_cntUniform;
+  std::atomic<uint64_t>       m_cntResumed;
+  std::atomic<bool>           m_bFailed;
+
+  bool        prepareDir(const std::string& manifest);
+  QImage      buildTile(uint32_t z, uint32_t x, uint32_t y);
+  QImage      renderTile(uint32_t x, uint32_t y);
+  QImage      combine(const QImage* children);
+  bool        saveTile(uint32_t z, uint32_t x, uint32_t y, const QImage& tile);
+  bool        onMap(uint32_t z, uint32_t x, uint32_t y) const;
+  std::string tilePath(uint32_t z, uint32_t x, uint32_t y) const;
+};
+
+#endif
@@ -0,0 +1,57 @@
+/**********************************************************************************************************************
+ * Class    : tripleBuffer
+ *
+ * Abstract : A lock-free triple buffer used to hand snapshots from a single producer thread (the simulation) to a
+ *            single consumer thread (the GUI).  The three slots have fixed roles that rotate:
+ *               back   -- owned by the producer, it fills this slot with the next snapshot,
+ *               middle -- the most recently published snapshot, owned by neither side,
+ *               front  -- owned by the consumer, it reads this slot for as long as it likes.
+ *            'publish' swaps the back slot with the middle slot, and 'acquire' swaps the front slot with the middle
+ *            slot if something new has been published since the last acquire.  Both swaps are a single atomic
+ *            exchange, so neither side ever waits for the other; the producer simply overwrites a snapshot that the
+ *            consumer has not picked up yet, and the consumer always sees the newest complete snapshot.
+ *            The slots are reused, so once the vectors inside T have grown to size, publishing does not allocate.
+ *
+ * History  : created Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+
+#ifndef _tripleBuffer_h_
+#define _tripleBuffer_h_
+
+#include <atomic>
+#include <cstdint>
+
+template <typename T>
+class tripleBuffer
+{
+public:
+  tripleBuffer() : m_back(0), m_middle(1), m_front(2) {}
+
+  // producer side
+  T&   back() { return m_slots[m_back]; }
+  void publish() { m_back = m_middle.exchange(m_back | bFresh, std::memory_order_acq_rel) & maskSlot; }
+
+  // consumer side
+  const T& front() const { return m_slots[m_front]; }
+  bool acquire()
+  {
+    if ((m_middle.load(std::memory_order_relaxed) & bFresh) == 0) return false;    // nothing new since the last acquire
+
+    m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & maskSlot;
+    return true;
+  }
+
+private:
+  static const uint8_t  maskSlot = 0x03;
+  static const uint8_t  bFresh = 0x04;                 // set in m_middle when it holds a snapshot the consumer has not seen
+
+  T                     m_slots[3];
+  uint8_t               m_back;                        // only touched by the producer
+  std::atomic<uint8_t>  m_middle;
+  uint8_t               m_front;                       // only touched by the consumer
+
+  tripleBuffer(const tripleBuffer&) = delete;
+  tripleBuffer& operator=(const tripleBuffer&) = delete;
+};
+
+#endif
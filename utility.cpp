@@ -2,10 +2,9 @@
 
 #include <ostream>
 #include <iostream>
-#include <QPointF>
 
 
-int8_t orient(QPointF src, QPointF dst, QPointF pt)
+int8_t orient(pointF src, pointF dst, pointF pt)
 {
   int8_t orientation = dir::UNK;
 
@@ -19,7 +18,7 @@ int8_t orient(QPointF src, QPointF dst, QPointF pt)
 }
 
 
-std::ostream& operator<<(std::ostream& os, QPointF& other)
+std::ostream& operator<<(std::ostream& os, pointF& other)
 {
   os << "(" << other.x() << ", " << other.y() << ")" ;
   return os;
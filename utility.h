@@ -3,15 +3,15 @@
 
 #include <cstdint>
 #include <iostream>
-#include <QPoint>
+#include "constants.h"
 
 
 enum dir: std::int8_t{UNK=-1,LEFT=0, RIGHT=1, ON=2};
 
-int8_t orient(QPointF, QPointF, QPointF);
+int8_t orient(pointF, pointF, pointF);
 
 
-std::ostream& operator<<(std::ostream&, QPointF& other);
+std::ostream& operator<<(std::ostream&, pointF& other);
 
 
 #endif
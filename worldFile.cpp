@@ -0,0 +1,476 @@
+
+#include "worldFile.h"
+#include "hexGrid.h"
+#include "mappedFile.h"
+#include "logger.h"
+
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <algorithm>
+
+static const char     magic[8] = { 'T', 'E', 'R', 'R', 'A', 'I', 'N', '\x1a' };
+static const uint32_t byteOrder = 0x01020304;
+static const uint64_t alignment = 64;                        // size of the header and of a section header, see worldFile.h
+static const uint64_t chunkSize = 4 << 20;                   // the cell arrays are written, and progress reported, in chunks
+
+static constexpr uint32_t makeTag(char a, char b, char c, char d)
+{
+  return (uint32_t)(uint8_t)a | ((uint32_t)(uint8_t)b << 8) | ((uint32_t)(uint8_t)c << 16) | ((uint32_t)(uint8_t)d << 24);
+}
+
+static const uint32_t tagProps = makeTag('P', 'R', 'O', 'P');
+static const uint32_t tagGrid = makeTag('G', 'R', 'I', 'D');
+static const uint32_t tagCellPlate = makeTag('C', 'P', 'L', 'T');
+static const uint32_t tagCellStyle = makeTag('C', 'S', 'T', 'Y');
+static const uint32_t tagCellElevation = makeTag('C', 'E', 'L', 'V');
+static const uint32_t tagPlates = makeTag('P', 'L', 'T', 'S');
+static const uint32_t tagMotion = makeTag('M', 'O', 'T', 'N');
+static const uint32_t tagSim = makeTag('S', 'I', 'M', 'S');
+static const uint32_t tagRandom = makeTag('R', 'A', 'N', 'D');
+static const uint32_t tagResidual = makeTag('R', 'E', 'S', 'D');
+static const uint32_t tagEnd = makeTag('E', 'N', 'D', ' ');
+
+
+template <typename T>
+static void put(std::vector<uint8_t>* buf, T value)
+{
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+  buf->insert(buf->end(), bytes, bytes + sizeof(T));
+}
+
+
+/**********************************************************************************************************************
+ * Class    : sectionReader
+ *
+ * Abstract : Reads the fields of a section payload in order.  Reading past the end of the payload fails and leaves the
+ *            field untouched, which is how a field missing from an older file keeps its default.
+ *********************************************************************************************************************/
+class sectionReader
+{
+public:
+  sectionReader(const uint8_t* data, uint64_t len) : m_data(data), m_len(len), m_pos(0) {}
+
+  template <typename T>
+  bool get(T* value)
+  {
+    if (m_len - m_pos < sizeof(T)) return false;
+
+    memcpy(value, m_data + m_pos, sizeof(T));
+    m_pos += sizeof(T);
+    return true;
+  }
+
+  bool skip(uint64_t len)
+  {
+    if (m_len - m_pos < len) return false;
+
+    m_pos += len;
+    return true;
+  }
+
+  uint64_t left() const { return m_len - m_pos; }
+
+private:
+  const uint8_t*  m_data;
+  uint64_t        m_len;
+  uint64_t        m_pos;
+};
+
+
+static uint64_t padding(uint64_t len) { return (alignment - len % alignment) % alignment; }
+
+
+static bool writeSection(std::ofstream& file, uint32_t tag, const void* data, uint64_t len, const std::function<bool(uint64_t)>& written = nullptr)
+{
+  static const char zeros[alignment] = { 0 };
+  char              head[alignment] = { 0 };
+  const char*       bytes = reinterpret_cast<const char*>(data);
+
+  memcpy(head, &tag, sizeof(tag));
+  memcpy(head + 8, &len, sizeof(len));
+
+  file.write(head, alignment);
+  for (uint64_t pos = 0; pos < len; )
+  {
+    uint64_t chunk = std::min(len - pos, chunkSize);
+
+    file.write(bytes + pos, chunk);
+    pos += chunk;
+    if (written && !written(chunk)) return false;            // cancelled
+  }
+  file.write(zeros, padding(len));
+  return true;
+}
+
+
+/**********************************************************************************************************************
+ * Function: write
+ *
+ * Abstract: Writes a world to a terrain file, replacing the file if it exists.  The world is written to a temporary
+ *           file next to it (the name with ".tmp" added), which is renamed over the file only once it is complete, so a
+ *           save that fails, is cancelled or is cut short by a crash leaves the file as it was.
+ *
+ * Input   : path     -- [in] name of the file, UTF-8
+ *           state    -- [in] properties, plates and state of the simulation
+ *           grid     -- [in] the grid, built from state.props
+ *           progress -- [in] if given, called as the cell arrays are written with the bytes written so far and the
+ *                       bytes to write; returning false cancels the save
+ *
+ * Returns : true if the file was written
+ *
+ * Written : Oct 2026 (gkhuber)
+ *           Oct 2026 (gkhuber) -- written through a temporary file, progress and cancellation
+ *********************************************************************************************************************/
+bool worldFile::write(const std::string& path, const worldState& state, const hexGrid& grid, const std::function<bool(uint64_t, uint64_t)>& progress)
+{
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  std::filesystem::path target = std::filesystem::u8path(path);
+  std::filesystem::path temp = std::filesystem::u8path(path + ".tmp");
+  std::ofstream        file(temp, std::ios::binary | std::ios::trunc);
+  std::vector<uint8_t> buf;
+  std::error_code      ec;
+  uint64_t             cntCells = grid.getCount();
+  uint64_t             done = 0;
+  uint64_t             total = cntCells * (sizeof(uint16_t) + sizeof(uint8_t) + sizeof(float));
+
+  auto written = [&progress, &done, total](uint64_t len) { done += len; return !progress || progress(done, total); };
+  auto fail = [&file, &temp, &ec, &path](const char* reason)
+  {
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::ERR, "world file: %s %s", reason, path.c_str());
+    file.close();
+    std::filesystem::remove(temp, ec);
+    return false;
+  };
+
+  if (!file.is_open()) return fail("cannot create");
+
+  buf.assign(magic, magic + sizeof(magic));
+  put(&buf, version);
+  put(&buf, byteOrder);
+  put(&buf, (uint32_t)alignment);
+  buf.resize(alignment, 0);
+  file.write(reinterpret_cast<const char*>(buf.data()), buf.size());
+
+  buf.clear();
+  put(&buf, state.props.imageWidth);
+  put(&buf, state.props.imageHeight);
+  put(&buf, state.props.hexagonSize);
+  put(&buf, state.props.hexagonOrient);
+  put(&buf, state.props.hexagonProps);
+  put(&buf, state.props.cntPlates);
+  put(&buf, nbrHarmonics);
+  for (uint8_t ndx = 0; ndx < nbrHarmonics; ndx++) put(&buf, state.props.amplitude[ndx]);
+  for (uint8_t ndx = 0; ndx < nbrHarmonics; ndx++) put(&buf, state.props.frequency[ndx]);
+  writeSection(file, tagProps, buf.data(), buf.size());
+
+  buf.clear();
+  put(&buf, grid.getOrient());
+  put(&buf, grid.getSize());
+  put(&buf, grid.getRows());
+  put(&buf, grid.getCols());
+  writeSection(file, tagGrid, buf.data(), buf.size());
+
+  if (!writeSection(file, tagCellPlate, grid.plates(), cntCells * sizeof(uint16_t), written) ||
+      !writeSection(file, tagCellStyle, grid.styles(), cntCells * sizeof(uint8_t), written) ||
+      !writeSection(file, tagCellElevation, grid.elevations(), cntCells * sizeof(float), written))
+  {
+    file.close();
+    std::filesystem::remove(temp, ec);
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::INFO, "world file: save cancelled, %s is left as it was", path.c_str());
+    return false;
+  }
+
+  buf.clear();
+  put(&buf, (uint32_t)state.plates.size());
+  for (const platesT& plate : state.plates)
+  {
+    size_t start = buf.size();
+
+    put(&buf, (uint32_t)0);                                  // length of the record, filled in below
+    put(&buf, plate.ndx);
+    put(&buf, plate.center_x);
+    put(&buf, plate.center_y);
+    put(&buf, plate.color);
+    put(&buf, (uint32_t)plate.vec.size());
+    for (uint32_t cellID : plate.vec) put(&buf, cellID);
+
+    uint32_t len = (uint32_t)(buf.size() - start - sizeof(uint32_t));
+    memcpy(&buf[start], &len, sizeof(len));
+  }
+  writeSection(file, tagPlates, buf.data(), buf.size());
+
+  if (!state.speed.empty())
+  {
+    buf.clear();
+    put(&buf, (uint32_t)state.speed.size());
+    for (double_t speed : state.speed) put(&buf, speed);
+    for (double_t direction : state.direction) put(&buf, direction);
+    writeSection(file, tagMotion, buf.data(), buf.size());
+  }
+
+  buf.clear();
+  put(&buf, state.seed);
+  put(&buf, state.phase);
+  put(&buf, state.step);
+  put(&buf, state.claimed);
+  put(&buf, state.curTime);
+  writeSection(file, tagSim, buf.data(), buf.size());
+
+  if (!state.generator.empty())
+    writeSection(file, tagRandom, state.generator.data(), state.generator.size());
+
+  if (!state.residX.empty())
+  {
+    buf.clear();
+    put(&buf, (uint32_t)state.residX.size());
+    for (double_t resid : state.residX) put(&buf, resid);
+    for (double_t resid : state.residY) put(&buf, resid);
+    writeSection(file, tagResidual, buf.data(), buf.size());
+  }
+
+  writeSection(file, tagEnd, nullptr, 0);
+  file.close();
+
+  if (file.fail()) return fail("cannot write");
+
+  std::filesystem::rename(temp, target, ec);                 // replaces the file in one step
+  if (ec) return fail("cannot replace");
+
+  long long elapsed = (long long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+  CLogger::getInstance()->outMsg(cmdLine, CLogger::level::INFO, "world saved to %s: %llu cells, %d plates, %lld ms", path.c_str(), (unsigned long long)cntCells,
+                                 (int)state.plates.size(), elapsed);
+  return true;
+}
+
+
+/**********************************************************************************************************************
+ * Function: read
+ *
+ * Abstract: Reads a world from a terrain file.  The file is mapped into memory (see mappedFile) and the sections are
+ *           parsed where they lie.  The cell arrays are not copied: the grid is built from the GRID section and then
+ *           uses the arrays in the mapping, which it keeps alive for as long as it uses them.  So opening a file
+ *           costs the same whatever its size, and the pages of the arrays are only read from disk once touched.
+ *           Changes to the cells make private copies of the pages and never reach the file.
+ *           Sections that are not known are skipped.  On failure 'state' and 'grid' hold whatever was read so far and
+ *           must not be used.
+ *
+ * Input   : path  -- [in] name of the file
+ *           state -- [out] properties, plates and state of the simulation
+ *           grid  -- [out] the grid, its cell arrays attached to the file
+ *
+ * Returns : true if the file was read
+ *
+ * Written : Oct 2026 (gkhuber)
+ *           Oct 2026 (gkhuber) -- the file is mapped rather than read
+ *********************************************************************************************************************/
+bool worldFile::read(const std::string& path, worldState* state, hexGrid* grid)
+{
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  std::shared_ptr<mappedFile> file = std::make_shared<mappedFile>();
+  uint32_t             fileVersion = 0;
+  uint32_t             fileOrder = 0;
+  uint32_t             headerSize = 0;
+  uint16_t*            cellPlate = nullptr;
+  uint8_t*             cellStyle = nullptr;
+  float*               cellElevation = nullptr;
+  bool                 bGrid = false;
+  bool                 bEnd = false;
+
+  auto fail = [&path](const char* reason)
+  {
+    CLogger::getInstance()->outMsg(cmdLine, CLogger::level::ERR, "world file: %s %s", path.c_str(), reason);
+    return false;
+  };
+
+  if (!file->open(path)) return fail("cannot be opened");
+
+  uint8_t* data = file->data();
+  uint64_t size = file->size();
+
+  if ((size < alignment) || (memcmp(data, magic, sizeof(magic)) != 0)) return fail("is not a terrain file");
+
+  memcpy(&fileVersion, data + 8, sizeof(fileVersion));
+  memcpy(&fileOrder, data + 12, sizeof(fileOrder));
+  memcpy(&headerSize, data + 16, sizeof(headerSize));
+
+  if (fileOrder != byteOrder) return fail("was written on a machine of the other byte order");
+  if (fileVersion > version) return fail("was written by a newer version of terrainGen");
+  if ((headerSize < alignment) || (headerSize % alignment != 0)) return fail("has a damaged header");
+
+  *state = worldState();
+  grid->clear();
+
+  uint64_t offset = headerSize;
+
+  while (!bEnd)
+  {
+    uint32_t tag;
+    uint64_t len;
+
+    if (size - std::min(size, offset) < alignment) return fail("is cut short");
+
+    memcpy(&tag, data + offset, sizeof(tag));
+    memcpy(&len, data + offset + 8, sizeof(len));
+    offset += alignment;
+
+    if (size - offset < len) return fail("is cut short");
+
+    uint8_t*      payload = data + offset;
+    sectionReader section(payload, len);
+
+    if ((tag == tagCellPlate) || (tag == tagCellStyle) || (tag == tagCellElevation))
+    {
+      if (!bGrid) return fail("has cell arrays before the grid");
+
+      uint64_t cntCells = grid->getCount();
+
+      if (tag == tagCellPlate)
+      {
+        if (len != cntCells * sizeof(uint16_t)) return fail("has a cell array that does not match the grid");
+        cellPlate = reinterpret_cast<uint16_t*>(payload);
+      }
+      else if (tag == tagCellStyle)
+      {
+        if (len != cntCells * sizeof(uint8_t)) return fail("has a cell array that does not match the grid");
+        cellStyle = payload;
+      }
+      else
+      {
+        if (len != cntCells * sizeof(float)) return fail("has a cell array that does not match the grid");
+        cellElevation = reinterpret_cast<float*>(payload);
+      }
+    }
+    else if (tag == tagProps)
+    {
+      uint8_t cntHarmonics = 0;
+
+      section.get(&state->props.imageWidth);
+      section.get(&state->props.imageHeight);
+      section.get(&state->props.hexagonSize);
+      section.get(&state->props.hexagonOrient);
+      section.get(&state->props.hexagonProps);
+      section.get(&state->props.cntPlates);
+      section.get(&cntHarmonics);
+      for (uint8_t ndx = 0; ndx < cntHarmonics; ndx++)
+      {
+        float amplitude = 0;
+        if (section.get(&amplitude) && (ndx < nbrHarmonics)) state->props.amplitude[ndx] = amplitude;
+      }
+      for (uint8_t ndx = 0; ndx < cntHarmonics; ndx++)
+      {
+        float frequency = 0;
+        if (section.get(&frequency) && (ndx < nbrHarmonics)) state->props.frequency[ndx] = frequency;
+      }
+    }
+    else if (tag == tagGrid)
+    {
+      uint8_t  orient = 0;
+      double_t cellSize = 0;
+      uint32_t rows = 0;
+      uint32_t cols = 0;
+
+      if (!section.get(&orient) || !section.get(&cellSize) || !section.get(&rows) || !section.get(&cols)) return fail("has a damaged grid section");
+      if ((orient != hexGrid::orien::VERTICAL) && (orient != hexGrid::orien::HORIZONTAL)) return fail("has an unknown orientation");
+      if ((cellSize <= 0) || ((uint64_t)rows * cols >= noCell)) return fail("has a damaged grid section");
+
+      grid->setLayout(orient, cellSize, rows, cols);
+      bGrid = true;
+    }
+    else if (tag == tagPlates)
+    {
+      uint32_t cntPlates = 0;
+
+      section.get(&cntPlates);
+      if (cntPlates > section.left() / sizeof(uint32_t)) return fail("has a damaged plate section");
+
+      state->plates.resize(cntPlates);
+      for (uint32_t ndx = 0; ndx < cntPlates; ndx++)
+      {
+        platesT& plate = state->plates[ndx];
+        uint32_t recLen = 0;
+        uint32_t rgba = 0;
+        uint32_t cntBorder = 0;
+
+        if (!section.get(&recLen) || (recLen > section.left())) return fail("has a damaged plate section");
+
+        sectionReader record(payload + (len - section.left()), recLen);
+        section.skip(recLen);
+
+        record.get(&plate.ndx);
+        record.get(&plate.center_x);
+        record.get(&plate.center_y);
+        plate.color = (record.get(&rgba) && (rgba >> 24)) ? rgba : plateColor(ndx);      // older files left plates past the tenth transparent
+        record.get(&cntBorder);
+        if (cntBorder > record.left() / sizeof(uint32_t)) return fail("has a damaged plate section");
+
+        plate.vec.resize(cntBorder);
+        for (uint32_t& cellID : plate.vec) record.get(&cellID);
+      }
+    }
+    else if (tag == tagMotion)
+    {
+      uint32_t cntPlates = 0;
+
+      section.get(&cntPlates);
+      if (cntPlates > section.left() / (2 * sizeof(double_t))) return fail("has a damaged motion section");
+
+      state->speed.resize(cntPlates);
+      state->direction.resize(cntPlates);
+      for (double_t& speed : state->speed) section.get(&speed);
+      for (double_t& direction : state->direction) section.get(&direction);
+    }
+    else if (tag == tagSim)
+    {
+      section.get(&state->seed);
+      section.get(&state->phase);
+      section.get(&state->step);
+      section.get(&state->claimed);
+      section.get(&state->curTime);
+    }
+    else if (tag == tagRandom)
+    {
+      state->generator.assign(reinterpret_cast<const char*>(payload), len);
+    }
+    else if (tag == tagResidual)
+    {
+      uint32_t cntPlates = 0;
+
+      section.get(&cntPlates);
+      if (cntPlates > section.left() / (2 * sizeof(double_t))) return fail("has a damaged residual section");
+
+      state->residX.resize(cntPlates);
+      state->residY.resize(cntPlates);
+      for (double_t& resid : state->residX) section.get(&resid);
+      for (double_t& resid : state->residY) section.get(&resid);
+    }
+    else if (tag == tagEnd)
+    {
+      bEnd = true;
+    }                                                        // any other tag is a section added by a later version
+
+    offset += len + padding(len);
+  }
+
+  if (!bGrid) return fail("has no grid");
+  if ((nullptr == cellPlate) || (nullptr == cellStyle) || (nullptr == cellElevation)) return fail("has no cell arrays");
+
+  uint32_t rows;
+  uint32_t cols;
+  if (!hexGrid::dimensions(state->props.hexagonOrient, state->props.hexagonSize, state->props.imageWidth, state->props.imageHeight, &rows, &cols) ||
+      (rows != grid->getRows()) || (cols != grid->getCols()))
+    return fail("has a grid that does not match its image properties");
+
+  for (const platesT& plate : state->plates)
+    for (uint32_t cellID : plate.vec)
+      if (cellID >= grid->getCount()) return fail("has a plate border outside the grid");
+
+  grid->attachCells(cellPlate, cellStyle, cellElevation, file);
+
+  long long elapsed = (long long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+  CLogger::getInstance()->outMsg(cmdLine, CLogger::level::INFO, "world mapped from %s (version %u): %u cells, %d plates, %lld ms", path.c_str(), fileVersion,
+                                 grid->getCount(), (int)state->plates.size(), elapsed);
+  return true;
+}
@@ -0,0 +1,77 @@
+/**********************************************************************************************************************
+ * Class    : worldFile
+ *
+ * Abstract : Reads and writes a world (the image properties, the grid, the plates and the state of the simulation) as a
+ *            terrain file (*.ter).  The file is a 64 byte header followed by a list of sections:
+ *               header  -- magic "TERRAIN\x1a", format version, byte order mark (0x01020304 as written), header size
+ *               section -- a 64 byte section header (tag of four characters, reserved word, length of the payload in
+ *                          bytes), then the payload padded to a multiple of 64 bytes
+ *            Every section, and so every payload, starts on a 64 byte boundary, which keeps the cell arrays aligned in
+ *            the file.  The arrays are written in the byte order of the machine, a file is refused by a machine of the
+ *            other byte order.
+ *               PROP -- imageProps, field by field
+ *               GRID -- orientation, size, rows and columns of the grid
+ *               CPLT -- plate of every cell (uint16_t per cell)
+ *               CSTY -- style of every cell (uint8_t per cell)
+ *               CELV -- elevation of every cell (float per cell)
+ *               PLTS -- the plates: index, center, color and the cells of the border
+ *               MOTN -- speed and direction of every plate, once the motion vectors are generated
+ *               SIMS -- seed, phase, growth step, cells claimed and simulated time
+ *               RAND -- state of the random number generator, as text (the format of operator<< of std::mt19937)
+ *               RESD -- per plate, the displacement the plates have not been moved by yet (see plateMotion.h)
+ *               END  -- marks the end of the file, a file without it was cut short
+ *            Versions : a reader skips the sections it does not know, and reads the fields it knows from the front of
+ *            a section, ignoring anything after them.  Fields are only ever added at the end of a section, and a field
+ *            missing from an older file keeps its default value, so older files always load.  The version in the
+ *            header is only raised when a change cannot be read that way; a file with a newer version is refused.
+ *            Writing goes through a temporary file, so the file is only replaced by a complete one (see 'write').
+ *            Reading maps the file and uses the cell arrays where they lie in it, copy-on-write (see 'read').
+ *            With RAND and RESD a file holds the whole state of the simulation, so a run restarted from it gives the
+ *            same result, bit for bit, as a run that was never stopped.
+ *            Errors are logged and reported by returning false.
+ *
+ * History  : created Oct 2026 (gkhuber)
+ *            Oct 2026 (gkhuber) the file is mapped and the cell arrays are used in place
+ *            Oct 2026 (gkhuber) files are replaced atomically, writing reports progress and can be cancelled
+ *            Oct 2026 (gkhuber) state of the generator and of the plate motion (RAND, RESD)
+ *********************************************************************************************************************/
+
+#ifndef _worldFile_h_
+#define _worldFile_h_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <functional>
+
+#include "constants.h"
+
+class hexGrid;
+
+struct worldState
+{
+  imageProps              props = {};
+  std::vector<platesT>    plates;
+  std::vector<double_t>   speed;                // per plate, cm / year, empty until the motion vectors are generated
+  std::vector<double_t>   direction;            // per plate, degrees
+  uint32_t                seed = 0;
+  uint8_t                 phase = 0;            // simulation::phase reached
+  uint32_t                step = 0;             // growth step
+  uint64_t                claimed = 0;          // cells claimed by the plates
+  uint64_t                curTime = 0;          // simulated time in years
+  std::string             generator;            // state of the generator, empty if not known
+  std::vector<double_t>   residX;               // per plate, displacement not applied yet, empty before the motion
+  std::vector<double_t>   residY;
+};
+
+class worldFile
+{
+public:
+  static const uint32_t version = 1;
+
+  static bool write(const std::string& path, const worldState& state, const hexGrid& grid,
+                    const std::function<bool(uint64_t, uint64_t)>& progress = nullptr);
+  static bool read(const std::string& path, worldState* state, hexGrid* grid);
+};
+
+#endif
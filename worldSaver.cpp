@@ -0,0 +1,127 @@
+#include "worldSaver.h"
+#include "logger.h"
+
+
+worldSaver::worldSaver() : m_status(status::IDLE), m_bCancel(false), m_done(0), m_total(0)
+{
+  m_logger = CLogger::getInstance();
+
+}
+
+
+worldSaver::~worldSaver()
+{
+  if (m_thread.joinable()) m_thread.join();                 // the simulation, which calls 'write', is gone by now
+}
+
+
+/**********************************************************************************************************************
+ * Function: begin
+ *
+ * Abstract: Reserves the saver for a save to a file.  The save starts once the simulation hands over its state.
+ *
+ * Input   : path -- [in] name of the file
+ *
+ * Returns : true if the saver was free, false if a save is under way or its result has not been collected
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+bool worldSaver::begin(const std::string& path)
+{
+  if (m_status != status::IDLE) return false;
+
+  m_path = path;
+  m_done = 0;
+  m_total = 0;
+  m_bCancel = false;
+  m_status = status::SNAPSHOT;
+  return true;
+}
+
+
+void worldSaver::cancel()
+{
+  m_bCancel = true;
+}
+
+
+/**********************************************************************************************************************
+ * Function: finish
+ *
+ * Abstract: Collects the result of a save that is over, which frees the saver for the next save.  A save that is not
+ *           over is left alone.
+ *
+ * Input   : void
+ *
+ * Returns : the status of the save; SAVED, FAILED or CANCELLED once it is over
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+uint8_t worldSaver::finish()
+{
+  uint8_t result = m_status;
+
+  if (result >= status::SAVED)
+  {
+    std::lock_guard<std::mutex> guard(m_lock);
+    if (m_thread.joinable()) m_thread.join();
+    m_status = status::IDLE;
+  }
+
+  return result;
+}
+
+
+/**********************************************************************************************************************
+ * Function: write
+ *
+ * Abstract: Takes over the copy of the state made by the simulation and starts writing it on the saver's thread.
+ *
+ * Input   : state -- [in] properties, plates and state of the simulation
+ *           grid  -- [in] the grid, owning its cell arrays
+ *
+ * Returns : void
+ *
+ * Written : Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+void worldSaver::write(std::unique_ptr<worldState> state, std::unique_ptr<hexGrid> grid)
+{
+  std::lock_guard<std::mutex> guard(m_lock);
+
+  if (m_status != status::SNAPSHOT) return;                  // not reserved by 'begin'
+  if (m_bCancel)
+  {
+    m_status = status::CANCELLED;
+    return;
+  }
+
+  m_state = std::move(state);
+  m_grid = std::move(grid);
+  m_status = status::WRITING;
+  m_thread = std::thread(&worldSaver::run, this);
+}
+
+
+void worldSaver::abandon()
+{
+  if (m_status == status::SNAPSHOT) m_status = status::FAILED;
+}
+
+
+void worldSaver::run()
+{
+  CLogger::setThreadInstance(m_logger);
+
+  bool bRet = worldFile::write(m_path, *m_state, *m_grid, [this](uint64_t done, uint64_t total)
+    {
+      m_done = done;
+      m_total = total;
+      return !m_bCancel;
+    });
+
+  m_state.reset();
+  m_grid.reset();
+
+  std::lock_guard<std::mutex> guard(m_lock);                 // 'write' has finished starting the thread
+  m_status = bRet ? status::SAVED : (m_bCancel ? status::CANCELLED : status::FAILED);
+}
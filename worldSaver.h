@@ -0,0 +1,75 @@
+/**********************************************************************************************************************
+ * Class    : worldSaver
+ *
+ * Abstract : Saves a world to a terrain file on a thread of its own, so that neither the GUI nor the simulation waits
+ *            on the disk.  A save goes through these stages:
+ *               (1) the GUI reserves the saver for a file with 'begin' (which fails while another save is under way),
+ *                   and asks the simulation for a copy of its state (see simulation::saveAsync),
+ *               (2) the simulation copies its state between two steps and hands the copy over with 'write', which
+ *                   starts the thread.  Copying the state takes a few milliseconds, the simulation carries on at once,
+ *               (3) the thread writes the copy (see worldFile::write, which writes a temporary file and renames it over
+ *                   the file only once it is complete), reporting its progress through 'getDone' and 'getTotal',
+ *               (4) the GUI polls 'getStatus', and once the save is over collects the result with 'finish', which makes
+ *                   the saver ready for the next save.
+ *            'cancel' stops a save at any stage; the file being replaced is left as it was.  A save that is not cancelled
+ *            is finished by the destructor.
+ *
+ * History  : created Oct 2026 (gkhuber)
+ *********************************************************************************************************************/
+
+#ifndef _worldSaver_h_
+#define _worldSaver_h_
+
+#include <cstdint>
+#include <string>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+#include "worldFile.h"
+#include "hexGrid.h"
+
+class CLogger;
+
+class worldSaver
+{
+public:
+  enum status : std::uint8_t { IDLE = 0, SNAPSHOT = 1, WRITING = 2, SAVED = 3, FAILED = 4, CANCELLED = 5 };
+
+  worldSaver();
+  ~worldSaver();
+
+  // GUI thread
+  bool     begin(const std::string& path);
+  void     cancel();
+  uint8_t  finish();
+
+  // simulation thread
+  void     write(std::unique_ptr<worldState> state, std::unique_ptr<hexGrid> grid);
+  void     abandon();
+
+  uint8_t  getStatus() const { return m_status; }
+  uint64_t getDone() const { return m_done; }
+  uint64_t getTotal() const { return m_total; }
+  const std::string& getPath() const { return m_path; }       // set by 'begin', unchanged until 'finish'
+
+private:
+  std::string                  m_path;
+  std::unique_ptr<worldState>  m_state;                        // copy being written
+  std::unique_ptr<hexGrid>     m_grid;
+  std::thread                  m_thread;
+  CLogger*                     m_logger;                        // logger of the thread that created the saver
+  std::mutex                   m_lock;                          // guards m_thread
+  std::atomic<uint8_t>         m_status;
+  std::atomic<bool>            m_bCancel;
+  std::atomic<uint64_t>        m_done;                          // bytes of the cell arrays written
+  std::atomic<uint64_t>        m_total;
+
+  void     run();
+
+  worldSaver(const worldSaver&) = delete;
+  worldSaver& operator=(const worldSaver&) = delete;
+};
+
+#endif